@@ -79,6 +79,277 @@ typedef enum {
 	MM_RADIO_REGION_GROUP_JAPAN,		/**< Region Japan group */
 } MMRadioRegionType;
 
+/**
+ * Enumerations of radio specific messages.
+ * They are posted to MMMessageCallback together with the messages of MMMessageType.
+ * The values are out of the range of MMMessageType.
+ */
+typedef enum {
+	MM_MESSAGE_RADIO_SIGNAL = 0x1000,		/**< Signal strength is changed. code has new signal strength */
+	MM_MESSAGE_RADIO_SEEK_RESULT,			/**< Posted after MM_MESSAGE_RADIO_SEEK_FINISH. data points MMRadioSeekResult, which is valid only in the callback */
+	MM_MESSAGE_RADIO_TUNE_DONE,				/**< Frequency requested in coalescing tune mode is applied. radio_scan.frequency has the frequency applied */
+	MM_MESSAGE_RADIO_SCAN_RESULT,			/**< Posted after MM_MESSAGE_RADIO_SCAN_FINISH. data points MMRadioScanResult, which is valid only in the callback */
+	MM_MESSAGE_RADIO_STATIONS_CHANGED,		/**< Station database is changed by background refresh. code has number of stations of current region and device */
+	MM_MESSAGE_RADIO_SCAN_BATCH,			/**< Stations are found by scan in batch delivery. data points MMRadioScanBatch, which is valid only in the callback */
+	MM_MESSAGE_RADIO_SCAN_PROGRESS,			/**< Scan with time budget made progress. data points MMRadioScanProgress, which is valid only in the callback */
+} MMRadioMessageType;
+
+/**
+ * Enumerations of tune mode. It decides how mm_radio_set_frequency() is handled.
+ */
+typedef enum {
+	MM_RADIO_TUNE_MODE_SYNC = 0,		/**< Frequency is applied before mm_radio_set_frequency() returns */
+	MM_RADIO_TUNE_MODE_COALESCE,		/**< Frequency is applied by worker. only the latest one of requests in a row is applied */
+} MMRadioTuneMode;
+
+/**
+ * Station kept in station database.
+ */
+typedef struct {
+	int frequency;					/**< Frequency, KHz */
+	int rssi;						/**< Signal strength when it's seen last time. 0 ~ 65535 */
+	long long last_seen;			/**< When it's seen last time, seconds since the Epoch */
+	int pi;							/**< RDS program identification. -1 if unknown */
+	char ps[9];						/**< RDS program service name. empty if unknown */
+} MMRadioStation;
+
+/**
+ * Configuration of background station refresh.
+ */
+typedef struct {
+	const char *device;				/**< Device of secondary tuner. NULL if there's none, then tuner of the handle is used while it's idle */
+	int tuner_index;				/**< Index of secondary tuner */
+	int slice;						/**< Maximum time of a slice, msec. zero means default */
+	int interval;					/**< Interval between slices, msec. zero means default */
+} MMRadioRefreshConfig;
+
+#define MM_RADIO_MAX_SCAN_TUNERS	8	/**< Max number of additional tuners of parallel scan */
+
+/**
+ * Additional tuner used by parallel scan.
+ */
+typedef struct {
+	const char *device;				/**< Device node of the tuner. e.g. /dev/radio1 */
+	int tuner_index;				/**< Index of tuner in the device */
+} MMRadioScanTuner;
+
+/**
+ * Enumerations of seek engine. It decides who searches stations for seek and scan.
+ */
+typedef enum {
+	MM_RADIO_SEEK_ENGINE_AUTO = 0,		/**< Hardware seek if the tuner has it. otherwise, software seek */
+	MM_RADIO_SEEK_ENGINE_HARDWARE,		/**< VIDIOC_S_HW_FREQ_SEEK */
+	MM_RADIO_SEEK_ENGINE_SOFTWARE,		/**< Channel raster is stepped by VIDIOC_S_FREQUENCY, and signal is read by VIDIOC_G_TUNER */
+} MMRadioSeekEngine;
+
+/**
+ * Enumerations of seek profile. It trades seek speed against stops on noise.
+ */
+typedef enum {
+	MM_RADIO_SEEK_PROFILE_DEFAULT = 0,	/**< Thresholds of the tuner are not changed */
+	MM_RADIO_SEEK_PROFILE_FAST,			/**< Low RSSI threshold only. stops early, but can stop on noise */
+	MM_RADIO_SEEK_PROFILE_NORMAL,		/**< RSSI, SNR and impulse thresholds recommended by chip vendor */
+	MM_RADIO_SEEK_PROFILE_STRICT,		/**< Highest SNR and impulse thresholds. stops on good stations only */
+	MM_RADIO_SEEK_PROFILE_CUSTOM,		/**< Thresholds given by application */
+	MM_RADIO_SEEK_PROFILE_NUM,			/**< Number of seek profiles */
+} MMRadioSeekProfileType;
+
+/**
+ * Seek thresholds. Seek stops at the frequency which passes all of enabled ones.
+ */
+typedef struct {
+	int rssi;		/**< RSSI threshold, dBuV. 0 ~ 255 */
+	int snr;		/**< SNR threshold. 0 disables it. 1 gives most stops, 15 gives fewest stops */
+	int impulse;	/**< FM impulse detection threshold. 0 disables it. 1 gives most stops, 15 gives fewest stops */
+} MMRadioSeekThreshold;
+
+/**
+ * Result of seek.
+ */
+typedef struct {
+	int frequency;					/**< Frequency found, KHz */
+	MMRadioSeekProfileType profile;	/**< Seek profile used */
+	MMRadioSeekThreshold threshold;	/**< Thresholds of the profile. tuner's own ones instead if they are not applied and known */
+	int applied;					/**< Non-zero if the tuner is programmed with the thresholds */
+	int retries;					/**< Number of hardware seeks retried because the tuner was busy or timed out */
+	int elapsed;					/**< Time spent for the seek, msec */
+} MMRadioSeekResult;
+
+/**
+ * Result of scan.
+ */
+typedef struct {
+	int num_stations;				/**< Number of stations found */
+	int retries;					/**< Number of hardware seeks retried because the tuner was busy or timed out */
+	int elapsed;					/**< Time spent for the scan, msec */
+	int error;						/**< MM_ERROR_NONE if whole band is scanned. otherwise, error which stopped the scan */
+	int merged;						/**< Number of hits merged into a stronger station next to them, or dropped by dwell */
+	int out_of_budget;				/**< Non-zero if scan is finished because its time budget ran out */
+} MMRadioScanResult;
+
+/**
+ * Time budget and order of scan.
+ */
+typedef struct {
+	int budget;						/**< Time for the scan, msec. scan finishes with stations found so far when it runs out. zero means no limit */
+	int known_first;				/**< Non-zero to check stations of station database before scanning the band */
+} MMRadioScanBudget;
+
+/**
+ * Progress of scan with time budget.
+ */
+typedef struct {
+	int percent;					/**< Part of the scan done, 0 ~ 100. known stations and channels of the band are counted */
+	int remaining;					/**< Estimated time to finish, msec. it's not over the budget left. -1 until band scan makes progress */
+	int elapsed;					/**< Time spent so far, msec */
+	int num_stations;				/**< Number of stations found so far */
+} MMRadioScanProgress;
+
+/**
+ * Signal of a channel measured by band sweep.
+ */
+typedef struct {
+	int frequency;					/**< Frequency of the channel, KHz */
+	int rssi;						/**< Signal strength. same scale with mm_radio_get_signal_strength() */
+	int snr;						/**< Signal to noise ratio, dB. -1 if the tuner can't measure it */
+} MMRadioChannelSignal;
+
+/**
+ * Progress of band sweep. It's called from the thread calling mm_radio_sweep_band() after each channel.
+ *
+ * @warning	It's called while the handle is locked for the sweep. Calling any radio API of the same handle
+ *			from it, e.g. mm_radio_get_state(), deadlocks. Return zero to stop the sweep instead, and call the API
+ *			after mm_radio_sweep_band() returns.
+ *
+ * @param	channels_done	[in]	number of channels measured so far.
+ * @param	num_channels	[in]	number of channels of the band.
+ * @param	user_param		[in]	user parameter of mm_radio_sweep_band().
+ *
+ * @return	zero to cancel the sweep, non-zero to go on.
+ */
+typedef int (*MMRadioSweepCallback)(int channels_done, int num_channels, void *user_param);
+
+#define MM_RADIO_SCAN_BATCH_AT_END	(-1)	/**< Batch size to deliver stations once when scan is over */
+
+/**
+ * Stations found by scan. Stations are in order of frequency, and ones delivered before are kept at the same place.
+ * If known stations are checked first, they come before the others.
+ */
+typedef struct {
+	const MMRadioStation *stations;	/**< Contiguous array of all stations found so far. valid until next scan starts or the handle is destroyed */
+	int num_stations;				/**< Number of stations in the array */
+	int first_new;					/**< Index of the first station which is not delivered before */
+	int finished;					/**< Non-zero if scan is over and no more station is added */
+} MMRadioScanBatch;
+
+/**
+ * Enumerations of signal quality.
+ */
+typedef enum {
+	MM_RADIO_QUALITY_RSSI,			/**< Received signal strength. same scale with mm_radio_get_signal_strength() */
+	MM_RADIO_QUALITY_SNR,			/**< Signal to noise ratio, dB */
+	MM_RADIO_QUALITY_MULTIPATH,		/**< Multipath, percent */
+	MM_RADIO_QUALITY_NUM,			/**< Number of signal quality types */
+} MMRadioQualityType;
+
+/**
+ * Statistics of signal quality over a time window.
+ * Percentiles are resolved to 1/256 of the range of RSSI, and to 1 for the others.
+ */
+typedef struct {
+	int num_samples;	/**< Number of samples in the window. zero means the quality isn't measured */
+	int min;			/**< Minimum */
+	int max;			/**< Maximum */
+	int mean;			/**< Mean */
+	int p10;			/**< 10th percentile */
+	int p50;			/**< Median */
+	int p90;			/**< 90th percentile */
+} MMRadioQualityStats;
+
+/**
+ * Fields of tuner status. A field of MMRadioTunerStatus is valid only if its flag is set.
+ */
+typedef enum {
+	MM_RADIO_STATUS_FREQUENCY = (1 << 0),	/**< frequency is valid */
+	MM_RADIO_STATUS_SIGNAL = (1 << 1),		/**< signal is valid */
+	MM_RADIO_STATUS_SNR = (1 << 2),			/**< snr is valid */
+	MM_RADIO_STATUS_STEREO = (1 << 3),		/**< stereo is valid */
+	MM_RADIO_STATUS_RDS_READY = (1 << 4),	/**< rds_ready is valid */
+	MM_RADIO_STATUS_AFC_RAIL = (1 << 5),	/**< afc_rail is valid */
+} MMRadioTunerStatusField;
+
+/**
+ * Snapshot of tuner status. Every field is read at the same moment.
+ */
+typedef struct {
+	unsigned int valid;	/**< Valid fields. OR of MMRadioTunerStatusField */
+	int frequency;		/**< Tuned frequency, KHz */
+	int signal;			/**< Signal strength. same scale with mm_radio_get_signal_strength() */
+	int snr;			/**< Signal to noise ratio, dB */
+	int stereo;			/**< Non-zero if stereo is received */
+	int rds_ready;		/**< Non-zero if new RDS group is ready */
+	int afc_rail;		/**< Non-zero if AFC is railed. the station is not exactly on the frequency */
+} MMRadioTunerStatus;
+
+#define MM_RADIO_STATS_BUCKETS	96	/**< Number of buckets of latency histogram */
+
+/**
+ * Latency statistics of a call to driver, GStreamer or ASM.
+ * Histogram is log-linear. Bucket 0 ~ 3 are 0 ~ 3 usec. Above them, each power of 2 is divided into 4 buckets.
+ * Lower bound of bucket b (b >= 4) is (4 + b % 4) << (b / 4 - 1) usec. The last bucket has all the longer ones.
+ */
+typedef struct {
+	char name[32];			/**< Name of the call. e.g. VIDIOC_S_FREQUENCY, gst_element_set_state */
+	unsigned int count;		/**< Number of calls */
+	unsigned int errors;	/**< Number of failed calls */
+	unsigned long long total_usec;	/**< Sum of latency, usec */
+	unsigned int max_usec;	/**< Max latency, usec */
+	unsigned int p50_usec;	/**< Median latency, lower bound of the bucket */
+	unsigned int p99_usec;	/**< 99th percentile latency, lower bound of the bucket */
+	unsigned int ioctls;	/**< Number of ioctls issued by the calls. only for apply_settings, which batches them. zero for the others */
+	unsigned int histogram[MM_RADIO_STATS_BUCKETS];	/**< Number of calls per latency bucket */
+} MMRadioStatsEntry;
+
+#define MM_RADIO_DEVICE_PATH_MAX	64	/**< Max length of radio device path including null */
+
+/**
+ * Information of radio device.
+ */
+typedef struct {
+	char path[MM_RADIO_DEVICE_PATH_MAX];	/**< Device node. e.g. /dev/radio0 */
+	char driver[16];				/**< Name of the driver */
+	char card[32];				/**< Name of the device */
+	unsigned int capabilities;		/**< V4L2 capabilities of the device */
+	int num_tuners;				/**< Number of tuners. index of tuner is from 0 to num_tuners - 1 */
+} MMRadioDeviceInfo;
+
+/**
+ * Station of simulated tuner.
+ */
+typedef struct {
+	int frequency;		/**< Frequency of the station, KHz */
+	int signal;			/**< Signal strength at the exact frequency. same scale with mm_radio_get_signal_strength() */
+} MMRadioSimStation;
+
+/**
+ * Configuration of simulated tuner.
+ * Signal strength of a frequency is the strongest one among the stations,
+ * decreased by rolloff for each 100KHz of detuning and never lower than noise_floor.
+ * Everything is deterministic. Same configuration gives same result always.
+ */
+typedef struct {
+	const MMRadioSimStation* stations;	/**< Station map. copied when it's applied */
+	int num_stations;				/**< Number of stations */
+	int noise_floor;				/**< Signal strength where no station is */
+	int rolloff;					/**< Signal strength lost per 100KHz of detuning */
+	int seek_threshold;			/**< Hardware seek stops at the frequency which is stronger than this */
+	int step;					/**< Raster step of hardware seek, KHz. 100KHz if zero */
+	int latency;					/**< Latency of each tuner operation, micro seconds */
+	int seek_step_latency;		/**< Latency of each raster step while hardware seek, micro seconds */
+	int seek_failures;			/**< Number of hardware seeks failing with EAGAIN before each successful one */
+	int no_hw_seek;				/**< Non-zero if the tuner has no hardware seek */
+} MMRadioSimConfig;
+
 /**
  * This function creates a radio handle. \n
  * So, application can make radio instance and initializes it. 
@@ -739,6 +1010,25 @@ int main(int argc, char **argv)
  */
 int mm_radio_realize(MMHandleType hradio);
 
+/**
+ * This function opens radio device and ready to tune like mm_radio_realize(), but it returns immediately.
+ * Opening device, programming tuner and building pipeline are done on internal thread.
+ * MM_MESSAGE_STATE_CHANGED is posted when it becomes MM_RADIO_STATE_READY.
+ * If it fails, MM_MESSAGE_ERROR is posted with the error code and the state stays MM_RADIO_STATE_NULL.
+ *
+ * @param	hradio		[in]	Handle of radio.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_NULL
+ * @post 	MM_RADIO_STATE_READY (after MM_MESSAGE_STATE_CHANGED)
+ * @remark	mm_radio_unrealize() or mm_radio_destroy() cancels realizing in progress.
+ *			mm_radio_realize() fails with MM_ERROR_RADIO_INVALID_STATE until it's done.
+ *			Other APIs called while realizing wait until it's done.
+ *			Messages are posted from internal thread. Don't call mm_radio_destroy() in the callback for them.
+ * @see		mm_radio_realize mm_radio_unrealize
+ */
+int mm_radio_realize_async(MMHandleType hradio);
+
 /**
  * This function mutes tuner and closes the radio device.
  * And, application can destroy radio directly without this API. 
@@ -3442,6 +3732,589 @@ int mm_radio_get_region_type(MMHandleType hradio, MMRadioRegionType *type);
  */
 int mm_radio_get_region_frequency_range(MMHandleType hradio, unsigned int *min, unsigned int *max);
 
+/**
+ * This function is to get channel spacing of radio region.
+ * Legal frequencies of the region are min + n * spacing.
+ * Frequency out of the raster is tuned to the nearest legal one. Seek and scan visit only legal ones.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	spacing		[out]		channel spacing
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_READY, MM_RADIO_STATE_PLAYING or MM_RADIO_STATE_SCANNING
+ * @post 	None
+ * @remark	 The unit of spacing is KHz. Range of region can be narrowed to the range tuner supports.
+ * @see mm_radio_get_region_frequency_range()
+ */
+int mm_radio_get_channel_spacing(MMHandleType hradio, int *spacing);
+
+/**
+ * This function gets the list of radio devices in the system.
+ * Every /dev/radio* node which has a tuner is listed in the order of its name.
+ *
+ * @param	devices		[out]		array to be filled with device information. it can be NULL to get the number only.
+ * @param	max_devices	[in]		number of elements of devices.
+ * @param	num_devices	[out]		number of radio devices found. it can be bigger than max_devices.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	It doesn't need radio handle. Devices used by other handles are listed also.
+ * @see mm_radio_set_device()
+ */
+int mm_radio_get_device_list(MMRadioDeviceInfo *devices, int max_devices, int *num_devices);
+
+/**
+ * This function binds radio handle to the radio device and the tuner of it.
+ * Each handle has its own device, tuner and lock. So, handles bound to different tuners can run at once.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	device		[in]		path of radio device. NULL means default device(/dev/radio0).
+ * @param	tuner_index	[in]		index of tuner in the device.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_NULL
+ * @post 	None
+ * @remark	The tuner is checked when it's realized. mm_radio_realize() fails if it's not available.
+ * @see mm_radio_get_device_list() mm_radio_realize()
+ */
+int mm_radio_set_device(MMHandleType hradio, const char *device, int tuner_index);
+
+/**
+ * This function enables keeping radio device and pipeline after unrealizing.
+ * When it's enabled, mm_radio_unrealize() changes state to MM_RADIO_STATE_NULL but keeps device opened
+ * and pipeline stopped for grace period. mm_radio_realize() within the period reuses them and completes quickly.
+ * They are released when the period is expired, and when mm_radio_destroy() is called.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	grace		[in]		grace period, msec. zero disables it and releases kept device right now.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	It's disabled by default. Other application can't open the device while it's kept.
+ * @see mm_radio_realize() mm_radio_unrealize()
+ */
+int mm_radio_set_keep_warm(MMHandleType hradio, int grace);
+
+/**
+ * This function replaces the radio device with in-process simulated tuner.
+ * It's useful to measure or test radio without real radio hardware.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	config		[in]		configuration of simulated tuner. NULL means going back to the radio device.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_NULL
+ * @post 	None
+ * @remark	The station map of config is copied. Application can release it after calling.
+ * @see mm_radio_realize()
+ */
+int mm_radio_set_simulation(MMHandleType hradio, const MMRadioSimConfig *config);
+
+/**
+ * This function is to get frequency with bounded staleness.
+ * Frequency is kept in the handle whenever it's set or read by seek, scan and the other APIs.
+ * Device is accessed only when the kept one is older than max_age.
+ * It doesn't wait for other command like seek to get fresh value unless max_age is zero.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	max_age		[in]		acceptable age of frequency, msec.
+ *								zero means reading from device always. negative value means default(200 msec).
+ * @param	pFreq		[out]		frequency
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	The unit of frequency is KHz. mm_radio_get_frequency() works same with default max_age.
+ * @see mm_radio_get_frequency()
+ */
+int mm_radio_get_cached_frequency(MMHandleType hradio, int max_age, int *pFreq);
+
+/**
+ * This function is to get strength of radio signal with bounded staleness.
+ * Signal strength is kept in the handle whenever it's read.
+ * Device is accessed only when the kept one is older than max_age.
+ * It doesn't wait for other command like seek to get fresh value unless max_age is zero.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	max_age		[in]		acceptable age of signal strength, msec.
+ *								zero means reading from device always. negative value means default(200 msec).
+ * @param	value		[out]		signal strength
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_READY, MM_RADIO_STATE_PLAYING or MM_RADIO_STATE_SCANNING
+ * @post 	None
+ * @remark	mm_radio_get_signal_strength() works same with default max_age.
+ * @see mm_radio_get_signal_strength()
+ */
+int mm_radio_get_cached_signal_strength(MMHandleType hradio, int max_age, int *value);
+
+/**
+ * This function starts to monitor signal strength.
+ * MM_MESSAGE_RADIO_SIGNAL is posted with the first signal strength,
+ * and then it's posted only when signal strength changes by hysteresis or more.
+ * Signal is sampled internally, and sampling gets slower while signal is stable.
+ * If the driver sends control events of the RF tuner and they follow signal changes, signal is read on the event instead.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	hysteresis	[in]		minimum change of signal strength to be notified. zero means default(2048).
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_READY, MM_RADIO_STATE_PLAYING or MM_RADIO_STATE_SCANNING
+ * @post 	None
+ * @remark	Monitoring is stopped by mm_radio_unrealize() also.
+ *			Message is posted from internal thread. Don't call radio API in the callback for MM_MESSAGE_RADIO_SIGNAL.
+ * @see mm_radio_stop_signal_monitor()
+ */
+int mm_radio_start_signal_monitor(MMHandleType hradio, int hysteresis);
+
+/**
+ * This function stops to monitor signal strength.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	None
+ * @see mm_radio_start_signal_monitor()
+ */
+int mm_radio_stop_signal_monitor(MMHandleType hradio);
+
+/**
+ * This function starts to sample signal quality into the history of the handle.
+ * RSSI is sampled always. SNR and multipath are sampled if the tuner reports them.
+ * Sampling runs on internal thread without command lock. So, it never delays other APIs.
+ * History keeps the latest 1024 samples, and it's cleared when sampling starts.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	interval	[in]		sampling interval, msec. zero means default(100 msec).
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_READY, MM_RADIO_STATE_PLAYING or MM_RADIO_STATE_SCANNING
+ * @post 	None
+ * @remark	Sampling is stopped by mm_radio_unrealize() also. History is kept until next start.
+ * @see mm_radio_stop_quality_sampling() mm_radio_get_quality_stats()
+ */
+int mm_radio_start_quality_sampling(MMHandleType hradio, int interval);
+
+/**
+ * This function stops to sample signal quality.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	None
+ * @see mm_radio_start_quality_sampling()
+ */
+int mm_radio_stop_quality_sampling(MMHandleType hradio);
+
+/**
+ * This function gets statistics of signal quality over the latest time window.
+ * It's computed from the history in place. History itself is not copied.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	type		[in]		type of signal quality.
+ * @param	window		[in]		time window, msec. zero means whole history.
+ * @param	stats		[out]		statistics.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	It doesn't take command lock. It can be called from any thread while sampling.
+ * @see mm_radio_start_quality_sampling()
+ */
+int mm_radio_get_quality_stats(MMHandleType hradio, MMRadioQualityType type, int window, MMRadioQualityStats *stats);
+
+/**
+ * This function gets status of tuner as one snapshot.
+ * On tuners which expose their status registers, e.g. si470x, the status registers are read back to back,
+ * one register per request.
+ * On the others, frequency, signal strength and stereo are read by generic V4L2 requests.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	status		[out]		tuner status. check valid for the fields available.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_READY, MM_RADIO_STATE_PLAYING or MM_RADIO_STATE_SCANNING
+ * @post 	None
+ * @remark	Frequency and signal strength of the snapshot also refresh the values of
+ *			mm_radio_get_frequency() and mm_radio_get_signal_strength().
+ * @see mm_radio_get_signal_strength()
+ */
+int mm_radio_get_tuner_status(MMHandleType hradio, MMRadioTunerStatus *status);
+
+/**
+ * This function sets seek profile. It's applied to the tuner at next seek or scan.
+ * Profile and thresholds used are given by MM_MESSAGE_RADIO_SEEK_RESULT after each seek.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	profile		[in]		seek profile.
+ * @param	threshold	[in]		thresholds. it's used only for MM_RADIO_SEEK_PROFILE_CUSTOM.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	Tuners which can't take thresholds, e.g. generic V4L2 tuner, seek with their own ones.
+ *			MM_RADIO_SEEK_PROFILE_DEFAULT doesn't restore thresholds already programmed until the device is opened again.
+ * @see mm_radio_get_seek_profile() mm_radio_seek() mm_radio_scan_start()
+ */
+int mm_radio_set_seek_profile(MMHandleType hradio, MMRadioSeekProfileType profile, const MMRadioSeekThreshold *threshold);
+
+/**
+ * This function gets seek profile and its thresholds.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	profile		[out]		seek profile.
+ * @param	threshold	[out]		thresholds of the profile. can be NULL.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	None
+ * @see mm_radio_set_seek_profile()
+ */
+int mm_radio_get_seek_profile(MMHandleType hradio, MMRadioSeekProfileType *profile, MMRadioSeekThreshold *threshold);
+
+/**
+ * This function sets tune mode.
+ * In MM_RADIO_TUNE_MODE_COALESCE, mm_radio_set_frequency() just puts the frequency into a single-slot mailbox
+ * and returns without waiting for the tuner. A worker applies the latest one in the mailbox, and posts
+ * MM_MESSAGE_RADIO_TUNE_DONE with the frequency actually applied. Requests coming while the tuner is busy replace
+ * each other. A request same with the current frequency or the pending one is ignored.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	mode		[in]		tune mode.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	It's MM_RADIO_TUNE_MODE_SYNC by default. Failure of tuning in coalescing mode is posted as MM_MESSAGE_ERROR.
+ *			When it's back to MM_RADIO_TUNE_MODE_SYNC, the pending request is applied before this function returns.
+ * @see mm_radio_set_frequency()
+ */
+int mm_radio_set_tune_mode(MMHandleType hradio, MMRadioTuneMode mode);
+
+/**
+ * This function sets seek engine used by mm_radio_seek() and mm_radio_scan_start().
+ * Software seek samples signal of every few channels first, and then every channel around the ones
+ * having signal. It stops at the strongest channel of them if its signal is above threshold of seek profile.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	engine		[in]		seek engine.
+ * @param	settle_time	[in]		time to wait for signal after tuning to each channel in software seek, msec.
+ *									zero or negative means default.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	It's MM_RADIO_SEEK_ENGINE_AUTO by default. It chooses software seek if the tuner doesn't report
+ *			V4L2_CAP_HW_FREQ_SEEK, or hardware seek is refused. Software seek measures signal strength only.
+ *			SNR and impulse thresholds raise its signal threshold instead, so stricter profiles find fewer stations.
+ * @see mm_radio_get_seek_engine() mm_radio_set_seek_profile()
+ */
+int mm_radio_set_seek_engine(MMHandleType hradio, MMRadioSeekEngine engine, int settle_time);
+
+/**
+ * This function gets seek engine.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	engine		[out]		seek engine. if it's MM_RADIO_SEEK_ENGINE_AUTO and radio is realized,
+ *									the one chosen for the tuner is given.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	None
+ * @see mm_radio_set_seek_engine()
+ */
+int mm_radio_get_seek_engine(MMHandleType hradio, MMRadioSeekEngine *engine);
+
+/**
+ * This function opens station database. Stations found by scan are merged into it.
+ * It keeps stations per region and device, so it can be shared by handles and processes.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	path		[in]		database file. it's created if it doesn't exist. NULL closes database.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	File of unknown version is cleared. Stations can be read right after mm_radio_create() without scan.
+ * @see mm_radio_get_stations() mm_radio_invalidate_stations() mm_radio_merge_stations()
+ */
+int mm_radio_set_station_db(MMHandleType hradio, const char *path);
+
+/**
+ * This function gets stations of current region and device from station database, in order of frequency.
+ *
+ * @param	hradio			[in]		Handle of radio.
+ * @param	stations		[out]		array to be filled. can be NULL if max_stations is zero.
+ * @param	max_stations	[in]		number of elements of stations.
+ * @param	num_stations	[out]		number of stations in database. it can be bigger than max_stations.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		Station database is opened.
+ * @post 	None
+ * @remark	If there are more than max_stations, stations of the lowest frequencies are filled.
+ * @see mm_radio_set_station_db()
+ */
+int mm_radio_get_stations(MMHandleType hradio, MMRadioStation *stations, int max_stations, int *num_stations);
+
+/**
+ * This function removes stations of current region and device from station database.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	frequency	[in]		frequency of station to be removed, KHz. zero removes all of them.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		Station database is opened.
+ * @post 	None
+ * @remark	None
+ * @see mm_radio_set_station_db()
+ */
+int mm_radio_invalidate_stations(MMHandleType hradio, int frequency);
+
+/**
+ * This function merges stations into station database of current region and device.
+ * Station of same frequency is updated. Others are added.
+ *
+ * @param	hradio			[in]		Handle of radio.
+ * @param	stations		[in]		stations. last_seen of zero means now. unknown RDS doesn't replace known one.
+ * @param	num_stations	[in]		number of stations.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		Station database is opened.
+ * @post 	None
+ * @remark	None
+ * @see mm_radio_set_station_db()
+ */
+int mm_radio_merge_stations(MMHandleType hradio, const MMRadioStation *stations, int num_stations);
+
+/**
+ * This function starts refreshing station database in background.
+ * Each slice revisits one of known stations, and then samples channels between them until the slice is over.
+ * New station is added, and station missed twice in a row is removed.
+ * MM_MESSAGE_RADIO_STATIONS_CHANGED is posted when stations are added or removed.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	config		[in]		configuration. NULL means defaults without secondary tuner.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		Station database is opened.
+ * @post 	None
+ * @remark	Without secondary tuner, slices run only while the tuner of the handle is idle. It's idle if radio is
+ *			not started, or muted, or application tells so by mm_radio_set_refresh_idle(). Slice never waits for
+ *			other commands. it's skipped if the handle is busy. But other commands called during the slice wait
+ *			until it's over and the tuner is tuned back, up to the slice time and settle time of one channel.
+ *			Signal threshold and settle time are the ones of software seek.
+ * @see mm_radio_stop_station_refresh() mm_radio_set_refresh_idle() mm_radio_set_station_db()
+ */
+int mm_radio_start_station_refresh(MMHandleType hradio, const MMRadioRefreshConfig *config);
+
+/**
+ * This function stops refreshing station database.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	None
+ * @see mm_radio_start_station_refresh()
+ */
+int mm_radio_stop_station_refresh(MMHandleType hradio);
+
+/**
+ * This function tells whether short breaks of audio are acceptable, e.g. while screen is off.
+ * Background refresh without secondary tuner uses the tuner of the handle while it's idle.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	idle		[in]		non-zero if tuner can be borrowed.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	Tuner is tuned back to the frequency after each slice.
+ * @see mm_radio_start_station_refresh()
+ */
+int mm_radio_set_refresh_idle(MMHandleType hradio, int idle);
+
+/**
+ * This function sets additional tuners of scan. Band is divided into as many ranges as tuners, and each tuner
+ * including the one of the handle scans its own range at the same time.
+ * MM_MESSAGE_RADIO_SCAN_INFO is still posted in order of frequency, and a station seen by two tuners at the
+ * boundary of ranges is posted once.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	tuners		[in]		additional tuners. it can be NULL if num_tuners is zero.
+ * @param	num_tuners	[in]		number of additional tuners, up to MM_RADIO_MAX_SCAN_TUNERS. zero means scan by the tuner of the handle only.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_NULL or MM_RADIO_STATE_READY.
+ * @post 	None
+ * @remark	Tuners are opened when scan starts, and closed when it's over. Scan by the tuner of the handle only
+ *			is used if none of them can be opened, or if software seek is used. Additional tuners should be
+ *			of the same backend, and they shouldn't be used by other handles while scanning.
+ * @see mm_radio_scan_start()
+ */
+int mm_radio_set_scan_tuners(MMHandleType hradio, const MMRadioScanTuner *tuners, int num_tuners);
+
+/**
+ * This function sets how stations found by scan are delivered.
+ * In batch delivery, stations are added to an array of the handle, and MM_MESSAGE_RADIO_SCAN_BATCH is posted
+ * by another thread every batch_size stations and once more when scan is over. Scan doesn't wait for the callback.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	batch_size	[in]		number of stations of a batch. MM_RADIO_SCAN_BATCH_AT_END means once at the end.
+ *									zero means MM_MESSAGE_RADIO_SCAN_INFO for each station. it's default.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_NULL or MM_RADIO_STATE_READY.
+ * @post 	None
+ * @remark	MM_MESSAGE_RADIO_SCAN_INFO is not posted in batch delivery. A batch can be bigger than batch_size if the
+ *			callback takes longer than finding stations. Last batch is posted before MM_MESSAGE_RADIO_SCAN_FINISH.
+ *			Nothing is posted after mm_radio_scan_stop(). API of the handle, e.g. mm_radio_scan_stop(), can be called
+ *			from the callback of MM_MESSAGE_RADIO_SCAN_BATCH. It doesn't wait for the scan then, and
+ *			MM_MESSAGE_RADIO_SCAN_STOP is posted after the callback returns.
+ * @see mm_radio_get_scan_results()
+ */
+int mm_radio_set_scan_batch(MMHandleType hradio, int batch_size);
+
+/**
+ * This function gets stations found by the last scan, or the one running now. Nothing is copied.
+ * rssi of a station is the signal when it's found, and last_seen is when it's found.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	results		[out]		stations. first_new is zero.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	The array is kept until next scan starts or the handle is destroyed. Stations in it are never changed,
+ *			and only num_stations grows while scan is running.
+ * @see mm_radio_set_scan_batch()
+ */
+int mm_radio_get_scan_results(MMHandleType hradio, MMRadioScanBatch *results);
+
+/**
+ * This function sets how hits of scan close to each other are merged into one station.
+ * Seek often stops again at the channels right next to a strong station. A hit within window of the strongest one
+ * found so far joins its group, and only the strongest one of a group is added when a hit out of window is found.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	window		[in]		KHz. zero means every hit is a station. it's default.
+ * @param	dwell		[in]		msec. if non-zero, tuner stays on the strongest one of a group for dwell before
+ *									it's added, and it's dropped if signal is below seek threshold then.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_NULL or MM_RADIO_STATE_READY.
+ * @post 	None
+ * @remark	A station is added when a hit out of its window is found, or when scan is over. So, it's posted later than
+ *			without merging. Dwell is not applied in scan by multiple tuners since every tuner is seeking.
+ *			Number of merged hits is in MMRadioScanResult.
+ * @see mm_radio_scan_start() mm_radio_set_seek_threshold()
+ */
+int mm_radio_set_scan_dedup(MMHandleType hradio, int window, int dwell);
+
+/**
+ * This function starts scan which finishes in time budget. It's same as mm_radio_scan_start() except the followings.
+ * Stations of station database can be checked first, since they're likely to be on air. Each of them is tuned and
+ * kept if its signal is over seek threshold. And then, the band is scanned and known ones are not added again.
+ * MM_MESSAGE_RADIO_SCAN_PROGRESS is posted whenever a known station is checked or a station is found.
+ * Remaining time is estimated by time per channel measured by the band scan so far.
+ * When the budget runs out, scan is aborted and it finishes as usual with stations found so far.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	budget		[in]		time budget and order of scan.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_READY
+ * @post 	MM_RADIO_STATE_SCANNING
+ * @remark	out_of_budget of MMRadioScanResult tells if it's finished by the budget. Budget applies to this scan only.
+ *			Known stations are checked only if station database is set.
+ * @see mm_radio_scan_start() mm_radio_set_station_db() mm_radio_scan_stop()
+ */
+int mm_radio_scan_start_budget(MMHandleType hradio, const MMRadioScanBudget *budget);
+
+/**
+ * This function starts scan which continues the last one stopped before the end of band.
+ * Scan stopped by mm_radio_scan_stop(), by ASM, or by its time budget keeps a checkpoint, which is the highest station
+ * found by scanning the band. Resumed scan keeps stations found so far, and scans the band above the checkpoint.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		MM_RADIO_STATE_READY
+ * @post 	MM_RADIO_STATE_SCANNING
+ * @remark	It's same as mm_radio_scan_start() if last scan is over, if region is changed, or if no scan is done yet.
+ *			MM_MESSAGE_RADIO_SCAN_INFO is posted for new stations only. In batch delivery, stations not delivered
+ *			before the stop come with the first batch. Stations are counted from the start in MMRadioScanResult.
+ * @see mm_radio_scan_start() mm_radio_scan_stop() mm_radio_get_scan_results()
+ */
+int mm_radio_scan_resume(MMHandleType hradio);
+
+/**
+ * This function measures signal of every channel of the band, from band_min to band_max at channel spacing of the region.
+ * Tuner is tuned to each channel, and signal is read after the settle time of software seek.
+ * Channels are filled in order of frequency.
+ *
+ * @param	hradio			[in]		Handle of radio.
+ * @param	channels		[out]		array to be filled. it can be NULL to get the number of channels only.
+ * @param	max_channels	[in]		number of elements of channels.
+ * @param	num_channels	[out]		number of channels filled, or number of channels of the band if channels is NULL.
+ * @param	callback		[in]		progress callback. it can be NULL.
+ * @param	user_param		[in]		user parameter of callback.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ *			MM_ERROR_RADIO_NO_FREE_SPACE if max_channels is less than number of channels of the band.
+ *			MM_ERROR_POLICY_INTERRUPTED if sound policy stops radio during the sweep. num_channels has the
+ *			channels measured before it.
+ * @pre		MM_RADIO_STATE_READY
+ * @post 	Tuner is tuned back to the frequency of the handle.
+ * @remark	It returns when the sweep is over. If callback returns zero, sweep stops and num_channels has the
+ *			channels measured so far. Callback is called with the handle locked. see MMRadioSweepCallback.
+ * @see mm_radio_set_seek_engine() mm_radio_get_region_frequency_range()
+ */
+int mm_radio_sweep_band(MMHandleType hradio, MMRadioChannelSignal *channels, int max_channels, int *num_channels,
+						MMRadioSweepCallback callback, void *user_param);
+
+/**
+ * This function enables latency statistics of the calls to driver, GStreamer and ASM.
+ * Every tuner request, gst_element_set_state(), gst_element_get_state() and ASM state change is timed.
+ * Applying settings of realize, region change and mute is timed also as apply_settings, with the ioctls it issues.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	enable		[in]		non-zero to enable. zero to disable.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	It's disabled by default. Collected statistics are kept when it's disabled.
+ * @see mm_radio_get_stats()
+ */
+int mm_radio_enable_stats(MMHandleType hradio, int enable);
+
+/**
+ * This function gets latency statistics. Only the calls made at least once are given.
+ *
+ * @param	hradio		[in]		Handle of radio.
+ * @param	entries		[out]		array to be filled.
+ * @param	max_entries	[in]		number of elements of entries.
+ * @param	num_entries	[out]		number of entries filled.
+ * @param	reset		[in]		non-zero to clear statistics after reading.
+ *
+ * @return	This function returns zero on success, or negative value with errors
+ * @pre		None
+ * @post 	None
+ * @remark	It doesn't take command lock. Calls running at the moment can be counted in next one.
+ * @see mm_radio_enable_stats()
+ */
+int mm_radio_get_stats(MMHandleType hradio, MMRadioStatsEntry *entries, int max_entries, int *num_entries, int reset);
+
 /**
 	@}
  */
@@ -0,0 +1,113 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef MM_RADIO_BACKEND_H_
+#define MM_RADIO_BACKEND_H_
+
+#include <linux/videodev2.h>
+#include <pthread.h>
+
+#include "mm_radio.h"
+
+/* V4L2_CID_TUNE_DEEMPHASIS. not every kernel header has it */
+#define MMRADIO_CID_TUNE_DEEMPHASIS		((0x009d0000 | 0x900) +1)
+
+/* signal quality. only the fields in valid are measured */
+#define MMRADIO_QUALITY_VALID_RSSI			(1 << MM_RADIO_QUALITY_RSSI)
+#define MMRADIO_QUALITY_VALID_SNR			(1 << MM_RADIO_QUALITY_SNR)
+#define MMRADIO_QUALITY_VALID_MULTIPATH	(1 << MM_RADIO_QUALITY_MULTIPATH)
+
+typedef struct {
+	unsigned int valid;
+	int value[MM_RADIO_QUALITY_NUM];	/* indexed by MMRadioQualityType */
+} MMRadioQuality_t;
+
+/* tuner backend operations.
+ * every operation except create/destroy behaves like ioctl().
+ * it returns zero on success, or -1 with errno set on failure.
+ * ENOTTY means the backend doesn't support the operation.
+ */
+typedef struct {
+	const char* name;
+
+	/* backend private data. config is backend specific and can be NULL */
+	void* (*create)(const void* config);
+	void (*destroy)(void* priv);
+
+	/* another private data with same config. it's for another tuner of same backend */
+	void* (*clone)(void* priv);
+
+	/* device. open returns a descriptor or -1 */
+	int (*open)(void* priv, const char* device);
+	int (*close)(void* priv, int fd);
+
+	/* tuner control */
+	int (*query_cap)(void* priv, int fd, struct v4l2_capability* vc);
+	int (*get_tuner)(void* priv, int fd, struct v4l2_tuner* vt);
+	int (*enum_freq_bands)(void* priv, int fd, struct v4l2_frequency_band* band);
+	int (*set_tuner)(void* priv, int fd, struct v4l2_tuner* vt);
+	int (*set_frequency)(void* priv, int fd, struct v4l2_frequency* vf);
+	int (*get_frequency)(void* priv, int fd, struct v4l2_frequency* vf);
+	int (*hw_seek)(void* priv, int fd, struct v4l2_hw_freq_seek* vs);
+	int (*set_ctrl)(void* priv, int fd, struct v4l2_control* vctrl);
+	int (*set_ext_ctrls)(void* priv, int fd, struct v4l2_ext_controls* ctrls);
+
+	/* signal quality beyond v4l2_tuner.signal. not a V4L2 ioctl */
+	int (*get_quality)(void* priv, int fd, MMRadioQuality_t* quality);
+
+	/* status snapshot at once. not a V4L2 ioctl. frequency is KHz */
+	int (*get_status)(void* priv, int fd, MMRadioTunerStatus* status);
+
+	/* thresholds of hardware seek. not a V4L2 ioctl */
+	int (*get_seek_threshold)(void* priv, int fd, MMRadioSeekThreshold* threshold);
+	int (*set_seek_threshold)(void* priv, int fd, const MMRadioSeekThreshold* threshold);
+
+	/* events. pending event makes fd readable with POLLPRI */
+	int (*subscribe_event)(void* priv, int fd, struct v4l2_event_subscription* sub);
+	int (*dequeue_event)(void* priv, int fd, struct v4l2_event* ev);
+} MMRadioBackendOps;
+
+/* V4L2 radio driver. config is not used */
+extern const MMRadioBackendOps mmradio_backend_v4l2;
+
+/* si470x path of V4L2 backend. status registers are read directly by VIDIOC_DBG_G_REGISTER */
+typedef struct {
+	int present;		/* chip is found and its registers are readable */
+	pthread_mutex_t band_lock;	/* band is changed by command thread while samplers decode status */
+	int band_bottom;	/* KHz */
+	int spacing;		/* KHz. zero means band should be read again */
+} MMRadioSi470x_t;
+
+void _mmradio_si470x_init(MMRadioSi470x_t* chip);
+void _mmradio_si470x_deinit(MMRadioSi470x_t* chip);
+int _mmradio_si470x_probe(int fd, MMRadioSi470x_t* chip);
+void _mmradio_si470x_update_band(int fd, MMRadioSi470x_t* chip);
+int _mmradio_si470x_get_status(int fd, MMRadioSi470x_t* chip, MMRadioTunerStatus* status);
+int _mmradio_si470x_get_seek_threshold(int fd, MMRadioSi470x_t* chip, MMRadioSeekThreshold* threshold);
+int _mmradio_si470x_set_seek_threshold(int fd, MMRadioSi470x_t* chip, const MMRadioSeekThreshold* threshold);
+
+/* list radio devices of V4L2. returns number of devices found, which can be bigger than max_devices */
+int _mmradio_v4l2_enumerate(MMRadioDeviceInfo* devices, int max_devices);
+
+/* in-process simulated tuner. config is MMRadioSimConfig */
+extern const MMRadioBackendOps mmradio_backend_sim;
+
+#endif /* MM_RADIO_BACKEND_H_ */
@@ -27,6 +27,7 @@
 ========================================================================================== */
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <unistd.h>
 #include <malloc.h>
 #include <pthread.h>
@@ -36,6 +37,7 @@
 #include <mm_message.h>
 
 #include "mm_radio_asm.h"
+#include "mm_radio_backend.h"
 #include "mm_radio.h"
 #include "mm_radio_utils.h"
 #include <linux/videodev2.h>
@@ -57,6 +59,10 @@
 #define SAMPLEDELAY     	15000
 
 /* si470x dependent define */
+#define DEVICEID					0		/* Device ID */
+#define DEVICEID_MFGID				0x0fff	/* bits 11..00: Manufacturer ID */
+#define DEVICEID_MFGID_SILABS		0x0242	/* Silicon Laboratories */
+
 #define SYSCONFIG1					4		/* System Configuration 1 */
 #define SYSCONFIG1_RDS				0x1000	/* bits 12..12: RDS Enable */
 #define SYSCONFIG1_RDS_OFFSET		12		/* bits 12..12: RDS Enable Offset */
@@ -64,6 +70,10 @@
 #define SYSCONFIG2					5		/* System Configuration 2 */
 #define SYSCONFIG2_SEEKTH			0xff00	/* bits 15..08: RSSI Seek Threshold */
 #define SYSCONFIG2_SEEKTH_OFFSET	8		/* bits 15..08: RSSI Seek Threshold Offset */
+#define SYSCONFIG2_BAND				0x00c0	/* bits 07..06: Band Select */
+#define SYSCONFIG2_BAND_OFFSET		6		/* bits 07..06: Band Select Offset */
+#define SYSCONFIG2_SPACE			0x0030	/* bits 05..04: Channel Spacing */
+#define SYSCONFIG2_SPACE_OFFSET		4		/* bits 05..04: Channel Spacing Offset */
 
 #define SYSCONFIG3					6		/* System Configuration 3 */
 #define SYSCONFIG3_SKSNR			0x00f0	/* bits 07..04: Seek SNR Threshold */
@@ -71,8 +81,23 @@
 #define SYSCONFIG3_SKSNR_OFFSET	4		/* bits 07..04: Seek SNR Threshold Offset */
 #define SYSCONFIG3_SKCNT_OFFSET	0		/* bits 03..00: Seek FM Impulse Detection Threshold Offset */
 
+#define STATUSRSSI					10		/* Status RSSI */
+#define STATUSRSSI_RDSR				0x8000	/* bits 15..15: RDS Ready */
+#define STATUSRSSI_STC				0x4000	/* bits 14..14: Seek/Tune Complete */
+#define STATUSRSSI_SF				0x2000	/* bits 13..13: Seek Fail/Band Limit */
+#define STATUSRSSI_AFCRL			0x1000	/* bits 12..12: AFC Rail */
+#define STATUSRSSI_ST				0x0100	/* bits 08..08: Stereo Indicator */
+#define STATUSRSSI_RSSI				0x00ff	/* bits 07..00: RSSI (Received Signal Strength Indicator) */
+
+#define READCHAN					11		/* Read Channel */
+#define READCHAN_READCHAN			0x03ff	/* bits 09..00: Read Channel */
+
 #define DEFAULT_CHIP_MODEL			"radio-si470x"
 
+/* KHz <-> tuner frequency unit of the handle */
+#define RADIO_FREQ_FORMAT_SET(x_radio, x_freq)	((unsigned int)((unsigned long long)(x_freq) * 10000 / (x_radio)->freq_unit))
+#define RADIO_FREQ_FORMAT_GET(x_radio, x_freq)	((int)(((unsigned long long)(x_freq) * (x_radio)->freq_unit + 5000) / 10000))
+
 /*---------------------------------------------------------------------------
     GLOBAL CONSTANT DEFINITIONS:
 ---------------------------------------------------------------------------*/
@@ -93,9 +118,28 @@ typedef enum
 	MMRADIO_COMMAND_SEEK,
 	MMRADIO_COMMAND_SET_REGION,
 	MMRADIO_COMMAND_GET_REGION,
+	MMRADIO_COMMAND_SET_BACKEND,
+	MMRADIO_COMMAND_SIGNAL_MONITOR,
+	MMRADIO_COMMAND_SET_DEVICE,
+	MMRADIO_COMMAND_SET_SCAN_TUNERS,
+	MMRADIO_COMMAND_SET_SCAN_BATCH,
+	MMRADIO_COMMAND_SET_SCAN_DEDUP,
+	MMRADIO_COMMAND_SWEEP,
 	MMRADIO_COMMAND_NUM
 } MMRadioCommand;
 
+/* statistics of calls. tuner operations are indexed by their position in MMRadioBackendOps */
+#define MMRADIO_STAT_TUNER_OP(x_op)		( offsetof(MMRadioBackendOps, x_op) / sizeof(void*) )
+
+enum
+{
+	MMRADIO_STAT_GST_SET_STATE = sizeof(MMRadioBackendOps) / sizeof(void*),
+	MMRADIO_STAT_GST_GET_STATE,
+	MMRADIO_STAT_ASM_SET_STATE,
+	MMRADIO_STAT_APPLY_SETTINGS,	/* a batch of ioctls. number of them is counted also */
+	MMRADIO_STAT_NUM
+};
+
 /* max and mix frequency types, KHz */
 typedef enum
 {
@@ -124,9 +168,167 @@ typedef struct
 	MMRadioDeemphasis deemphasis;	// unit :  us
 	MMRadioFreqTypes band_min;		// <- freq. range, unit : KHz
 	MMRadioFreqTypes band_max;		// ->
-	//int channel_spacing;				// TBD
+	int channel_spacing;				// unit : KHz. legal frequencies are band_min + n * channel_spacing
 }MMRadioRegion_t;
 
+/* shadow of tuner state. time is zero when it's not valid */
+typedef struct
+{
+	int freq;						// unit : KHz
+	int signal;
+	unsigned long long freq_time;	// unit : usec, monotonic
+	unsigned long long signal_time;
+}MMRadioShadow_t;
+
+/* history of signal quality. it's a ring, and the size should be power of 2 */
+#define MMRADIO_QUALITY_HISTORY		1024
+
+/* a sample of signal quality. seq is odd while it's being written */
+typedef struct
+{
+	volatile unsigned int seq;
+	unsigned int valid;				// MMRADIO_QUALITY_VALID_XXX
+	unsigned long long time;		// unit : usec, monotonic
+	int value[MM_RADIO_QUALITY_NUM];
+}MMRadioQualitySample_t;
+
+/* bounded retry with exponential backoff */
+typedef struct
+{
+	int max_retries;
+	int initial_backoff;			// unit : msec
+	int max_backoff;				// unit : msec
+	int deadline;					// unit : msec. since the first failure of a run
+}MMRadioRetryPolicy_t;
+
+typedef struct
+{
+	const MMRadioRetryPolicy_t* policy;
+	int attempts;					// retries of current run of failures
+	int retries;					// retries in total
+	int backoff;					// next backoff, msec
+	unsigned long long first_failure;	// unit : usec. zero means no failure
+	int cancel_fd;					// backoff is cut short when it's readable. -1 if none
+}MMRadioRetry_t;
+
+/* opened tuner. the one of the handle, or one opened for parallel scan or refresh */
+typedef struct
+{
+	void* priv;						// backend state of the device
+	int fd;
+	int tuner_index;
+	unsigned int freq_unit;			// unit : 0.1Hz
+}MMRadioTuner_t;
+
+/* additional tuner of parallel scan */
+typedef struct
+{
+	char device[MM_RADIO_DEVICE_PATH_MAX];
+	int tuner_index;
+}MMRadioScanTuner_t;
+
+/* stations found by scan. array never moves while scan is running */
+typedef struct
+{
+	MMRadioStation* stations;
+	int capacity;
+	int num_stations;				// written by scan thread with lock
+	int delivered;					// number of stations posted by delivery thread
+	int batch_size;					// zero : MM_MESSAGE_RADIO_SCAN_INFO for each station
+	bool finished;
+	bool discard;					// scan is stopped. nothing is posted any more
+	pthread_t thread;				// delivery thread. zero if stations are posted by scan thread
+	pthread_t posting;				// delivery thread while it's in the callback. zero otherwise
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+
+	/* merging hits next to each other. used by scan thread only */
+	int dedup_window;				// KHz. zero : every hit is a station
+	int dedup_dwell;				// msec to confirm the strongest one of a group. zero : not confirmed
+	MMRadioStation pending;			// strongest one of current group. frequency is zero if none
+	bool pending_tunable;			// tuner of the handle is free to confirm pending one
+	int merged;						// hits merged or dropped by last scan
+
+	/* checkpoint of interrupted scan. stations so far are kept in the array */
+	int checkpoint;					// KHz. band is scanned up to here. zero if none is found yet
+	MMRadioRegionType checkpoint_region;
+	bool checking_known;			// known stations of budgeted scan are added. checkpoint doesn't move
+	bool resumable;					// last scan is stopped before the end of band
+	bool resume;					// scan being started continues from checkpoint
+}MMRadioScanResults_t;
+
+/* job of tuner worker. it's called with the handle */
+typedef void (*MMRadioJobFunc_t)(void* radio);
+
+#define MMRADIO_JOB_QUEUE_MAX		8
+
+typedef struct
+{
+	MMRadioJobFunc_t func;
+	const char* name;
+	unsigned int seq;
+}MMRadioJob_t;
+
+/* long-lived tuner worker of the handle. seek and scan run on it one by one */
+typedef struct
+{
+	pthread_t thread;				// started by the first job. zero if not yet
+	pthread_mutex_t lock;
+	pthread_cond_t cond;			// job is queued or done, or worker is stopped
+	MMRadioJob_t queue[MMRADIO_JOB_QUEUE_MAX];
+	int head;
+	int count;
+	unsigned int submitted;			// sequence of the last job queued
+	unsigned int done;				// sequence of the last job finished
+	bool stop;
+}MMRadioJobWorker_t;
+
+/* time budget of scan. used by scan thread and its watchdog */
+typedef struct
+{
+	MMRadioScanBudget config;		// for next scan. cleared when scan is over
+	bool active;					// progress is posted
+	bool expired;					// scan is aborted by watchdog
+	bool done;						// scan thread is over. watchdog exits
+	pthread_t watchdog;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;			// monotonic clock
+	unsigned long long begin;		// usec
+	int known_total;				// known stations to check
+	int known_done;
+	unsigned long long band_begin;	// usec. zero until band scan starts
+}MMRadioScanBudget_t;
+
+/* station database. file is mapped while it's opened */
+typedef struct
+{
+	int fd;
+	void* map;
+	size_t size;					// mapped size
+	pthread_mutex_t lock;
+}MMRadioStationDb_t;
+
+/* latency statistics of a call. guarded by stats_lock of the handle */
+typedef struct
+{
+	unsigned int count;
+	unsigned int errors;
+	unsigned long long total;		// unit : usec
+	unsigned int max;				// unit : usec
+	unsigned int ioctls;			// ioctls issued by the calls. only for a batch of them
+	unsigned int histogram[MM_RADIO_STATS_BUCKETS];
+}MMRadioStat_t;
+
+/* tuner settings which are applied to device together */
+typedef struct
+{
+	unsigned int audmode;			// V4L2_TUNER_MODE_XXX
+	unsigned int rangelow;			// unit : tuner frequency unit
+	unsigned int rangehigh;
+	int deemphasis;				// V4L2 de-emphasis value
+	int mute;
+}MMRadioSettings_t;
+
 /*---------------------------------------------------------------------------
     GLOBAL DATA TYPE DEFINITIONS:
 ---------------------------------------------------------------------------*/
@@ -155,6 +357,10 @@ typedef struct {
 	/* command lock */
 	pthread_mutex_t cmd_lock;
 
+	/* tuner state shadow. it's protected by shadow_lock, not cmd_lock */
+	pthread_mutex_t shadow_lock;
+	MMRadioShadow_t shadow;
+
 	/* radio attributes */
 	MMHandleType* attrs;
 
@@ -165,26 +371,117 @@ typedef struct {
 	/* radio device fd */
 	int radio_fd;
 
+	/* radio device and tuner of this handle */
+	char device[MM_RADIO_DEVICE_PATH_MAX];
+	int tuner_index;
+
+	/* tuner capability. they are known after opening device */
+	unsigned int freq_unit;		/* unit of tuner frequency, 0.1Hz */
+	int hw_band_min;			/* supported range of tuner, KHz */
+	int hw_band_max;
+
+	/* tuner backend */
+	const MMRadioBackendOps* backend;
+	void* backend_priv;
+
 	/* device control */
 	struct v4l2_capability vc;
 	struct v4l2_tuner vt;
 	struct v4l2_control vctrl;
 	struct v4l2_frequency vf;
 
+	/* settings. requested ones and the ones device has now */
+	MMRadioSettings_t settings;
+	MMRadioSettings_t applied;
+	bool ext_ctrls_unsupported;
+
 	/* hw debug */
 	struct v4l2_dbg_register reg;
 
+	/* keep-warm. device and pipeline are kept for a while after unrealize */
+	int keep_warm;			/* grace period, msec. zero means disabled */
+	bool parked;
+	bool unpark;
+	pthread_t park_thread;
+	pthread_mutex_t park_lock;
+	pthread_cond_t park_cond;
+
+	/* coalescing tune. worker applies the latest request in mailbox.
+	 * worker takes command lock, so mode changes are serialized by tune_mode_lock, and
+	 * tune_mode and the mailbox are guarded by tune_lock
+	 */
+	pthread_mutex_t tune_mode_lock;
+	MMRadioTuneMode tune_mode;
+	pthread_t tune_thread;
+	pthread_mutex_t tune_lock;
+	pthread_cond_t tune_cond;
+	int tune_pending;		/* KHz. zero means mailbox is empty */
+	int tune_applying;		/* KHz. the one worker is applying now. zero if it's idle */
+	bool tune_stop;
+
+	/* asynchronous realize. worker holds command lock while realizing, so they are guarded by realize_lock */
+	pthread_mutex_t realize_lock;
+	pthread_t realize_thread;
+	bool realize_running;
+	bool realize_cancel;
+
+	/* tuner worker. seek and scan are its jobs */
+	MMRadioJobWorker_t job_worker;
+
 	/* scan */
-	pthread_t	scan_thread;
-	bool	stop_scan;
+	unsigned int scan_job;			/* job of the last scan. zero if none */
+	bool	stop_scan;				/* set while scan is being stopped */
+	int scan_cancel_fd;			/* eventfd. readable while scan is being stopped */
+	MMRadioScanTuner_t scan_tuners[MM_RADIO_MAX_SCAN_TUNERS];	/* band is divided among these and the tuner of the handle */
+	int num_scan_tuners;
+	MMRadioScanResults_t scan_results;
+	MMRadioScanBudget_t scan_budget;
 
 	/* seek */
-	pthread_t seek_thread;
 	int prev_seek_freq;
 	MMRadioSeekDirectionType seek_direction;
+	MMRadioSeekProfileType seek_profile;
+	MMRadioSeekThreshold seek_threshold;
+	bool seek_threshold_dirty;		/* tuner should be programmed before next seek */
+	bool seek_threshold_applied;	/* tuner has seek_threshold */
+	MMRadioSeekThreshold seek_threshold_power_on;	/* tuner's own thresholds, read before first apply */
+	bool seek_threshold_saved;		/* seek_threshold_power_on is read */
+	MMRadioSeekEngine seek_engine;
+	int seek_settle;				/* settle time of software seek, msec */
+	bool hw_seek_unsupported;		/* hardware seek is refused by tuner. software seek is used in auto */
+
+	/* station database. scan thread merges stations without command lock */
+	MMRadioStationDb_t station_db;
+
+	/* background station refresh. it never waits for command lock, but holds it during a slice by the tuner of the handle */
+	pthread_t refresh_thread;
+	int refresh_wakeup[2];	/* pipe to wake up refresh thread */
+	MMRadioRefreshConfig refresh_config;
+	char refresh_device[MM_RADIO_DEVICE_PATH_MAX];	/* refresh_config.device points it */
+	bool refresh_idle;
+
+	/* signal monitor */
+	pthread_t monitor_thread;
+	int monitor_wakeup;		/* write end of pipe to wake up monitor thread */
+	int monitor_hysteresis;
+
+	/* signal quality sampler. history is written by sampler only, and read under command lock which keeps it allocated */
+	pthread_t sampler_thread;
+	int sampler_wakeup[2];	/* pipe to wake up sampler thread */
+	int sampler_interval;
+	bool quality_unsupported;	/* backend can't give quality. VIDIOC_G_TUNER is used */
+	MMRadioQualitySample_t* history;
+	volatile unsigned int history_head;	/* number of samples written */
+
+	/* statistics. stats_lock guards stats, so readers see counters of the same calls */
+	bool stats_enabled;
+	pthread_mutex_t stats_lock;
+	MMRadioStat_t stats[MMRADIO_STAT_NUM];
 
 	/* ASM */
 	MMRadioASM sm;
+	bool asm_stop_pending;		/* ASM asked to stop while a command held the lock. tuner worker stops radio */
+	int asm_stop_src;			/* event source of the deferred stop */
 
 	int freq;
 #ifdef USE_GST_PIPELINE
@@ -201,10 +498,15 @@ typedef struct {
 int _mmradio_create_radio(mm_radio_t* radio);
 int _mmradio_destroy(mm_radio_t* radio);
 int _mmradio_realize(mm_radio_t* radio);
+int _mmradio_realize_async(mm_radio_t* radio);
+int _mmradio_cancel_realize(mm_radio_t* radio);
 int _mmradio_unrealize(mm_radio_t* radio);
 int _mmradio_set_message_callback(mm_radio_t* radio, MMMessageCallback callback, void *user_param);
 int _mmradio_get_state(mm_radio_t* radio, int* pState);
 int _mmradio_set_frequency(mm_radio_t* radio, int freq);
+int _mmradio_tune_raw(mm_radio_t* radio, const MMRadioTuner_t* tuner, int freq);
+int _mmradio_set_tune_mode(mm_radio_t* radio, MMRadioTuneMode mode);
+int _mmradio_request_frequency(mm_radio_t* radio, int freq);
 int _mmradio_get_frequency(mm_radio_t* radio, int* pFreq);
 int _mmradio_mute(mm_radio_t* radio);
 int _mmradio_unmute(mm_radio_t* radio);
@@ -222,6 +524,76 @@ int _mmradio_destroy_pipeline(mm_radio_t* radio);
 int _mmradio_apply_region(mm_radio_t*radio, MMRadioRegionType region, bool update);
 int _mmradio_get_region_type(mm_radio_t*radio, MMRadioRegionType *type);
 int _mmradio_get_region_frequency_range(mm_radio_t* radio, uint *min_freq, uint *max_freq);
+int _mmradio_get_channel_spacing(mm_radio_t* radio, int *spacing);
+int _mmradio_set_seek_profile(mm_radio_t* radio, MMRadioSeekProfileType profile, const MMRadioSeekThreshold* threshold);
+int _mmradio_get_seek_profile(mm_radio_t* radio, MMRadioSeekProfileType* profile, MMRadioSeekThreshold* threshold);
+int _mmradio_set_seek_engine(mm_radio_t* radio, MMRadioSeekEngine engine, int settle_time);
+int _mmradio_get_seek_engine(mm_radio_t* radio, MMRadioSeekEngine* engine);
+bool _mmradio_use_sw_seek(mm_radio_t* radio);
+int _mmradio_sw_seek(mm_radio_t* radio, const struct v4l2_hw_freq_seek* vs);
+int _mmradio_sw_seek_threshold(mm_radio_t* radio);
+int _mmradio_sw_seek_settle(mm_radio_t* radio);
+unsigned int _mmradio_get_freq_unit(unsigned int capability);
+MMRadioRegionType _mmradio_get_current_region(mm_radio_t* radio);
+int _mmradio_open_station_db(mm_radio_t* radio, const char* path);
+void _mmradio_close_station_db(mm_radio_t* radio);
+int _mmradio_get_stations(mm_radio_t* radio, MMRadioStation* stations, int max_stations, int* num_stations);
+int _mmradio_invalidate_stations(mm_radio_t* radio, int frequency);
+int _mmradio_merge_stations(mm_radio_t* radio, const MMRadioStation* stations, int num_stations);
+int _mmradio_start_station_refresh(mm_radio_t* radio, const MMRadioRefreshConfig* config);
+int _mmradio_stop_station_refresh(mm_radio_t* radio);
+int _mmradio_set_refresh_idle(mm_radio_t* radio, int idle);
+int _mmradio_set_scan_tuners(mm_radio_t* radio, const MMRadioScanTuner* tuners, int num_tuners);
+int _mmradio_parallel_scan(mm_radio_t* radio, const struct v4l2_hw_freq_seek* vs, int low, int* num_stations, MMRadioRetry_t* retry);
+int _mmradio_set_scan_batch(mm_radio_t* radio, int batch_size);
+int _mmradio_get_scan_results(mm_radio_t* radio, MMRadioScanBatch* results);
+int _mmradio_set_scan_dedup(mm_radio_t* radio, int window, int dwell);
+int _mmradio_start_scan_budget(mm_radio_t* radio, const MMRadioScanBudget* budget);
+int _mmradio_resume_scan(mm_radio_t* radio);
+int _mmradio_submit_job(mm_radio_t* radio, MMRadioJobFunc_t func, const char* name, unsigned int* seq);
+void _mmradio_wait_job(mm_radio_t* radio, unsigned int seq);
+bool _mmradio_job_busy(mm_radio_t* radio);
+void _mmradio_stop_job_worker(mm_radio_t* radio);
+void _mmradio_begin_scan_budget(mm_radio_t* radio);
+void _mmradio_scan_known_stations(mm_radio_t* radio);
+void _mmradio_post_scan_progress(mm_radio_t* radio, int freq);
+bool _mmradio_end_scan_budget(mm_radio_t* radio);
+void _mmradio_abort_scan(mm_radio_t* radio);
+int _mmradio_begin_scan_results(mm_radio_t* radio);
+void _mmradio_add_scan_result(mm_radio_t* radio, int freq, int signal);
+void _mmradio_end_scan_results(mm_radio_t* radio, bool discard);
+void _mmradio_free_scan_results(mm_radio_t* radio);
+bool _mmradio_in_scan_batch_callback(mm_radio_t* radio);
+int _mmradio_sweep_band(mm_radio_t* radio, MMRadioChannelSignal* channels, int max_channels, int* num_channels,
+						MMRadioSweepCallback callback, void* user_param);
+int _mmradio_set_backend(mm_radio_t* radio, const MMRadioBackendOps* backend, const void* config);
+int _mmradio_set_device(mm_radio_t* radio, const char* device, int tuner_index);
+int _mmradio_get_signal_strength(mm_radio_t* radio, int* value);
+int _mmradio_get_tuner_status(mm_radio_t* radio, MMRadioTunerStatus* status);
+int _mmradio_get_cached_frequency(mm_radio_t* radio, int max_age, int* pFreq);
+int _mmradio_get_tuned_frequency(mm_radio_t* radio);
+int _mmradio_get_cached_signal_strength(mm_radio_t* radio, int max_age, int* value);
+unsigned long long _mmradio_get_time_usec(void);
+void _mmradio_retry_init(MMRadioRetry_t* retry, const MMRadioRetryPolicy_t* policy);
+bool _mmradio_retry_backoff(MMRadioRetry_t* retry);
+void _mmradio_retry_reset(MMRadioRetry_t* retry);
+bool _mmradio_wait_cancel(int fd, int usec);
+int _mmradio_check_state(mm_radio_t* radio, MMRadioCommand command);
+bool _mmradio_post_message(mm_radio_t* radio, enum MMMessageType msgtype, MMMessageParamType* param);
+int _mmradio_close_device(mm_radio_t* radio);
+int _mmradio_set_keep_warm(mm_radio_t* radio, int grace);
+int _mmradio_park(mm_radio_t* radio);
+int _mmradio_unpark(mm_radio_t* radio, bool teardown);
+int _mmradio_start_quality_sampling(mm_radio_t* radio, int interval);
+int _mmradio_stop_quality_sampling(mm_radio_t* radio);
+int _mmradio_read_quality(mm_radio_t* radio, MMRadioQuality_t* quality);
+int _mmradio_get_quality_stats(mm_radio_t* radio, MMRadioQualityType type, int window, MMRadioQualityStats* stats);
+int _mmradio_enable_stats(mm_radio_t* radio, bool enable);
+int _mmradio_get_stats(mm_radio_t* radio, MMRadioStatsEntry* entries, int max_entries, int* num_entries, bool reset);
+long _mmradio_stats_end(mm_radio_t* radio, int stat, long result, unsigned long long begin);
+void _mmradio_stats_end_batch(mm_radio_t* radio, int stat, long result, unsigned long long begin, int ioctls);
+int _mmradio_start_signal_monitor(mm_radio_t* radio, int hysteresis);
+int _mmradio_stop_signal_monitor(mm_radio_t* radio);
 #if 0
 int mmradio_set_attrs(mm_radio_t*  radio, MMRadioAttrsType type, MMHandleType attrs);
 MMHandleType mmradio_get_attrs(mm_radio_t*  radio, MMRadioAttrsType type);
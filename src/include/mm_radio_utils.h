@@ -65,10 +65,23 @@ if ( x_radio->radio_fd < 0 ) \
 #define MMRADIO_CMD_LOCK(x_radio)		pthread_mutex_lock( &((mm_radio_t*)x_radio)->cmd_lock )
 #define MMRADIO_CMD_UNLOCK(x_radio)		pthread_mutex_unlock( &((mm_radio_t*)x_radio)->cmd_lock )
 
-/* message posting */
+/* timing of a call for statistics. it costs just one branch when statistics is disabled.
+ * start time is kept on the stack of the caller, so timed calls can be nested
+ */
+#define MMRADIO_TIMED(x_radio, x_stat, x_call) \
+	( __builtin_expect( ((mm_radio_t*)x_radio)->stats_enabled, 0 ) ? \
+		({ unsigned long long x_begin__ = _mmradio_get_time_usec(); \
+			_mmradio_stats_end( (mm_radio_t*)x_radio, x_stat, (long)(x_call), x_begin__ ); }) : (long)(x_call) )
+
+/* tuner backend operation. works same as ioctl() on radio device */
+#define MMRADIO_TUNER_OP(x_radio, x_op, x_arg) \
+	(int)MMRADIO_TIMED( x_radio, MMRADIO_STAT_TUNER_OP(x_op), \
+		((mm_radio_t*)x_radio)->backend->x_op( ((mm_radio_t*)x_radio)->backend_priv, ((mm_radio_t*)x_radio)->radio_fd, x_arg ) )
+
+/* message posting. radio messages are not in enum MMMessageType, so it's casted */
 #define MMRADIO_POST_MSG( x_radio, x_msgtype, x_msg_param ) \
 debug_log("posting %s to application\n", #x_msgtype); \
-__mmradio_post_message(x_radio, x_msgtype, x_msg_param);
+_mmradio_post_message(x_radio, (enum MMMessageType)(x_msgtype), x_msg_param);
 
 /* setting radio state */
 #define MMRADIO_SET_STATE( x_radio, x_state ) \
@@ -78,7 +91,7 @@ __mmradio_set_state(x_radio, x_state);
 /* state */
 #define MMRADIO_CHECK_STATE_RETURN_IF_FAIL( x_radio, x_command ) \
 debug_log("checking radio state before doing %s\n", #x_command); \
-switch ( __mmradio_check_state(x_radio, x_command) ) \
+switch ( _mmradio_check_state(x_radio, x_command) ) \
 { \
 	case MM_ERROR_RADIO_INVALID_STATE: \
 		return MM_ERROR_RADIO_INVALID_STATE; \
@@ -138,7 +138,16 @@ int  mm_radio_destroy(MMHandleType hradio)
 	
 	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
 
+	/* worker takes command lock. stop it before */
+	_mmradio_cancel_realize( radio );
+	_mmradio_set_tune_mode( radio, MM_RADIO_TUNE_MODE_SYNC );
+
+	/* threads joined by destroy never block on command lock */
+	MMRADIO_CMD_LOCK( radio );
+
 	result = _mmradio_destroy( radio ); 
+
+	MMRADIO_CMD_UNLOCK( radio );
 	
 	if ( result != MM_ERROR_NONE )
 	{
@@ -180,6 +189,26 @@ int mm_radio_realize(MMHandleType hradio)
 	return result;
 }
 
+int mm_radio_realize_async(MMHandleType hradio)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_realize_async( radio );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
 int mm_radio_unrealize(MMHandleType hradio)
 {
 	int result = MM_ERROR_NONE;
@@ -189,6 +218,9 @@ int mm_radio_unrealize(MMHandleType hradio)
 
 	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
 
+	/* worker takes command lock. stop it before */
+	_mmradio_cancel_realize( radio );
+
 	MMRADIO_CMD_LOCK( radio );
 
 	__ta__("[KPI] cleanup media radio service", 
@@ -319,6 +351,14 @@ int mm_radio_set_frequency(MMHandleType hradio, int freq)
 
 	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
 
+	/* NOTE : worker applies it in coalescing mode. no command lock not to wait for tuner */
+	result = _mmradio_request_frequency( radio, freq );
+	if ( result != MM_ERROR_RADIO_NO_OP )
+	{
+		MMRADIO_LOG_FLEAVE();
+		return result;
+	}
+
 	MMRADIO_CMD_LOCK( radio );
 
 	result = _mmradio_set_frequency( radio, freq );
@@ -341,14 +381,11 @@ int mm_radio_get_frequency(MMHandleType hradio, int* pFreq)
 	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
 	return_val_if_fail(pFreq, MM_ERROR_INVALID_ARGUMENT);
 
-	MMRADIO_CMD_LOCK( radio );
-
-	result = _mmradio_get_frequency( radio, &freq );
+	/* NOTE : shadow is used. command lock is taken inside only if it's needed */
+	result = _mmradio_get_cached_frequency( radio, -1, &freq );
 
 	*pFreq = freq;
 
-	MMRADIO_CMD_UNLOCK( radio );
-
 	MMRADIO_LOG_FLEAVE();
 
 	return result;
@@ -432,23 +469,46 @@ int mm_radio_get_signal_strength(MMHandleType hradio, int *value)
 
 	mm_radio_t* radio = (mm_radio_t*)hradio;
 
-	MMRADIO_CMD_LOCK( radio );
+	/* NOTE : shadow is used. command lock is taken inside only if it's needed */
+	ret = _mmradio_get_cached_signal_strength( radio, -1, value );
 
-	if (ioctl(radio->radio_fd, VIDIOC_G_TUNER, &(radio->vt)) < 0)
-	{
-		debug_error("ioctl VIDIOC_G_TUNER error\n");
+	MMRADIO_LOG_FLEAVE();
 
-		return MM_ERROR_RADIO_INTERNAL;
-	}
+	return ret;
+}
+
+int mm_radio_get_cached_frequency(MMHandleType hradio, int max_age, int *pFreq)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
 
-	*value = radio->vt.signal;
+	MMRADIO_LOG_FENTER();
 
-	MMRADIO_CMD_UNLOCK( radio );
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+	return_val_if_fail(pFreq, MM_ERROR_INVALID_ARGUMENT);
+
+	result = _mmradio_get_cached_frequency( radio, max_age, pFreq );
 
-	MMRADIO_LOG_DEBUG("signal strength = %d\n", *value);
 	MMRADIO_LOG_FLEAVE();
 
-	return ret;
+	return result;
+}
+
+int mm_radio_get_cached_signal_strength(MMHandleType hradio, int max_age, int *value)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+	return_val_if_fail(value, MM_ERROR_INVALID_ARGUMENT);
+
+	result = _mmradio_get_cached_signal_strength( radio, max_age, value );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
 }
 
 int mm_radio_get_region_type(MMHandleType hradio, MMRadioRegionType *type)
@@ -494,3 +554,645 @@ int mm_radio_get_region_frequency_range(MMHandleType hradio, unsigned int *min,
 	return result;
 }
 
+int mm_radio_get_channel_spacing(MMHandleType hradio, int *spacing)
+{
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(hradio, MM_ERROR_RADIO_NOT_INITIALIZED);
+	return_val_if_fail(spacing, MM_ERROR_INVALID_ARGUMENT);
+
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	result = _mmradio_get_channel_spacing(radio, spacing);
+
+	MMRADIO_LOG_FLEAVE();
+	return result;
+}
+
+int mm_radio_get_device_list(MMRadioDeviceInfo *devices, int max_devices, int *num_devices)
+{
+	int count = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(num_devices, MM_ERROR_INVALID_ARGUMENT);
+
+	if ( ! devices )
+		max_devices = 0;
+
+	count = _mmradio_v4l2_enumerate( devices, max_devices );
+	if ( count < 0 )
+	{
+		debug_error("failed to get radio device list\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	*num_devices = count;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+int mm_radio_set_device(MMHandleType hradio, const char *device, int tuner_index)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_set_device( radio, device, tuner_index );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_keep_warm(MMHandleType hradio, int grace)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_set_keep_warm( radio, grace );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_simulation(MMHandleType hradio, const MMRadioSimConfig *config)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	if ( config )
+	{
+		result = _mmradio_set_backend( radio, &mmradio_backend_sim, config );
+	}
+	else
+	{
+		result = _mmradio_set_backend( radio, &mmradio_backend_v4l2, NULL );
+	}
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_start_signal_monitor(MMHandleType hradio, int hysteresis)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_start_signal_monitor( radio, hysteresis );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_stop_signal_monitor(MMHandleType hradio)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_stop_signal_monitor( radio );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_start_quality_sampling(MMHandleType hradio, int interval)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_start_quality_sampling( radio, interval );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_stop_quality_sampling(MMHandleType hradio)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_stop_quality_sampling( radio );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_get_quality_stats(MMHandleType hradio, MMRadioQualityType type, int window, MMRadioQualityStats *stats)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	/* history can be released by unrealize or destroy */
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_get_quality_stats( radio, type, window, stats );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_get_tuner_status(MMHandleType hradio, MMRadioTunerStatus *status)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_get_tuner_status( radio, status );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_seek_profile(MMHandleType hradio, MMRadioSeekProfileType profile, const MMRadioSeekThreshold *threshold)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_set_seek_profile( radio, profile, threshold );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_get_seek_profile(MMHandleType hradio, MMRadioSeekProfileType *profile, MMRadioSeekThreshold *threshold)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_get_seek_profile( radio, profile, threshold );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_seek_engine(MMHandleType hradio, MMRadioSeekEngine engine, int settle_time)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_set_seek_engine( radio, engine, settle_time );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_get_seek_engine(MMHandleType hradio, MMRadioSeekEngine *engine)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_get_seek_engine( radio, engine );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_station_db(MMHandleType hradio, const char *path)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_open_station_db( radio, path );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_get_stations(MMHandleType hradio, MMRadioStation *stations, int max_stations, int *num_stations)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_get_stations( radio, stations, max_stations, num_stations );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_invalidate_stations(MMHandleType hradio, int frequency)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_invalidate_stations( radio, frequency );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_merge_stations(MMHandleType hradio, const MMRadioStation *stations, int num_stations)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_merge_stations( radio, stations, num_stations );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_start_station_refresh(MMHandleType hradio, const MMRadioRefreshConfig *config)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_start_station_refresh( radio, config );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_stop_station_refresh(MMHandleType hradio)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_stop_station_refresh( radio );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_refresh_idle(MMHandleType hradio, int idle)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_set_refresh_idle( radio, idle );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_scan_tuners(MMHandleType hradio, const MMRadioScanTuner *tuners, int num_tuners)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_set_scan_tuners( radio, tuners, num_tuners );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_scan_batch(MMHandleType hradio, int batch_size)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_set_scan_batch( radio, batch_size );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_scan_dedup(MMHandleType hradio, int window, int dwell)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_set_scan_dedup( radio, window, dwell );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_scan_start_budget(MMHandleType hradio, const MMRadioScanBudget *budget)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+	return_val_if_fail(budget, MM_ERROR_INVALID_ARGUMENT);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_start_scan_budget( radio, budget );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_scan_resume(MMHandleType hradio)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_resume_scan( radio );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_get_scan_results(MMHandleType hradio, MMRadioScanBatch *results)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+	return_val_if_fail(results, MM_ERROR_INVALID_ARGUMENT);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_get_scan_results( radio, results );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_sweep_band(MMHandleType hradio, MMRadioChannelSignal *channels, int max_channels, int *num_channels,
+						MMRadioSweepCallback callback, void *user_param)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+	return_val_if_fail(num_channels, MM_ERROR_INVALID_ARGUMENT);
+
+	MMRADIO_CMD_LOCK( radio );
+
+	result = _mmradio_sweep_band( radio, channels, max_channels, num_channels, callback, user_param );
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_set_tune_mode(MMHandleType hradio, MMRadioTuneMode mode)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	/* NOTE : worker takes command lock. so, it's not taken here */
+	result = _mmradio_set_tune_mode( radio, mode );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_enable_stats(MMHandleType hradio, int enable)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	result = _mmradio_enable_stats( radio, enable ? true : false );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
+
+int mm_radio_get_stats(MMHandleType hradio, MMRadioStatsEntry *entries, int max_entries, int *num_entries, int reset)
+{
+	int result = MM_ERROR_NONE;
+	mm_radio_t* radio = (mm_radio_t*)hradio;
+
+	MMRADIO_LOG_FENTER();
+
+	return_val_if_fail(radio, MM_ERROR_RADIO_NOT_INITIALIZED);
+
+	/* no command lock. statistics are guarded by stats_lock, so it can be read while a command runs */
+	result = _mmradio_get_stats( radio, entries, max_entries, num_entries, reset ? true : false );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return result;
+}
@@ -0,0 +1,331 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* V4L2 radio driver backend. just passing everything to the kernel */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <mm_debug.h>
+
+#include "mm_radio_backend.h"
+#include "mm_radio_utils.h"
+
+typedef struct {
+	MMRadioSi470x_t si470x;		/* chip path. used only if the chip is found on open */
+} mm_radio_v4l2_t;
+
+static void*
+__mmradio_v4l2_create(const void* config)
+{
+	mm_radio_v4l2_t* v4l2 = NULL;
+
+	v4l2 = (mm_radio_v4l2_t*)malloc(sizeof(mm_radio_v4l2_t));
+	if ( ! v4l2 )
+		return NULL;
+
+	memset(v4l2, 0, sizeof(mm_radio_v4l2_t));
+	_mmradio_si470x_init(&v4l2->si470x);
+
+	return v4l2;
+}
+
+static void
+__mmradio_v4l2_destroy(void* priv)
+{
+	mm_radio_v4l2_t* v4l2 = (mm_radio_v4l2_t*)priv;
+
+	_mmradio_si470x_deinit(&v4l2->si470x);
+	free(v4l2);
+}
+
+static void*
+__mmradio_v4l2_clone(void* priv)
+{
+	return __mmradio_v4l2_create(NULL);
+}
+
+static int
+__mmradio_v4l2_open(void* priv, const char* device)
+{
+	mm_radio_v4l2_t* v4l2 = (mm_radio_v4l2_t*)priv;
+	int fd = -1;
+
+	fd = open(device, O_RDONLY);
+	if ( fd < 0 )
+		return fd;
+
+	_mmradio_si470x_probe(fd, &v4l2->si470x);
+
+	return fd;
+}
+
+static int
+__mmradio_v4l2_close(void* priv, int fd)
+{
+	mm_radio_v4l2_t* v4l2 = (mm_radio_v4l2_t*)priv;
+
+	v4l2->si470x.present = 0;
+
+	return close(fd);
+}
+
+static int
+__mmradio_v4l2_query_cap(void* priv, int fd, struct v4l2_capability* vc)
+{
+	return ioctl(fd, VIDIOC_QUERYCAP, vc);
+}
+
+static int
+__mmradio_v4l2_get_tuner(void* priv, int fd, struct v4l2_tuner* vt)
+{
+	return ioctl(fd, VIDIOC_G_TUNER, vt);
+}
+
+static int
+__mmradio_v4l2_enum_freq_bands(void* priv, int fd, struct v4l2_frequency_band* band)
+{
+#ifdef VIDIOC_ENUM_FREQ_BANDS
+	return ioctl(fd, VIDIOC_ENUM_FREQ_BANDS, band);
+#else
+	errno = ENOTTY;
+	return -1;
+#endif
+}
+
+static int
+__mmradio_v4l2_set_tuner(void* priv, int fd, struct v4l2_tuner* vt)
+{
+	mm_radio_v4l2_t* v4l2 = (mm_radio_v4l2_t*)priv;
+
+	if ( ioctl(fd, VIDIOC_S_TUNER, vt) < 0 )
+		return -1;
+
+	/* band of chip can be changed */
+	_mmradio_si470x_update_band(fd, &v4l2->si470x);
+
+	return 0;
+}
+
+static int
+__mmradio_v4l2_set_frequency(void* priv, int fd, struct v4l2_frequency* vf)
+{
+	return ioctl(fd, VIDIOC_S_FREQUENCY, vf);
+}
+
+static int
+__mmradio_v4l2_get_frequency(void* priv, int fd, struct v4l2_frequency* vf)
+{
+	return ioctl(fd, VIDIOC_G_FREQUENCY, vf);
+}
+
+static int
+__mmradio_v4l2_hw_seek(void* priv, int fd, struct v4l2_hw_freq_seek* vs)
+{
+	return ioctl(fd, VIDIOC_S_HW_FREQ_SEEK, vs);
+}
+
+static int
+__mmradio_v4l2_set_ctrl(void* priv, int fd, struct v4l2_control* vctrl)
+{
+	return ioctl(fd, VIDIOC_S_CTRL, vctrl);
+}
+
+static int
+__mmradio_v4l2_set_ext_ctrls(void* priv, int fd, struct v4l2_ext_controls* ctrls)
+{
+	return ioctl(fd, VIDIOC_S_EXT_CTRLS, ctrls);
+}
+
+static int
+__mmradio_v4l2_get_quality(void* priv, int fd, MMRadioQuality_t* quality)
+{
+	mm_radio_v4l2_t* v4l2 = (mm_radio_v4l2_t*)priv;
+	MMRadioTunerStatus status;
+
+	/* V4L2 has no control for it. caller uses VIDIOC_G_TUNER unless the chip gives RSSI */
+	if ( _mmradio_si470x_get_status(fd, &v4l2->si470x, &status) < 0 )
+		return -1;
+
+	memset(quality, 0, sizeof(MMRadioQuality_t));
+	quality->valid = MMRADIO_QUALITY_VALID_RSSI;
+	quality->value[MM_RADIO_QUALITY_RSSI] = status.signal;
+
+	return 0;
+}
+
+static int
+__mmradio_v4l2_get_status(void* priv, int fd, MMRadioTunerStatus* status)
+{
+	mm_radio_v4l2_t* v4l2 = (mm_radio_v4l2_t*)priv;
+
+	/* ENOTTY if the chip isn't there. caller uses generic requests */
+	return _mmradio_si470x_get_status(fd, &v4l2->si470x, status);
+}
+
+static int
+__mmradio_v4l2_get_seek_threshold(void* priv, int fd, MMRadioSeekThreshold* threshold)
+{
+	mm_radio_v4l2_t* v4l2 = (mm_radio_v4l2_t*)priv;
+
+	return _mmradio_si470x_get_seek_threshold(fd, &v4l2->si470x, threshold);
+}
+
+static int
+__mmradio_v4l2_set_seek_threshold(void* priv, int fd, const MMRadioSeekThreshold* threshold)
+{
+	mm_radio_v4l2_t* v4l2 = (mm_radio_v4l2_t*)priv;
+
+	/* V4L2 has no control for it */
+	return _mmradio_si470x_set_seek_threshold(fd, &v4l2->si470x, threshold);
+}
+
+static int
+__mmradio_v4l2_subscribe_event(void* priv, int fd, struct v4l2_event_subscription* sub)
+{
+	return ioctl(fd, VIDIOC_SUBSCRIBE_EVENT, sub);
+}
+
+static int
+__mmradio_v4l2_dequeue_event(void* priv, int fd, struct v4l2_event* ev)
+{
+	return ioctl(fd, VIDIOC_DQEVENT, ev);
+}
+
+const MMRadioBackendOps mmradio_backend_v4l2 =
+{
+	.name = "v4l2",
+	.create = __mmradio_v4l2_create,
+	.destroy = __mmradio_v4l2_destroy,
+	.clone = __mmradio_v4l2_clone,
+	.open = __mmradio_v4l2_open,
+	.close = __mmradio_v4l2_close,
+	.query_cap = __mmradio_v4l2_query_cap,
+	.get_tuner = __mmradio_v4l2_get_tuner,
+	.enum_freq_bands = __mmradio_v4l2_enum_freq_bands,
+	.set_tuner = __mmradio_v4l2_set_tuner,
+	.set_frequency = __mmradio_v4l2_set_frequency,
+	.get_frequency = __mmradio_v4l2_get_frequency,
+	.hw_seek = __mmradio_v4l2_hw_seek,
+	.set_ctrl = __mmradio_v4l2_set_ctrl,
+	.set_ext_ctrls = __mmradio_v4l2_set_ext_ctrls,
+	.get_quality = __mmradio_v4l2_get_quality,
+	.get_status = __mmradio_v4l2_get_status,
+	.get_seek_threshold = __mmradio_v4l2_get_seek_threshold,
+	.set_seek_threshold = __mmradio_v4l2_set_seek_threshold,
+	.subscribe_event = __mmradio_v4l2_subscribe_event,
+	.dequeue_event = __mmradio_v4l2_dequeue_event,
+};
+
+#define MAX_TUNERS_PER_DEVICE		8
+
+static int
+__mmradio_v4l2_filter_radio(const struct dirent* entry)
+{
+	return ( strncmp(entry->d_name, "radio", 5) == 0 );
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_v4l2_enumerate()
+ * Desc   : list /dev/radio* nodes which have tuner
+ * Param  :
+ *	    [out] devices : array to be filled. can be NULL if max_devices is zero
+ *	    [in] max_devices : number of elements of devices
+ * Return : number of devices found, or -1 on failure
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_v4l2_enumerate(MMRadioDeviceInfo* devices, int max_devices)
+{
+	struct dirent** entries = NULL;
+	int num_entries = 0;
+	int count = 0;
+	int i = 0;
+
+	num_entries = scandir("/dev", &entries, __mmradio_v4l2_filter_radio, alphasort);
+	if ( num_entries < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to scan /dev : %s\n", strerror(errno));
+		return -1;
+	}
+
+	for ( i = 0; i < num_entries; i++ )
+	{
+		struct v4l2_capability vc;
+		struct v4l2_tuner vt;
+		char path[MM_RADIO_DEVICE_PATH_MAX];
+		int num_tuners = 0;
+		int fd = -1;
+
+		snprintf(path, sizeof(path), "/dev/%s", entries[i]->d_name);
+		free(entries[i]);
+
+		fd = open(path, O_RDONLY);
+		if ( fd < 0 )
+		{
+			MMRADIO_LOG_DEBUG("skip %s : %s\n", path, strerror(errno));
+			continue;
+		}
+
+		memset(&vc, 0, sizeof(vc));
+		if ( ioctl(fd, VIDIOC_QUERYCAP, &vc) < 0 || ! ( vc.capabilities & V4L2_CAP_TUNER ) )
+		{
+			MMRADIO_LOG_DEBUG("skip %s : not a radio tuner\n", path);
+			close(fd);
+			continue;
+		}
+
+		/* tuners are numbered from zero without hole */
+		for ( num_tuners = 0; num_tuners < MAX_TUNERS_PER_DEVICE; num_tuners++ )
+		{
+			memset(&vt, 0, sizeof(vt));
+			vt.index = num_tuners;
+			if ( ioctl(fd, VIDIOC_G_TUNER, &vt) < 0 )
+				break;
+		}
+
+		close(fd);
+
+		if ( count < max_devices )
+		{
+			MMRadioDeviceInfo* info = &devices[count];
+
+			memset(info, 0, sizeof(MMRadioDeviceInfo));
+			strncpy(info->path, path, sizeof(info->path) - 1);
+			strncpy(info->driver, (const char*)vc.driver, sizeof(info->driver) - 1);
+			strncpy(info->card, (const char*)vc.card, sizeof(info->card) - 1);
+			info->capabilities = vc.capabilities;
+			info->num_tuners = num_tuners;
+		}
+
+		MMRADIO_LOG_DEBUG("radio device : %s [%s] %d tuner(s)\n", path, vc.card, num_tuners);
+
+		count++;
+	}
+
+	free(entries);
+
+	return count;
+}
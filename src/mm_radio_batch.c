@@ -0,0 +1,573 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <errno.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL #defines:
+---------------------------------------------------------------------------*/
+#define SCAN_RESULTS_DEFAULT_CAPACITY	256		/* if region is not known */
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static void*	__mmradio_scan_delivery_thread(void* data);
+static void	__mmradio_commit_scan_result(mm_radio_t* radio, MMRadioStation* station);
+static void	__mmradio_flush_scan_candidate(mm_radio_t* radio, int resume_freq);
+static bool	__mmradio_confirm_station(mm_radio_t* radio, MMRadioStation* station, int resume_freq);
+static int	__mmradio_tune_handle_tuner(mm_radio_t* radio, int freq);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_scan_batch()
+ * Desc   : set how stations found by scan are delivered
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] batch_size : stations of a batch. MM_RADIO_SCAN_BATCH_AT_END for once at the end.
+ *	                      zero means MM_MESSAGE_RADIO_SCAN_INFO for each station
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_scan_batch(mm_radio_t* radio, int batch_size)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SET_SCAN_BATCH );
+
+	return_val_if_fail( batch_size >= 0 || batch_size == MM_RADIO_SCAN_BATCH_AT_END, MM_ERROR_INVALID_ARGUMENT );
+
+	radio->scan_results.batch_size = batch_size;
+
+	MMRADIO_LOG_DEBUG("scan batch size : %d\n", batch_size);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_scan_dedup()
+ * Desc   : set how hits next to each other are merged into one station
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] window : KHz. hits within window of the strongest one of a group are merged. zero means off
+ *	    [in] dwell : msec to confirm the strongest one before it's added. zero means not confirmed
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_scan_dedup(mm_radio_t* radio, int window, int dwell)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SET_SCAN_DEDUP );
+
+	return_val_if_fail( window >= 0 && dwell >= 0, MM_ERROR_INVALID_ARGUMENT );
+
+	radio->scan_results.dedup_window = window;
+	radio->scan_results.dedup_dwell = dwell;
+
+	MMRADIO_LOG_DEBUG("scan dedup window : %d KHz, dwell : %d msec\n", window, dwell);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_resume_scan()
+ * Desc   : start scan which continues the last one stopped before the end of band.
+ *          stations found so far are kept, and band is scanned from the checkpoint.
+ *          it's same as _mmradio_start_scan() if there's nothing to resume
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_resume_scan(mm_radio_t* radio)
+{
+	MMRadioScanResults_t* scan_results = NULL;
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_START_SCAN );
+
+	scan_results = &radio->scan_results;
+
+	/* band of other region has nothing to do with the checkpoint */
+	scan_results->resume = ( scan_results->resumable && scan_results->stations &&
+		scan_results->checkpoint_region == radio->region_setting.country );
+
+	MMRADIO_LOG_DEBUG("%s scan. checkpoint %d KHz, %d stations\n", scan_results->resume ? "resuming" : "starting",
+		scan_results->checkpoint, scan_results->num_stations);
+
+	ret = _mmradio_start_scan(radio);
+	if ( ret != MM_ERROR_NONE )
+		scan_results->resume = false;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_scan_results()
+ * Desc   : get stations found by last scan. array is not copied
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [out] results : stations
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_get_scan_results(mm_radio_t* radio, MMRadioScanBatch* results)
+{
+	MMRadioScanResults_t* scan_results = NULL;
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	scan_results = &radio->scan_results;
+
+	pthread_mutex_lock(&scan_results->lock);
+
+	memset(results, 0, sizeof(MMRadioScanBatch));
+	results->stations = scan_results->stations;
+	results->num_stations = scan_results->num_stations;
+	results->first_new = 0;
+	results->finished = scan_results->finished;
+
+	pthread_mutex_unlock(&scan_results->lock);
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_begin_scan_results()
+ * Desc   : prepare array for new scan. it's big enough for every channel of the region.
+ *          array is kept if scan is resumed. delivery thread is started in batch delivery.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_begin_scan_results(mm_radio_t* radio)
+{
+	MMRadioScanResults_t* scan_results = &radio->scan_results;
+	int spacing = radio->region_setting.channel_spacing;
+	int capacity = SCAN_RESULTS_DEFAULT_CAPACITY;
+	MMRadioStation* stations = NULL;
+
+	/* last one is over already. nothing left to be posted */
+	_mmradio_end_scan_results(radio, true);
+
+	scan_results->pending.frequency = 0;
+	scan_results->checking_known = false;
+
+	/* stations not delivered before the stop go with the first batch */
+	if ( scan_results->resume )
+	{
+		pthread_mutex_lock(&scan_results->lock);
+		scan_results->finished = false;
+		scan_results->discard = false;
+		pthread_mutex_unlock(&scan_results->lock);
+
+		goto DELIVERY;
+	}
+
+	scan_results->merged = 0;
+	scan_results->checkpoint = 0;
+	scan_results->checkpoint_region = radio->region_setting.country;
+
+	if ( spacing > 0 && radio->region_setting.band_max > radio->region_setting.band_min )
+		capacity = ( radio->region_setting.band_max - radio->region_setting.band_min ) / spacing + 1;
+
+	stations = (MMRadioStation*)malloc(sizeof(MMRadioStation) * capacity);
+	if ( ! stations )
+	{
+		MMRADIO_LOG_ERROR("failed to allocate scan results\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	pthread_mutex_lock(&scan_results->lock);
+
+	MMRADIO_FREEIF( scan_results->stations );
+	scan_results->stations = stations;
+	scan_results->capacity = capacity;
+	scan_results->num_stations = 0;
+	scan_results->delivered = 0;
+	scan_results->finished = false;
+	scan_results->discard = false;
+
+	pthread_mutex_unlock(&scan_results->lock);
+
+DELIVERY:
+	if ( scan_results->batch_size == 0 )
+		return MM_ERROR_NONE;
+
+	if ( pthread_create(&scan_results->thread, NULL, __mmradio_scan_delivery_thread, (void*)radio) )
+	{
+		MMRADIO_LOG_ERROR("failed to create thread : scan delivery\n");
+		scan_results->thread = 0;
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_add_scan_result()
+ * Desc   : hit is found by scan. it's called from scan thread.
+ *          hits next to each other are merged into the strongest one, and it's committed
+ *          when a hit out of window is found.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] freq : frequency, KHz
+ *	    [in] signal : signal of the station. negative means the tuner of the handle is tuned there and can be read
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_add_scan_result(mm_radio_t* radio, int freq, int signal)
+{
+	MMRadioScanResults_t* scan_results = &radio->scan_results;
+	MMRadioStation station;
+	bool tunable = ( signal < 0 );
+
+	if ( signal < 0 )
+	{
+		struct v4l2_tuner vt;
+
+		memset(&vt, 0, sizeof(struct v4l2_tuner));
+		vt.index = radio->tuner_index;
+		signal = ( MMRADIO_TUNER_OP(radio, get_tuner, &vt) == 0 ) ? (int)vt.signal : 0;
+	}
+
+	memset(&station, 0, sizeof(MMRadioStation));
+	station.frequency = freq;
+	station.rssi = signal;
+	station.last_seen = (long long)time(NULL);
+	station.pi = -1;
+
+	if ( scan_results->dedup_window <= 0 )
+	{
+		__mmradio_commit_scan_result(radio, &station);
+		return;
+	}
+
+	/* resumed scan finds the neighbors of the station it stopped after. it's the strongest of them */
+	if ( ! scan_results->pending.frequency && ! scan_results->checking_known && scan_results->checkpoint &&
+		abs(freq - scan_results->checkpoint) <= scan_results->dedup_window )
+	{
+		MMRADIO_LOG_DEBUG("%d KHz is merged with checkpoint %d KHz\n", freq, scan_results->checkpoint);
+		scan_results->merged++;
+		return;
+	}
+
+	if ( scan_results->pending.frequency &&
+		abs(freq - scan_results->pending.frequency) <= scan_results->dedup_window )
+	{
+		MMRADIO_LOG_DEBUG("%d KHz(%d) is merged with %d KHz(%d)\n", freq, signal,
+			scan_results->pending.frequency, scan_results->pending.rssi);
+
+		scan_results->merged++;
+
+		if ( signal > scan_results->pending.rssi )
+		{
+			scan_results->pending = station;
+			scan_results->pending_tunable = tunable;
+		}
+		return;
+	}
+
+	/* new group. tuner comes back here after confirming last one */
+	__mmradio_flush_scan_candidate(radio, freq);
+
+	scan_results->pending = station;
+	scan_results->pending_tunable = tunable;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_end_scan_results()
+ * Desc   : no more station is added. last group and last batch are posted unless they're discarded.
+ *          it waits for delivery thread. so, it shouldn't be called from the callback.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] discard : true if scan is stopped. stations not posted yet are not posted
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_end_scan_results(mm_radio_t* radio, bool discard)
+{
+	MMRadioScanResults_t* scan_results = &radio->scan_results;
+	pthread_t thread = 0;
+
+	/* last group is over. scan is done with the tuner */
+	if ( discard )
+		scan_results->pending.frequency = 0;
+	else
+		__mmradio_flush_scan_candidate(radio, 0);
+
+	pthread_mutex_lock(&scan_results->lock);
+
+	scan_results->finished = true;
+	if ( discard )
+		scan_results->discard = true;
+
+	/* only one of scan thread and stop_scan joins it */
+	thread = scan_results->thread;
+	scan_results->thread = 0;
+
+	pthread_cond_signal(&scan_results->cond);
+	pthread_mutex_unlock(&scan_results->lock);
+
+	if ( thread )
+		pthread_join(thread, NULL);
+}
+
+void
+_mmradio_free_scan_results(mm_radio_t* radio)
+{
+	_mmradio_end_scan_results(radio, true);
+
+	pthread_mutex_lock(&radio->scan_results.lock);
+	MMRADIO_FREEIF( radio->scan_results.stations );
+	radio->scan_results.capacity = 0;
+	radio->scan_results.num_stations = 0;
+	pthread_mutex_unlock(&radio->scan_results.lock);
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_in_scan_batch_callback()
+ * Desc   : tell if it's called from the callback of MM_MESSAGE_RADIO_SCAN_BATCH.
+ *          scan job joins delivery thread when it's over. so, API called there never waits for the job
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : true if the caller is delivery thread in the callback
+ *---------------------------------------------------------------------------*/
+bool
+_mmradio_in_scan_batch_callback(mm_radio_t* radio)
+{
+	MMRadioScanResults_t* scan_results = &radio->scan_results;
+	bool posting = false;
+
+	pthread_mutex_lock(&scan_results->lock);
+	posting = ( scan_results->posting && pthread_equal(scan_results->posting, pthread_self()) );
+	pthread_mutex_unlock(&scan_results->lock);
+
+	return posting;
+}
+
+static void*
+__mmradio_scan_delivery_thread(void* data)
+{
+	mm_radio_t* radio = (mm_radio_t*)data;
+	MMRadioScanResults_t* scan_results = &radio->scan_results;
+	int batch_size = ( scan_results->batch_size > 0 ) ? scan_results->batch_size : INT_MAX;
+	bool finished = false;
+
+	MMRADIO_LOG_FENTER();
+
+	pthread_mutex_lock(&scan_results->lock);
+
+	while ( ! finished )
+	{
+		MMMessageParamType param = {0,};
+		MMRadioScanBatch batch;
+
+		while ( ! scan_results->finished && scan_results->num_stations - scan_results->delivered < batch_size )
+			pthread_cond_wait(&scan_results->cond, &scan_results->lock);
+
+		if ( scan_results->discard )
+			break;
+
+		finished = scan_results->finished;
+
+		memset(&batch, 0, sizeof(MMRadioScanBatch));
+		batch.stations = scan_results->stations;
+		batch.num_stations = scan_results->num_stations;
+		batch.first_new = scan_results->delivered;
+		batch.finished = finished;
+
+		scan_results->delivered = scan_results->num_stations;
+
+		/* scan goes on while callback is running. array never moves during scan */
+		scan_results->posting = pthread_self();
+		pthread_mutex_unlock(&scan_results->lock);
+
+		param.data = &batch;
+		MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_BATCH, &param);
+
+		pthread_mutex_lock(&scan_results->lock);
+		scan_results->posting = 0;
+	}
+
+	pthread_mutex_unlock(&scan_results->lock);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return NULL;
+}
+
+/* station goes to the array and station database, and it's posted right away unless in batch delivery */
+static void
+__mmradio_commit_scan_result(mm_radio_t* radio, MMRadioStation* station)
+{
+	MMRadioScanResults_t* scan_results = &radio->scan_results;
+	int freq = station->frequency;
+	int i = 0;
+
+	/* stations are committed in order of frequency by band scan */
+	if ( ! scan_results->checking_known && freq > scan_results->checkpoint )
+		scan_results->checkpoint = freq;
+
+	pthread_mutex_lock(&scan_results->lock);
+
+	/* known stations checked first in budgeted scan are found again by band scan */
+	for ( i = 0; i < scan_results->num_stations; i++ )
+	{
+		if ( scan_results->stations[i].frequency == freq )
+		{
+			pthread_mutex_unlock(&scan_results->lock);
+			return;
+		}
+	}
+
+	/* only the count is changed. delivered ones stay where they are */
+	if ( scan_results->num_stations < scan_results->capacity )
+		scan_results->stations[scan_results->num_stations++] = *station;
+
+	if ( scan_results->thread )
+		pthread_cond_signal(&scan_results->cond);
+
+	pthread_mutex_unlock(&scan_results->lock);
+
+	if ( scan_results->batch_size == 0 )
+	{
+		MMMessageParamType param = {0,};
+
+		param.radio_scan.frequency = freq;
+		MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_INFO, &param);
+	}
+
+	if ( radio->station_db.fd >= 0 )
+	{
+		/* last_seen of zero means now in database */
+		station->last_seen = 0;
+		if ( _mmradio_merge_stations(radio, station, 1) != MM_ERROR_NONE )
+			MMRADIO_LOG_ERROR("failed to store station %d KHz\n", freq);
+	}
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_flush_scan_candidate()
+ * Desc   : commit the strongest one of last group. it's confirmed first if dwell is set
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] resume_freq : KHz. tuner is tuned back here after confirming. zero means not
+ * Return : None
+ *---------------------------------------------------------------------------*/
+static void
+__mmradio_flush_scan_candidate(mm_radio_t* radio, int resume_freq)
+{
+	MMRadioScanResults_t* scan_results = &radio->scan_results;
+	MMRadioStation station = scan_results->pending;
+
+	if ( ! station.frequency )
+		return;
+
+	scan_results->pending.frequency = 0;
+
+	/* other tuners keep seeking in parallel scan. tuner of the handle is one of them */
+	if ( scan_results->dedup_dwell > 0 && scan_results->pending_tunable )
+	{
+		if ( ! __mmradio_confirm_station(radio, &station, resume_freq) )
+		{
+			scan_results->merged++;
+			return;
+		}
+	}
+
+	__mmradio_commit_scan_result(radio, &station);
+}
+
+/* stay on the station for dwell and read signal again. false if it's gone or scan is stopped */
+static bool
+__mmradio_confirm_station(mm_radio_t* radio, MMRadioStation* station, int resume_freq)
+{
+	struct v4l2_tuner vt;
+	int threshold = _mmradio_sw_seek_threshold(radio);
+	bool confirmed = false;
+
+	if ( __mmradio_tune_handle_tuner(radio, station->frequency) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to tune to %d KHz : %s\n", station->frequency, strerror(errno));
+		return true;
+	}
+
+	if ( ! _mmradio_wait_cancel(radio->scan_cancel_fd, radio->scan_results.dedup_dwell * 1000) )
+	{
+		memset(&vt, 0, sizeof(struct v4l2_tuner));
+		vt.index = radio->tuner_index;
+		if ( MMRADIO_TUNER_OP(radio, get_tuner, &vt) == 0 )
+		{
+			confirmed = ( (int)vt.signal >= threshold );
+			if ( confirmed )
+				station->rssi = (int)vt.signal;
+		}
+		else
+		{
+			/* can't tell. seek found it anyway */
+			confirmed = true;
+		}
+
+		if ( ! confirmed )
+			MMRADIO_LOG_DEBUG("%d KHz is dropped. signal %d is below %d\n", station->frequency, vt.signal, threshold);
+	}
+
+	/* next seek starts from where it was */
+	if ( resume_freq > 0 && __mmradio_tune_handle_tuner(radio, resume_freq) < 0 )
+		MMRADIO_LOG_ERROR("failed to tune back to %d KHz\n", resume_freq);
+
+	return confirmed;
+}
+
+static int
+__mmradio_tune_handle_tuner(mm_radio_t* radio, int freq)
+{
+	return _mmradio_tune_raw(radio, NULL, freq);
+}
@@ -0,0 +1,335 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static void*	__mmradio_scan_watchdog(void* data);
+static int		__mmradio_budget_tune(mm_radio_t* radio, int freq);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_start_scan_budget()
+ * Desc   : start scan with time budget. budget applies to this scan only
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] budget : time budget and order of scan
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_start_scan_budget(mm_radio_t* radio, const MMRadioScanBudget* budget)
+{
+	MMRadioScanBudget_t* scan_budget = NULL;
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_START_SCAN );
+
+	return_val_if_fail( budget && budget->budget >= 0, MM_ERROR_INVALID_ARGUMENT );
+
+	scan_budget = &radio->scan_budget;
+
+	/* caller holds command lock. last scan has published READY after its last read of the budget */
+	scan_budget->config = *budget;
+	scan_budget->active = true;
+
+	MMRADIO_LOG_DEBUG("scan budget : %d msec, known first : %d\n", budget->budget, budget->known_first);
+
+	ret = _mmradio_start_scan(radio);
+	if ( ret != MM_ERROR_NONE )
+	{
+		memset(&scan_budget->config, 0, sizeof(MMRadioScanBudget));
+		scan_budget->active = false;
+	}
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_begin_scan_budget()
+ * Desc   : called by scan thread when it starts. watchdog is started if budget is set
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_begin_scan_budget(mm_radio_t* radio)
+{
+	MMRadioScanBudget_t* budget = &radio->scan_budget;
+
+	budget->expired = false;
+	budget->done = false;
+	budget->watchdog = 0;
+	budget->begin = _mmradio_get_time_usec();
+	budget->known_total = 0;
+	budget->known_done = 0;
+	budget->band_begin = budget->begin;
+
+	if ( ! budget->active || budget->config.budget <= 0 )
+		return;
+
+	if ( pthread_create(&budget->watchdog, NULL, __mmradio_scan_watchdog, (void*)radio) )
+	{
+		MMRADIO_LOG_ERROR("failed to create thread : scan watchdog. scan isn't limited\n");
+		budget->watchdog = 0;
+	}
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_scan_known_stations()
+ * Desc   : check stations of database before band scan. each one is kept if its signal is over seek threshold.
+ *          tuner is tuned to band_min after it
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_scan_known_stations(mm_radio_t* radio)
+{
+	MMRadioScanBudget_t* budget = &radio->scan_budget;
+	MMRadioStation* stations = NULL;
+	int num_stations = 0;
+	int threshold = _mmradio_sw_seek_threshold(radio);
+	int settle = _mmradio_sw_seek_settle(radio);
+	int i = 0;
+
+	if ( ! budget->active || ! budget->config.known_first )
+		return;
+
+	/* no database. band scan only */
+	if ( _mmradio_get_stations(radio, NULL, 0, &num_stations) != MM_ERROR_NONE || num_stations <= 0 )
+		return;
+
+	stations = (MMRadioStation*)malloc(sizeof(MMRadioStation) * num_stations);
+	if ( ! stations )
+	{
+		MMRADIO_LOG_ERROR("failed to allocate known stations\n");
+		return;
+	}
+
+	/* refresh may have changed it in between */
+	if ( _mmradio_get_stations(radio, stations, num_stations, &num_stations) != MM_ERROR_NONE )
+		num_stations = 0;
+
+	budget->known_total = num_stations;
+
+	MMRADIO_LOG_DEBUG("checking %d known stations\n", num_stations);
+
+	/* they're not in order of band scan. checkpoint stays */
+	radio->scan_results.checking_known = true;
+
+	for ( i = 0; i < budget->known_total && ! radio->stop_scan; i++ )
+	{
+		struct v4l2_tuner vt;
+		int freq = stations[i].frequency;
+
+		if ( __mmradio_budget_tune(radio, freq) < 0 )
+		{
+			MMRADIO_LOG_ERROR("failed to tune to %d KHz : %s\n", freq, strerror(errno));
+			continue;
+		}
+
+		if ( _mmradio_wait_cancel(radio->scan_cancel_fd, settle) )
+			break;
+
+		memset(&vt, 0, sizeof(struct v4l2_tuner));
+		vt.index = radio->tuner_index;
+		if ( MMRADIO_TUNER_OP(radio, get_tuner, &vt) == 0 && (int)vt.signal >= threshold )
+			_mmradio_add_scan_result(radio, freq, (int)vt.signal);
+		else
+			MMRADIO_LOG_DEBUG("known station %d KHz is not on air\n", freq);
+
+		budget->known_done++;
+		_mmradio_post_scan_progress(radio, 0);
+	}
+
+	MMRADIO_FREEIF( stations );
+
+	radio->scan_results.checking_known = false;
+
+	budget->band_begin = _mmradio_get_time_usec();
+
+	/* band scan starts over from the bottom */
+	if ( ! radio->stop_scan && __mmradio_budget_tune(radio, radio->region_setting.band_min) < 0 )
+		MMRADIO_LOG_ERROR("failed to tune to %d KHz\n", radio->region_setting.band_min);
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_post_scan_progress()
+ * Desc   : post MM_MESSAGE_RADIO_SCAN_PROGRESS in budgeted scan.
+ *          remaining time is estimated by time per channel of band scan measured so far
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] freq : KHz. band is scanned up to here. zero while known stations are checked
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_post_scan_progress(mm_radio_t* radio, int freq)
+{
+	MMRadioScanBudget_t* budget = &radio->scan_budget;
+	MMMessageParamType param = {0,};
+	MMRadioScanProgress progress;
+	int spacing = radio->region_setting.channel_spacing;
+	int band_min = radio->region_setting.band_min;
+	int channels = 0;
+	int channels_done = 0;
+	unsigned long long now = _mmradio_get_time_usec();
+	long long remaining = -1;
+
+	if ( ! budget->active || spacing <= 0 )
+		return;
+
+	channels = ( radio->region_setting.band_max - band_min ) / spacing + 1;
+	if ( freq > 0 )
+		channels_done = ( freq - band_min ) / spacing + 1;
+	if ( channels_done > channels )
+		channels_done = channels;
+
+	memset(&progress, 0, sizeof(MMRadioScanProgress));
+	progress.percent = ( budget->known_done + channels_done ) * 100 / ( budget->known_total + channels );
+	progress.elapsed = (int)( ( now - budget->begin ) / 1000 );
+
+	/* channels left at the rate so far. known stations are over by then */
+	if ( channels_done > 0 && now > budget->band_begin )
+		remaining = (long long)( now - budget->band_begin ) * ( channels - channels_done ) / channels_done / 1000;
+
+	/* scan is over by the budget anyway */
+	if ( budget->config.budget > 0 && remaining >= 0 )
+	{
+		long long left = budget->config.budget - progress.elapsed;
+
+		if ( left < 0 )
+			left = 0;
+		if ( remaining > left )
+			remaining = left;
+	}
+
+	progress.remaining = (int)remaining;
+
+	pthread_mutex_lock(&radio->scan_results.lock);
+	progress.num_stations = radio->scan_results.num_stations;
+	pthread_mutex_unlock(&radio->scan_results.lock);
+
+	/* progress is valid only while callback is running */
+	param.data = &progress;
+	MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_PROGRESS, &param);
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_end_scan_budget()
+ * Desc   : called by scan thread when it's over. watchdog is joined, and budget is cleared
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : true if scan is aborted because budget ran out
+ *---------------------------------------------------------------------------*/
+bool
+_mmradio_end_scan_budget(mm_radio_t* radio)
+{
+	MMRadioScanBudget_t* budget = &radio->scan_budget;
+	bool expired = false;
+
+	pthread_mutex_lock(&budget->lock);
+	budget->done = true;
+	pthread_cond_signal(&budget->cond);
+	pthread_mutex_unlock(&budget->lock);
+
+	if ( budget->watchdog )
+	{
+		pthread_join(budget->watchdog, NULL);
+		budget->watchdog = 0;
+	}
+
+	expired = budget->expired;
+
+	memset(&budget->config, 0, sizeof(MMRadioScanBudget));
+	budget->active = false;
+	budget->expired = false;
+
+	return expired;
+}
+
+static void*
+__mmradio_scan_watchdog(void* data)
+{
+	mm_radio_t* radio = (mm_radio_t*)data;
+	MMRadioScanBudget_t* budget = &radio->scan_budget;
+	unsigned long long deadline = budget->begin + (unsigned long long)budget->config.budget * 1000ULL;
+	struct timespec ts;
+	bool expired = false;
+
+	MMRADIO_LOG_FENTER();
+
+	ts.tv_sec = deadline / 1000000ULL;
+	ts.tv_nsec = ( deadline % 1000000ULL ) * 1000;
+
+	pthread_mutex_lock(&budget->lock);
+
+	while ( ! budget->done && ! expired )
+	{
+		if ( pthread_cond_timedwait(&budget->cond, &budget->lock, &ts) == ETIMEDOUT )
+			expired = ! budget->done;
+	}
+
+	/* scan being stopped by user isn't out of budget */
+	if ( expired && radio->stop_scan )
+		expired = false;
+
+	budget->expired = expired;
+
+	pthread_mutex_unlock(&budget->lock);
+
+	if ( expired )
+	{
+		MMRADIO_LOG_DEBUG("scan budget of %d msec ran out\n", budget->config.budget);
+		_mmradio_abort_scan(radio);
+	}
+
+	MMRADIO_LOG_FLEAVE();
+
+	return NULL;
+}
+
+static int
+__mmradio_budget_tune(mm_radio_t* radio, int freq)
+{
+	return _mmradio_tune_raw(radio, NULL, freq);
+}
@@ -0,0 +1,240 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <string.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static void*	__mmradio_job_thread(void* data);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_submit_job()
+ * Desc   : queue a job to tuner worker. worker is started by the first job, and lives until handle is destroyed
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] func : job. it's called with the handle on worker
+ *	    [in] name : name of job for log
+ *	    [out] seq : sequence of job to wait for it. can be NULL
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_submit_job(mm_radio_t* radio, MMRadioJobFunc_t func, const char* name, unsigned int* seq)
+{
+	MMRadioJobWorker_t* worker = &radio->job_worker;
+	MMRadioJob_t* job = NULL;
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	pthread_mutex_lock(&worker->lock);
+
+	if ( worker->count >= MMRADIO_JOB_QUEUE_MAX )
+	{
+		pthread_mutex_unlock(&worker->lock);
+		MMRADIO_LOG_ERROR("too many jobs are queued. %s is refused\n", name);
+		return MM_ERROR_RADIO_NO_FREE_SPACE;
+	}
+
+	if ( ! worker->thread )
+	{
+		worker->stop = false;
+
+		if ( pthread_create(&worker->thread, NULL, __mmradio_job_thread, (void*)radio) )
+		{
+			worker->thread = 0;
+			pthread_mutex_unlock(&worker->lock);
+			MMRADIO_LOG_ERROR("failed to create thread : tuner worker\n");
+			return MM_ERROR_RADIO_INTERNAL;
+		}
+	}
+
+	job = &worker->queue[( worker->head + worker->count ) % MMRADIO_JOB_QUEUE_MAX];
+	job->func = func;
+	job->name = name;
+	job->seq = ++worker->submitted;
+
+	/* zero means no job */
+	if ( ! job->seq )
+		job->seq = ++worker->submitted;
+
+	worker->count++;
+
+	if ( seq )
+		*seq = job->seq;
+
+	pthread_cond_broadcast(&worker->cond);
+	pthread_mutex_unlock(&worker->lock);
+
+	MMRADIO_LOG_DEBUG("%s is queued as job %u\n", name, job->seq);
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_wait_job()
+ * Desc   : wait until the job and the ones queued before it are done.
+ *          it returns right away if it's called by the job itself, or by batch callback of scan job.
+ *          caller holds command lock. it's released while waiting, since message callback of the job can call API.
+ *          so, handle can be changed by others when it returns
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] seq : sequence of the job. zero for all the jobs queued so far
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_wait_job(mm_radio_t* radio, unsigned int seq)
+{
+	MMRadioJobWorker_t* worker = &radio->job_worker;
+
+	/* scan job waits for batch delivery before it's done */
+	if ( _mmradio_in_scan_batch_callback(radio) )
+		return;
+
+	pthread_mutex_lock(&worker->lock);
+
+	/* message callback of a job can call API */
+	if ( worker->thread && pthread_equal(worker->thread, pthread_self()) )
+	{
+		pthread_mutex_unlock(&worker->lock);
+		return;
+	}
+
+	if ( ! seq )
+		seq = worker->submitted;
+
+	/* sequences wrap around. distance tells which one is later */
+	if ( ! worker->thread || (int)( seq - worker->done ) <= 0 )
+	{
+		pthread_mutex_unlock(&worker->lock);
+		return;
+	}
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	while ( worker->thread && (int)( seq - worker->done ) > 0 )
+		pthread_cond_wait(&worker->cond, &worker->lock);
+
+	pthread_mutex_unlock(&worker->lock);
+
+	/* worker lock is released first. callback of a job takes command lock */
+	MMRADIO_CMD_LOCK( radio );
+}
+
+/* true if a job is running or queued */
+bool
+_mmradio_job_busy(mm_radio_t* radio)
+{
+	MMRadioJobWorker_t* worker = &radio->job_worker;
+	bool busy = false;
+
+	pthread_mutex_lock(&worker->lock);
+	busy = ( worker->done != worker->submitted );
+	pthread_mutex_unlock(&worker->lock);
+
+	return busy;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_stop_job_worker()
+ * Desc   : stop tuner worker after the running job. queued jobs are dropped
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_stop_job_worker(mm_radio_t* radio)
+{
+	MMRadioJobWorker_t* worker = &radio->job_worker;
+	pthread_t thread = 0;
+
+	pthread_mutex_lock(&worker->lock);
+	worker->stop = true;
+	thread = worker->thread;
+	pthread_cond_broadcast(&worker->cond);
+	pthread_mutex_unlock(&worker->lock);
+
+	if ( ! thread )
+		return;
+
+	pthread_join(thread, NULL);
+
+	pthread_mutex_lock(&worker->lock);
+	worker->thread = 0;
+	worker->count = 0;
+	worker->done = worker->submitted;
+	pthread_cond_broadcast(&worker->cond);
+	pthread_mutex_unlock(&worker->lock);
+}
+
+static void*
+__mmradio_job_thread(void* data)
+{
+	mm_radio_t* radio = (mm_radio_t*)data;
+	MMRadioJobWorker_t* worker = &radio->job_worker;
+
+	MMRADIO_LOG_FENTER();
+
+	pthread_mutex_lock(&worker->lock);
+
+	while ( ! worker->stop )
+	{
+		MMRadioJob_t job;
+
+		if ( ! worker->count )
+		{
+			pthread_cond_wait(&worker->cond, &worker->lock);
+			continue;
+		}
+
+		job = worker->queue[worker->head];
+		worker->head = ( worker->head + 1 ) % MMRADIO_JOB_QUEUE_MAX;
+		worker->count--;
+
+		pthread_mutex_unlock(&worker->lock);
+
+		MMRADIO_LOG_DEBUG("running job %u : %s\n", job.seq, job.name);
+		job.func((void*)radio);
+
+		pthread_mutex_lock(&worker->lock);
+
+		worker->done = job.seq;
+		pthread_cond_broadcast(&worker->cond);
+	}
+
+	pthread_mutex_unlock(&worker->lock);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return NULL;
+}
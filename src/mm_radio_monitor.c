@@ -0,0 +1,328 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL #defines:
+---------------------------------------------------------------------------*/
+#define MONITOR_MIN_INTERVAL		250		/* msec */
+#define MONITOR_MAX_INTERVAL		4000	/* msec */
+#define MONITOR_EVENT_INTERVAL		10000	/* msec. just in case of missing event */
+#ifdef V4L2_CID_RF_TUNER_PLL_LOCK
+#define MONITOR_EVENT_CTRL			V4L2_CID_RF_TUNER_PLL_LOCK
+#endif
+#define MONITOR_DEFAULT_HYSTERESIS	2048
+
+/*---------------------------------------------------------------------------
+    LOCAL DATA TYPE DEFINITIONS:
+---------------------------------------------------------------------------*/
+/* owned by monitor thread. it outlives the handle fields when it's stopped in its callback */
+typedef struct {
+	mm_radio_t* radio;
+	int wakeup;			/* read end of wakeup pipe. closed by monitor thread */
+	bool subscribed;	/* control event is subscribed. device is polled for it */
+	bool event;			/* events arrive and follow signal. no need to poll tuner frequently */
+} MMRadioMonitor_t;
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static void*	__mmradio_monitor_thread(void* data);
+static bool	__mmradio_monitor_subscribe(mm_radio_t* radio);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_start_signal_monitor()
+ * Desc   : start monitoring signal strength.
+ *          MM_MESSAGE_RADIO_SIGNAL is posted only when signal changes more than hysteresis.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] hysteresis : minimum change of signal to be notified. zero or negative means default.
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_start_signal_monitor(mm_radio_t* radio, int hysteresis)
+{
+	MMRadioMonitor_t* monitor = NULL;
+	int wakeup[2] = { -1, -1 };
+	int ret = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SIGNAL_MONITOR );
+	MMRADIO_CHECK_DEVICE_STATE( radio );
+
+	radio->monitor_hysteresis = ( hysteresis > 0 ) ? hysteresis : MONITOR_DEFAULT_HYSTERESIS;
+
+	/* already running. just hysteresis is updated */
+	if ( radio->monitor_thread )
+	{
+		MMRADIO_LOG_DEBUG("signal monitor is running already\n");
+		return MM_ERROR_NONE;
+	}
+
+	monitor = (MMRadioMonitor_t*)malloc(sizeof(MMRadioMonitor_t));
+	if ( ! monitor )
+	{
+		MMRADIO_LOG_ERROR("failed to allocate monitor\n");
+		return MM_ERROR_RADIO_NO_FREE_SPACE;
+	}
+
+	if ( pipe(wakeup) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to create pipe : %s\n", strerror(errno));
+		free(monitor);
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	monitor->radio = radio;
+	monitor->wakeup = wakeup[0];
+	monitor->subscribed = __mmradio_monitor_subscribe(radio);
+	monitor->event = false;
+
+	MMRADIO_LOG_DEBUG("monitoring signal by sampling%s\n", monitor->subscribed ? " until event arrives" : "");
+
+	ret = pthread_create(&radio->monitor_thread, NULL, __mmradio_monitor_thread, (void*)monitor);
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("failed to create thread : monitor\n");
+		close(wakeup[0]);
+		close(wakeup[1]);
+		free(monitor);
+		radio->monitor_thread = 0;
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	radio->monitor_wakeup = wakeup[1];
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_stop_signal_monitor()
+ * Desc   : stop monitoring signal strength. it's called before closing device.
+ *          caller should hold command lock. it's released while waiting for monitor thread
+ *          since callback of MM_MESSAGE_RADIO_SIGNAL can call API.
+ *          in the callback, monitor thread is detached and it leaves after the callback.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_stop_signal_monitor(mm_radio_t* radio)
+{
+	pthread_t thread = 0;
+	char wakeup = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	if ( ! radio->monitor_thread )
+		return MM_ERROR_NONE;
+
+	/* monitor is taken from handle. next start makes new one */
+	thread = radio->monitor_thread;
+	radio->monitor_thread = 0;
+
+	if ( write(radio->monitor_wakeup, &wakeup, 1) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to wake up monitor : %s\n", strerror(errno));
+	}
+
+	/* read end is closed by monitor thread. it also sees hang-up */
+	close(radio->monitor_wakeup);
+	radio->monitor_wakeup = -1;
+
+	if ( pthread_equal(thread, pthread_self()) )
+	{
+		pthread_detach(thread);
+	}
+	else
+	{
+		MMRADIO_CMD_UNLOCK( radio );
+		pthread_join(thread, NULL);
+		MMRADIO_CMD_LOCK( radio );
+	}
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* V4L2 has no control for signal strength. PLL lock of RF tuner is the closest one drivers update.
+ * subscribing doesn't mean the driver sends it. monitor keeps sampling until events arrive
+ */
+static bool
+__mmradio_monitor_subscribe(mm_radio_t* radio)
+{
+#ifdef MONITOR_EVENT_CTRL
+	struct v4l2_event_subscription sub = {0,};
+
+	sub.type = V4L2_EVENT_CTRL;
+	sub.id = MONITOR_EVENT_CTRL;
+
+	if ( MMRADIO_TUNER_OP(radio, subscribe_event, &sub) == 0 )
+		return true;
+
+	MMRADIO_LOG_DEBUG("event is not supported : %s\n", strerror(errno));
+#endif
+	return false;
+}
+
+static void*
+__mmradio_monitor_thread(void* data)
+{
+	MMRadioMonitor_t* monitor = (MMRadioMonitor_t*)data;
+	mm_radio_t* radio = monitor->radio;
+	int interval = MONITOR_MIN_INTERVAL;
+	int posted = -1;
+	bool first = true;
+	bool stop = false;
+
+	MMRADIO_LOG_FENTER();
+
+	while ( ! stop )
+	{
+		struct pollfd fds[2];
+		int nfds = 1;
+		int signal = 0;
+		int ret = 0;
+		bool timeout = false;
+
+		/* first one is read right away and posted as initial value */
+		if ( ! first )
+		{
+			fds[0].fd = monitor->wakeup;
+			fds[0].events = POLLIN;
+			fds[0].revents = 0;
+
+			if ( monitor->subscribed )
+			{
+				fds[1].fd = radio->radio_fd;
+				fds[1].events = POLLPRI;
+				fds[1].revents = 0;
+				nfds = 2;
+			}
+
+			ret = poll(fds, nfds, interval);
+			if ( ret < 0 )
+			{
+				if ( errno == EINTR )
+					continue;
+
+				MMRADIO_LOG_ERROR("failed to poll : %s\n", strerror(errno));
+				break;
+			}
+
+			if ( fds[0].revents )
+			{
+				stop = true;
+				continue;
+			}
+
+			timeout = ( ret == 0 );
+
+			/* consume all pending events. we just need to know something is changed */
+			if ( nfds > 1 && ( fds[1].revents & POLLPRI ) )
+			{
+				struct v4l2_event ev;
+				int events = 0;
+
+				do {
+					memset(&ev, 0, sizeof(ev));
+					if ( MMRADIO_TUNER_OP(radio, dequeue_event, &ev) < 0 )
+						break;
+					events++;
+				} while ( ev.pending > 0 );
+
+				/* driver does send it. tuner is read when it comes */
+				if ( events > 0 && ! monitor->event )
+				{
+					MMRADIO_LOG_DEBUG("event arrives. monitoring signal by event\n");
+					monitor->event = true;
+					interval = MONITOR_EVENT_INTERVAL;
+				}
+			}
+		}
+
+		first = false;
+
+		if ( _mmradio_get_signal_strength(radio, &signal) != MM_ERROR_NONE )
+			continue;
+
+		/* signal moved without event. events of the driver don't follow signal */
+		if ( monitor->event && timeout && posted >= 0 && abs(signal - posted) >= radio->monitor_hysteresis )
+		{
+			MMRADIO_LOG_DEBUG("signal is changed without event. monitoring signal by sampling\n");
+			monitor->event = false;
+			interval = MONITOR_MIN_INTERVAL;
+		}
+
+		if ( posted < 0 || abs(signal - posted) >= radio->monitor_hysteresis )
+		{
+			MMMessageParamType param = {0,};
+
+			param.union_type = MM_MSG_UNION_CODE;
+			param.code = signal;
+			MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SIGNAL, &param);
+
+			posted = signal;
+
+			/* signal is moving. watch it closely */
+			if ( ! monitor->event )
+				interval = MONITOR_MIN_INTERVAL;
+		}
+		else if ( ! monitor->event )
+		{
+			/* signal is stable. check it less frequently */
+			interval *= 2;
+			if ( interval > MONITOR_MAX_INTERVAL )
+				interval = MONITOR_MAX_INTERVAL;
+		}
+	}
+
+	close(monitor->wakeup);
+	free(monitor);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return NULL;
+}
@@ -0,0 +1,223 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <errno.h>
+#include <time.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL #defines:
+---------------------------------------------------------------------------*/
+#define PARK_RETRY_INTERVAL		10		/* msec. when command lock is busy at expiry */
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static void*	__mmradio_park_thread(void* data);
+static void	__mmradio_get_deadline(struct timespec* ts, int msec);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_keep_warm()
+ * Desc   : set grace period for keeping device and pipeline after unrealize
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] grace : grace period, msec. zero disables keep-warm.
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_keep_warm(mm_radio_t* radio, int grace)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	radio->keep_warm = ( grace > 0 ) ? grace : 0;
+
+	MMRADIO_LOG_DEBUG("keep-warm grace period : %d msec\n", radio->keep_warm);
+
+	/* parked one is released right now if it's disabled */
+	if ( ! radio->keep_warm )
+		_mmradio_unpark(radio, true);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_park()
+ * Desc   : keep opened device and pipeline, and start grace timer.
+ *          device is closed when the timer expires. caller should hold command lock.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_park(mm_radio_t* radio)
+{
+	int ret = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	if ( radio->parked )
+		return MM_ERROR_NONE;
+
+	radio->unpark = false;
+	radio->parked = true;
+
+	ret = pthread_create(&radio->park_thread, NULL, __mmradio_park_thread, (void*)radio);
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("failed to create thread : park\n");
+		radio->park_thread = 0;
+		radio->parked = false;
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	MMRADIO_LOG_DEBUG("parked for %d msec\n", radio->keep_warm);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_unpark()
+ * Desc   : stop grace timer. parked device is closed or given back to caller.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] teardown : close parked device and destroy pipeline
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_unpark(mm_radio_t* radio, bool teardown)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	/* timer thread can be finished already by expiry. it should be collected also */
+	if ( radio->park_thread )
+	{
+		pthread_mutex_lock(&radio->park_lock);
+		radio->unpark = true;
+		pthread_cond_signal(&radio->park_cond);
+		pthread_mutex_unlock(&radio->park_lock);
+
+		pthread_join(radio->park_thread, NULL);
+		radio->park_thread = 0;
+	}
+
+	if ( ! radio->parked )
+		return MM_ERROR_NONE;
+
+	radio->parked = false;
+
+	if ( teardown )
+	{
+		MMRADIO_LOG_DEBUG("releasing parked device\n");
+		return _mmradio_close_device(radio);
+	}
+
+	MMRADIO_LOG_DEBUG("reusing parked device\n");
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+static void
+__mmradio_get_deadline(struct timespec* ts, int msec)
+{
+	clock_gettime(CLOCK_MONOTONIC, ts);
+
+	ts->tv_sec += msec / 1000;
+	ts->tv_nsec += (msec % 1000) * 1000000L;
+
+	if ( ts->tv_nsec >= 1000000000L )
+	{
+		ts->tv_sec++;
+		ts->tv_nsec -= 1000000000L;
+	}
+}
+
+static void*
+__mmradio_park_thread(void* data)
+{
+	mm_radio_t* radio = (mm_radio_t*)data;
+	struct timespec deadline;
+	bool expired = false;
+
+	MMRADIO_LOG_FENTER();
+
+	__mmradio_get_deadline(&deadline, radio->keep_warm);
+
+	pthread_mutex_lock(&radio->park_lock);
+
+	while ( ! radio->unpark )
+	{
+		if ( pthread_cond_timedwait(&radio->park_cond, &radio->park_lock, &deadline) != ETIMEDOUT )
+			continue;
+
+		/* command holding the lock may unpark it and wait for this thread.
+		 * so, never block on command lock here.
+		 */
+		if ( pthread_mutex_trylock(&radio->cmd_lock) == 0 )
+		{
+			expired = true;
+			break;
+		}
+
+		__mmradio_get_deadline(&deadline, PARK_RETRY_INTERVAL);
+	}
+
+	pthread_mutex_unlock(&radio->park_lock);
+
+	if ( expired )
+	{
+		if ( radio->parked )
+		{
+			MMRADIO_LOG_DEBUG("grace period is expired. closing device\n");
+
+			radio->parked = false;
+			_mmradio_close_device(radio);
+		}
+
+		MMRADIO_CMD_UNLOCK( radio );
+	}
+
+	MMRADIO_LOG_FLEAVE();
+
+	return NULL;
+}
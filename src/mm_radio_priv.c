@@ -30,9 +30,11 @@
 #include <string.h>
 #include <math.h>
 #include <fcntl.h>
-#include <sys/ioctl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <mm_sound.h>
 #include <mm_ta.h>
 
@@ -61,17 +63,26 @@
     LOCAL #defines:
 ---------------------------------------------------------------------------*/
 #define DEFAULT_DEVICE				"/dev/radio0"
-#define TUNER_INDEX				0
+#define DEFAULT_TUNER_INDEX			0
 
 #define DEFAULT_FREQ				107700
 
-#define FREQ_FRAC				16
-#define RADIO_FREQ_FORMAT_SET(x_freq)		((x_freq) * FREQ_FRAC)
-#define RADIO_FREQ_FORMAT_GET(x_freq)		((x_freq) / FREQ_FRAC)
+/* frequency unit of tuner is 0.1Hz unit here. KHz is 10000 of it */
+#define FREQ_UNIT_1HZ				10
+#define FREQ_UNIT_LOW				625		/* 62.5Hz. V4L2_TUNER_CAP_LOW */
+#define FREQ_UNIT_HIGH				625000	/* 62.5KHz */
 #define DEFAULT_WRAP_AROUND 			1 //If non-zero, wrap around when at the end of the frequency range, else stop seeking
 
 #define RADIO_DEFAULT_REGION			MM_RADIO_REGION_GROUP_USA
 
+#define SHADOW_DEFAULT_MAX_AGE			200		/* msec. for mm_radio_get_frequency() and mm_radio_get_signal_strength() */
+
+/* hardware seek fails with EAGAIN if tuner is busy or nothing is found in time */
+#define SEEK_RETRY_MAX					4
+#define SEEK_RETRY_INITIAL_BACKOFF		20		/* msec */
+#define SEEK_RETRY_MAX_BACKOFF			320		/* msec */
+#define SEEK_RETRY_DEADLINE				3000	/* msec */
+
 /*---------------------------------------------------------------------------
     LOCAL CONSTANT DEFINITIONS:
 ---------------------------------------------------------------------------*/
@@ -96,33 +107,74 @@ static const MMRadioRegion_t region_table[] =
 			MM_RADIO_DEEMPHASIS_75_US,	// de-emphasis
 			MM_RADIO_FREQ_MIN_87500_KHZ, 	// min freq.
 			MM_RADIO_FREQ_MAX_108000_KHZ,	// max freq.
+			200,						// channel spacing
 		},
 		{	/* China, Europe, Africa, Middle East, Hong Kong, India, Indonesia, Russia, Singapore */
 			MM_RADIO_REGION_GROUP_EUROPE,
 			MM_RADIO_DEEMPHASIS_50_US,
 			MM_RADIO_FREQ_MIN_87500_KHZ,
 			MM_RADIO_FREQ_MAX_108000_KHZ,
+			100,
 		},
 		{
 			MM_RADIO_REGION_GROUP_JAPAN,
 			MM_RADIO_DEEMPHASIS_50_US,
 			MM_RADIO_FREQ_MIN_76100_KHZ,
 			MM_RADIO_FREQ_MAX_89900_KHZ,
+			100,
 		},
 };
+
+/* retry of hardware seek. shared by seek and scan */
+static const MMRadioRetryPolicy_t seek_retry_policy =
+{
+		SEEK_RETRY_MAX,
+		SEEK_RETRY_INITIAL_BACKOFF,
+		SEEK_RETRY_MAX_BACKOFF,
+		SEEK_RETRY_DEADLINE,
+};
+
+/* seek thresholds of profiles. indexed by MMRadioSeekProfileType. from si470x programming guide */
+static const MMRadioSeekThreshold seek_profile_table[] =
+{
+		{ 0, 0, 0 },		/* DEFAULT. not used */
+		{ 0x0c, 0, 0 },		/* FAST. RSSI only */
+		{ 0x19, 4, 8 },		/* NORMAL. recommended */
+		{ 0x0c, 7, 15 },	/* STRICT. good quality stations only */
+};
 /*---------------------------------------------------------------------------
     LOCAL FUNCTION PROTOTYPES:
 ---------------------------------------------------------------------------*/
-static bool	__mmradio_post_message(mm_radio_t* radio, enum MMMessageType msgtype, MMMessageParamType* param);
-static int  		__mmradio_check_state(mm_radio_t* radio, MMRadioCommand command);
 static int		__mmradio_get_state(mm_radio_t* radio);
 static bool	__mmradio_set_state(mm_radio_t* radio, int new_state);
 static void 	__mmradio_seek_thread(mm_radio_t* radio);
+static int		__mmradio_realize(mm_radio_t* radio);
+static bool		__mmradio_realize_canceled(mm_radio_t* radio);
+static void*	__mmradio_realize_thread(void* data);
 static void	__mmradio_scan_thread(mm_radio_t* radio);
+static void	__mmradio_reset_scan_cancel(mm_radio_t* radio);
 ASM_cb_result_t	__mmradio_asm_callback(int handle, ASM_event_sources_t sound_event, ASM_sound_commands_t command, unsigned int sound_status, void* cb_data);
+static void	__mmradio_asm_stop(mm_radio_t* radio, ASM_event_sources_t event_source);
+static void	__mmradio_asm_stop_job(mm_radio_t* radio);
+static void	__mmradio_defer_asm_stop(mm_radio_t* radio, ASM_event_sources_t event_source);
 static bool 	__is_tunable_frequency(mm_radio_t* radio, int freq);
-static int 		__mmradio_set_deemphasis(mm_radio_t* radio);
-static int 		__mmradio_set_band_range(mm_radio_t* radio);
+static bool		__mmradio_is_top_station(mm_radio_t* radio, int freq);
+static int		__mmradio_get_deemphasis_value(MMRadioDeemphasis deemphasis);
+static int		__mmradio_apply_settings(mm_radio_t* radio);
+static void		__mmradio_set_applied_ctrl(mm_radio_t* radio, unsigned int id, int value);
+static void		__mmradio_invalidate_settings(mm_radio_t* radio);
+static void		__mmradio_set_seek_raster(mm_radio_t* radio, struct v4l2_hw_freq_seek* vs);
+static void		__mmradio_apply_seek_threshold(mm_radio_t* radio);
+static int		__mmradio_seek_once(mm_radio_t* radio, struct v4l2_hw_freq_seek* vs);
+static void		__mmradio_post_seek_result(mm_radio_t* radio, int freq, MMRadioRetry_t* retry, unsigned long long begin);
+static void		__mmradio_get_scan_result(mm_radio_t* radio, MMRadioScanResult* result, int num_stations, MMRadioRetry_t* retry, unsigned long long begin, int error, bool out_of_budget);
+static void		__mmradio_post_scan_result(mm_radio_t* radio, MMRadioScanResult* result);
+static void		__mmradio_query_bands(mm_radio_t* radio);
+static int		__mmradio_get_raster_max(mm_radio_t* radio);
+static int		__mmradio_snap_frequency(mm_radio_t* radio, int freq);
+static void		__mmradio_update_shadow_freq(mm_radio_t* radio, int freq);
+static void		__mmradio_update_shadow_signal(mm_radio_t* radio, int signal);
+static void		__mmradio_invalidate_shadow(mm_radio_t* radio);
 
 /*===========================================================================
   FUNCTION DEFINITIONS
@@ -142,7 +194,7 @@ _mmradio_apply_region(mm_radio_t* radio, MMRadioRegionType region, bool update)
 	int ret = MM_ERROR_NONE;
 	int count = 0;
 	int index = 0;
-	int i =0;
+	int value = 0;
 
 	MMRADIO_LOG_FENTER();
 
@@ -168,10 +220,36 @@ _mmradio_apply_region(mm_radio_t* radio, MMRadioRegionType region, bool update)
 				radio->region_setting.deemphasis = region_table[index].deemphasis;
 				radio->region_setting.band_min = region_table[index].band_min;
 				radio->region_setting.band_max = region_table[index].band_max;
+				radio->region_setting.channel_spacing = region_table[index].channel_spacing;
 			}
 		}
 	}
 
+	/* tuner may not cover whole band of the region */
+	if ( radio->radio_fd >= 0 && radio->hw_band_min > 0 && radio->hw_band_max > 0 )
+	{
+		if ( radio->region_setting.band_min < radio->hw_band_min )
+		{
+			int spacing = radio->region_setting.channel_spacing;
+			int band_min = radio->hw_band_min;
+
+			/* keep raster of the region */
+			if ( spacing > 0 )
+				band_min += ( spacing - ( band_min - radio->region_setting.band_min ) % spacing ) % spacing;
+
+			radio->region_setting.band_min = band_min;
+		}
+
+		if ( radio->region_setting.band_max > radio->hw_band_max )
+			radio->region_setting.band_max = radio->hw_band_max;
+
+		if ( radio->region_setting.band_min >= radio->region_setting.band_max )
+		{
+			MMRADIO_LOG_ERROR("tuner(%d ~ %d KHz) can't support the region\n", radio->hw_band_min, radio->hw_band_max);
+			return MM_ERROR_COMMON_INVALID_ARGUMENT;
+		}
+	}
+
 	/* chech device is opened or not. if it's not ready, skip to apply region to device now*/
 	if (radio->radio_fd < 0)
 	{
@@ -179,18 +257,25 @@ _mmradio_apply_region(mm_radio_t* radio, MMRadioRegionType region, bool update)
 		return MM_ERROR_NONE;
 	}
 
-	MMRADIO_LOG_DEBUG("setting region - country: %d, de-emphasis: %d, band range: %d ~ %d KHz\n",
-		radio->region_setting.country, radio->region_setting.deemphasis, radio->region_setting.band_min, radio->region_setting.band_max);
+	MMRADIO_LOG_DEBUG("setting region - country: %d, de-emphasis: %d, band range: %d ~ %d KHz, spacing: %d KHz\n",
+		radio->region_setting.country, radio->region_setting.deemphasis, radio->region_setting.band_min, radio->region_setting.band_max,
+		radio->region_setting.channel_spacing);
 
-	/* set de-emphsasis to device */
-	ret = __mmradio_set_deemphasis(radio);
+	value = __mmradio_get_deemphasis_value(radio->region_setting.deemphasis);
+	if ( value < 0 )
+	{
+		MMRADIO_LOG_ERROR("not availabe de-emphasis value\n");
+		return MM_ERROR_COMMON_INVALID_ARGUMENT;
+	}
 
-	MMRADIO_CHECK_RETURN_IF_FAIL(ret, "set de-emphasis");
+	/* de-emphasis and band range are applied at once */
+	radio->settings.deemphasis = value;
+	radio->settings.rangelow = RADIO_FREQ_FORMAT_SET(radio, radio->region_setting.band_min);
+	radio->settings.rangehigh = RADIO_FREQ_FORMAT_SET(radio, radio->region_setting.band_max);
 
-	/* set band range to device */
-	ret  = __mmradio_set_band_range(radio);
+	ret = __mmradio_apply_settings(radio);
 
-	MMRADIO_CHECK_RETURN_IF_FAIL(ret, "set band range");
+	MMRADIO_CHECK_RETURN_IF_FAIL(ret, "apply region");
 
 	MMRADIO_LOG_FLEAVE();
 
@@ -209,8 +294,27 @@ _mmradio_create_radio(mm_radio_t* radio)
 
 	/* set default value */
 	radio->radio_fd = -1;
+	strncpy(radio->device, DEFAULT_DEVICE, sizeof(radio->device) - 1);
+	radio->tuner_index = DEFAULT_TUNER_INDEX;
+	radio->freq_unit = FREQ_UNIT_LOW;
+	radio->monitor_wakeup = -1;
+	radio->sampler_wakeup[0] = radio->sampler_wakeup[1] = -1;
+	radio->station_db.fd = -1;
+	radio->refresh_wakeup[0] = radio->refresh_wakeup[1] = -1;
+	radio->scan_cancel_fd = -1;
 	radio->freq = DEFAULT_FREQ;
 	memset(&radio->region_setting, 0, sizeof(MMRadioRegion_t));
+	memset(&radio->settings, 0, sizeof(MMRadioSettings_t));
+	__mmradio_invalidate_settings(radio);
+
+	/* radio device is default tuner backend */
+	radio->backend = &mmradio_backend_v4l2;
+	radio->backend_priv = radio->backend->create(NULL);
+	if ( ! radio->backend_priv )
+	{
+		MMRADIO_LOG_ERROR("failed to create tuner backend\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
 
 	/* create command lock */
 	ret = pthread_mutex_init( &radio->cmd_lock, NULL );
@@ -220,6 +324,142 @@ _mmradio_create_radio(mm_radio_t* radio)
 		return MM_ERROR_RADIO_INTERNAL;
 	}
 
+	/* create shadow lock */
+	ret = pthread_mutex_init( &radio->shadow_lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	/* create lock and condition for keep-warm timer. timer uses monotonic clock */
+	ret = pthread_mutex_init( &radio->park_lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	{
+		pthread_condattr_t attr;
+
+		pthread_condattr_init( &attr );
+		pthread_condattr_setclock( &attr, CLOCK_MONOTONIC );
+		ret = pthread_cond_init( &radio->park_cond, &attr );
+		pthread_condattr_destroy( &attr );
+		if ( ret )
+		{
+			MMRADIO_LOG_ERROR("condition creation failed\n");
+			return MM_ERROR_RADIO_INTERNAL;
+		}
+	}
+
+	/* create mailbox of coalescing tune */
+	ret = pthread_mutex_init( &radio->tune_lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	ret = pthread_mutex_init( &radio->tune_mode_lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	/* create lock of statistics */
+	ret = pthread_mutex_init( &radio->stats_lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	ret = pthread_cond_init( &radio->tune_cond, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("condition creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	/* create lock of asynchronous realize */
+	ret = pthread_mutex_init( &radio->realize_lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	/* create station database lock */
+	ret = pthread_mutex_init( &radio->station_db.lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	/* create cancellation event of scan. scan thread polls it */
+	radio->scan_cancel_fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	if ( radio->scan_cancel_fd < 0 )
+	{
+		MMRADIO_LOG_ERROR("eventfd creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	/* create lock and condition of scan results */
+	ret = pthread_mutex_init( &radio->scan_results.lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	ret = pthread_cond_init( &radio->scan_results.cond, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("condition creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	/* create lock and condition of tuner worker. worker is started by the first job */
+	ret = pthread_mutex_init( &radio->job_worker.lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	ret = pthread_cond_init( &radio->job_worker.cond, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("condition creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	/* create lock and condition for watchdog of scan budget. it uses monotonic clock */
+	ret = pthread_mutex_init( &radio->scan_budget.lock, NULL );
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("mutex creation failed\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	{
+		pthread_condattr_t attr;
+
+		pthread_condattr_init( &attr );
+		pthread_condattr_setclock( &attr, CLOCK_MONOTONIC );
+		ret = pthread_cond_init( &radio->scan_budget.cond, &attr );
+		pthread_condattr_destroy( &attr );
+		if ( ret )
+		{
+			MMRADIO_LOG_ERROR("condition creation failed\n");
+			return MM_ERROR_RADIO_INTERNAL;
+		}
+	}
+
 	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_NULL );
 
 	/* register to ASM */
@@ -238,14 +478,45 @@ _mmradio_create_radio(mm_radio_t* radio)
 
 int
 _mmradio_realize(mm_radio_t* radio)
+{
+	bool running = false;
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	/* worker may not have taken command lock yet */
+	pthread_mutex_lock( &radio->realize_lock );
+	running = radio->realize_running;
+	pthread_mutex_unlock( &radio->realize_lock );
+
+	if ( running )
+	{
+		MMRADIO_LOG_ERROR("asynchronous realize is in progress\n");
+		return MM_ERROR_RADIO_INVALID_STATE;
+	}
+
+	return __mmradio_realize( radio );
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_realize
+ * Desc   : open device and apply settings. caller should hold command lock.
+ *          asynchronous realize is canceled between the steps.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+static int
+__mmradio_realize(mm_radio_t* radio)
 {
 	int ret = MM_ERROR_NONE;
 
 	MMRADIO_LOG_FENTER();
 
-	MMRADIO_CHECK_INSTANCE( radio );
 	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_REALIZE );
 
+	/* device and pipeline are still alive if it's parked */
+	_mmradio_unpark(radio, false);
+
 	/* open radio device */
 	if(radio->radio_fd == -1)
 	{
@@ -253,11 +524,11 @@ _mmradio_realize(mm_radio_t* radio)
 		bool update = false;
 
 		/* open device */
-		radio->radio_fd = open(DEFAULT_DEVICE, O_RDONLY);
+		radio->radio_fd = MMRADIO_TIMED(radio, MMRADIO_STAT_TUNER_OP(open), radio->backend->open(radio->backend_priv, radio->device));
 		if (radio->radio_fd < 0)
 		{
 			MMRADIO_LOG_ERROR("failed to open radio device[%s] because of %s(%d)\n",
-						DEFAULT_DEVICE, strerror(errno), errno);
+						radio->device, strerror(errno), errno);
 			
 			/* check error */
 			switch (errno)
@@ -273,7 +544,7 @@ _mmradio_realize(mm_radio_t* radio)
 		MMRADIO_LOG_DEBUG("radio device fd : %d\n", radio->radio_fd);
 
 		/* query radio device capabilities. */
-		if (ioctl(radio->radio_fd, VIDIOC_QUERYCAP, &(radio->vc)) < 0)
+		if (MMRADIO_TUNER_OP(radio, query_cap, &(radio->vc)) < 0)
 		{
 			MMRADIO_LOG_ERROR("VIDIOC_QUERYCAP failed!\n");
 			goto error;
@@ -285,22 +556,32 @@ _mmradio_realize(mm_radio_t* radio)
 			goto error;
 		}
 
-		/* set tuner audio mode */
-		ioctl(radio->radio_fd, VIDIOC_G_TUNER, &(radio->vt));
+		if ( __mmradio_realize_canceled(radio) )
+			goto cancel;
+
+		/* get tuner audio mode. it's applied together with region settings */
+		(radio->vt).index = radio->tuner_index;
+		if (MMRADIO_TUNER_OP(radio, get_tuner, &(radio->vt)) < 0)
+		{
+			MMRADIO_LOG_ERROR("tuner %d of %s is not available\n", radio->tuner_index, radio->device);
+			goto error;
+		}
+
+		/* frequency unit and supported bands */
+		__mmradio_query_bands(radio);
 
 		if ( ! ( (radio->vt).capability & V4L2_TUNER_CAP_STEREO) )
 		{
 			MMRADIO_LOG_ERROR("this system can support mono!\n");
-			(radio->vt).audmode = V4L2_TUNER_MODE_MONO;
+			radio->settings.audmode = V4L2_TUNER_MODE_MONO;
 		}
 		else
 		{
-			(radio->vt).audmode = V4L2_TUNER_MODE_STEREO;
+			radio->settings.audmode = V4L2_TUNER_MODE_STEREO;
 		}
 
-		/* set tuner index. Must be 0. */
-		(radio->vt).index = TUNER_INDEX;
-		ioctl(radio->radio_fd, VIDIOC_S_TUNER, &(radio->vt));
+		/* ready but nosound */
+		radio->settings.mute = 1;
 
 		/* check region country type if it's updated or not */
 		if ( radio->region_setting.country == MM_RADIO_REGION_GROUP_NONE)
@@ -311,24 +592,37 @@ _mmradio_realize(mm_radio_t* radio)
 		}
 		else // already initialized by application
 		{
+			/* region values are loaded again since they are fitted to tuner of last time */
 			region = radio->region_setting.country;
+			update = true;
 		}
 
 		ret = _mmradio_apply_region(radio, region, update);
-
-		MMRADIO_CHECK_RETURN_IF_FAIL(ret, "update region info");
+		if ( ret != MM_ERROR_NONE )
+		{
+			MMRADIO_LOG_ERROR("failed to update region info\n");
+			goto error;
+		}
+	}
+	else
+	{
+		/* ready but nosound */
+		if( _mmradio_mute(radio) != MM_ERROR_NONE)
+			goto error;
 	}
 
-	/* ready but nosound */
-	if( _mmradio_mute(radio) != MM_ERROR_NONE)
-		goto error;
+	if ( __mmradio_realize_canceled(radio) )
+		goto cancel;
 
 	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_READY );
 #ifdef USE_GST_PIPELINE
-	ret = _mmradio_realize_pipeline(radio);
-	if ( ret ) {
-		debug_error("_mmradio_realize_pipeline is failed\n");
-		return ret;
+	if ( ! radio->pGstreamer_s )
+	{
+		ret = _mmradio_realize_pipeline(radio);
+		if ( ret ) {
+			debug_error("_mmradio_realize_pipeline is failed\n");
+			return ret;
+		}
 	}
 #endif
 	MMRADIO_LOG_FLEAVE();
@@ -338,193 +632,326 @@ _mmradio_realize(mm_radio_t* radio)
 error:
 	if (radio->radio_fd >= 0)
 	{
-		close(radio->radio_fd);
+		MMRADIO_TIMED(radio, MMRADIO_STAT_TUNER_OP(close), radio->backend->close(radio->backend_priv, radio->radio_fd));
 		radio->radio_fd = -1;
 	}
 
+	__mmradio_invalidate_settings(radio);
+
 	MMRADIO_LOG_FLEAVE();
 
 	return MM_ERROR_RADIO_INTERNAL;
-}
-
-int
-_mmradio_unrealize(mm_radio_t* radio)
-{
-	int ret = MM_ERROR_NONE;
-	
-	MMRADIO_LOG_FENTER();
-
-	MMRADIO_CHECK_INSTANCE( radio );
-	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_UNREALIZE );
 
-	if( _mmradio_mute(radio) != MM_ERROR_NONE)
-		return MM_ERROR_RADIO_NOT_INITIALIZED;
+cancel:
+	MMRADIO_LOG_DEBUG("realize is canceled\n");
 
-	/* close radio device here !!!! */
 	if (radio->radio_fd >= 0)
 	{
-		close(radio->radio_fd);
+		MMRADIO_TIMED(radio, MMRADIO_STAT_TUNER_OP(close), radio->backend->close(radio->backend_priv, radio->radio_fd));
 		radio->radio_fd = -1;
 	}
 
-	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_NULL );
-#ifdef USE_GST_PIPELINE
-	ret= _mmradio_destroy_pipeline(radio);
-	if ( ret ) {
-		debug_error("_mmradio_destroy_pipeline is failed\n");
-		return ret;
-	}
-#endif
+	__mmradio_invalidate_settings(radio);
 
 	MMRADIO_LOG_FLEAVE();
 
-	return MM_ERROR_NONE;
+	return MM_ERROR_RADIO_NO_OP;
 }
 
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_realize_async
+ * Desc   : start realizing on worker thread. caller should hold command lock.
+ *          MM_MESSAGE_STATE_CHANGED is posted when it's ready, or MM_MESSAGE_ERROR
+ *          is posted when it fails.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
 int
-_mmradio_destroy(mm_radio_t* radio)
+_mmradio_realize_async(mm_radio_t* radio)
 {
+	pthread_t finished = 0;
 	int ret = 0;
+
 	MMRADIO_LOG_FENTER();
-	
+
 	MMRADIO_CHECK_INSTANCE( radio );
-	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_DESTROY );
-	
-	ret = mmradio_asm_deregister(&radio->sm);
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_REALIZE );
+
+	pthread_mutex_lock( &radio->realize_lock );
+
+	if ( radio->realize_running )
+	{
+		pthread_mutex_unlock( &radio->realize_lock );
+		MMRADIO_LOG_DEBUG("realize is in progress already\n");
+		return MM_ERROR_RADIO_NO_OP;
+	}
+
+	/* previous one is finished. just collect it */
+	finished = radio->realize_thread;
+	radio->realize_thread = 0;
+
+	radio->realize_cancel = false;
+	radio->realize_running = true;
+	radio->pending_state = MM_RADIO_STATE_READY;
+
+	ret = pthread_create(&radio->realize_thread, NULL, __mmradio_realize_thread, (void*)radio);
 	if ( ret )
 	{
-		MMRADIO_LOG_ERROR("failed to deregister asm server\n");
-		return MM_ERROR_RADIO_INTERNAL;
+		MMRADIO_LOG_ERROR("failed to create thread : realize\n");
+		radio->realize_running = false;
+		radio->realize_thread = 0;
+		radio->pending_state = 0;
 	}
 
-	_mmradio_unrealize( radio );
+	pthread_mutex_unlock( &radio->realize_lock );
+
+	/* it has posted its result already. nothing is left but returning */
+	if ( finished )
+		pthread_join(finished, NULL);
 
 	MMRADIO_LOG_FLEAVE();
 
-	return MM_ERROR_NONE;
+	return ret ? MM_ERROR_RADIO_INTERNAL : MM_ERROR_NONE;
 }
 
-
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_cancel_realize
+ * Desc   : cancel asynchronous realize and wait for the worker.
+ *          it must be called without command lock since the worker takes it.
+ *          the worker is taken from handle before waiting, so it's joined only once.
+ *          in the callback of the worker, it's detached instead. handle should not be
+ *          destroyed there since the worker touches it after the callback.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
 int
-_mmradio_set_frequency(mm_radio_t* radio, int freq) // unit should be KHz
+_mmradio_cancel_realize(mm_radio_t* radio)
 {
+	pthread_t thread = 0;
+
 	MMRADIO_LOG_FENTER();
 
 	MMRADIO_CHECK_INSTANCE( radio );
-	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SET_FREQ );
-
-	MMRADIO_LOG_DEBUG("Setting %d frequency\n", freq);
 
-	radio->freq = freq;
+	pthread_mutex_lock( &radio->realize_lock );
 
-	if (radio->radio_fd < 0)
-	{
-		MMRADIO_LOG_DEBUG("radio device is not opened yet. so, it will be applied\n", freq);
-		return MM_ERROR_NONE;
-	}
+	thread = radio->realize_thread;
+	radio->realize_thread = 0;
 
-	/* check frequency range */
-	if ( freq < radio->region_setting.band_min
-		|| freq > radio->region_setting.band_max )
-	{
-		MMRADIO_LOG_ERROR("out of frequency range\n", freq);
-		return MM_ERROR_INVALID_ARGUMENT;
-	}
+	/* worker clears it when it's done */
+	if ( radio->realize_running )
+		radio->realize_cancel = true;
 
-	/* set it */
-	(radio->vf).tuner = 0;
-	(radio->vf).frequency = RADIO_FREQ_FORMAT_SET(freq);
+	pthread_mutex_unlock( &radio->realize_lock );
 
-	if(ioctl(radio->radio_fd, VIDIOC_S_FREQUENCY, &(radio->vf))< 0)
-	{
-		return MM_ERROR_RADIO_NOT_INITIALIZED;
-	}
+	if ( thread && pthread_equal(thread, pthread_self()) )
+		pthread_detach(thread);
+	else if ( thread )
+		pthread_join(thread, NULL);
 
 	MMRADIO_LOG_FLEAVE();
-	
+
 	return MM_ERROR_NONE;
-	
 }
 
-int
-_mmradio_get_frequency(mm_radio_t* radio, int* pFreq)
+static bool
+__mmradio_realize_canceled(mm_radio_t* radio)
 {
-	int freq = 0;
-	MMRADIO_LOG_FENTER();
+	bool canceled = false;
 
-	MMRADIO_CHECK_INSTANCE( radio );
-	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_GET_FREQ );
+	pthread_mutex_lock( &radio->realize_lock );
+	canceled = radio->realize_cancel;
+	pthread_mutex_unlock( &radio->realize_lock );
 
-	return_val_if_fail( pFreq, MM_ERROR_INVALID_ARGUMENT );
+	return canceled;
+}
 
-	/* just return stored frequency if radio device is not ready */
-	if ( radio->radio_fd < 0 )
+static void*
+__mmradio_realize_thread(void* data)
+{
+	mm_radio_t* radio = (mm_radio_t*)data;
+	int ret = MM_ERROR_NONE;
+	bool canceled = false;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CMD_LOCK( radio );
+
+	/* unrealize or destroy came first */
+	if ( __mmradio_realize_canceled(radio) )
 	{
-		MMRADIO_LOG_DEBUG("freq : %d\n", radio->freq);
-		*pFreq = radio->freq;
-		return MM_ERROR_NONE;
+		MMRADIO_LOG_DEBUG("realize is canceled before starting\n");
+		ret = MM_ERROR_RADIO_NO_OP;
 	}
+	else
+	{
+		__ta__("[KPI] initialize media radio service",
+			ret = __mmradio_realize( radio );
+		)
+	}
+
+	radio->pending_state = 0;
+
+	canceled = __mmradio_realize_canceled(radio);
 
-	if (ioctl(radio->radio_fd, VIDIOC_G_FREQUENCY, &(radio->vf)) < 0)
+	MMRADIO_CMD_UNLOCK( radio );
+
+	/* application may call API in the callback. realize is still in progress until it returns */
+	if ( ret != MM_ERROR_NONE && ! canceled )
 	{
-		MMRADIO_LOG_ERROR("failed to do VIDIOC_G_FREQUENCY\n");
-		return MM_ERROR_RADIO_INTERNAL;
-	}	
+		MMMessageParamType param = {0,};
 
-	freq = RADIO_FREQ_FORMAT_GET((radio->vf).frequency);
+		MMRADIO_LOG_ERROR("failed to realize : 0x%x\n", ret);
 
-	/* update freq in handle */
-	radio->freq = freq;
+		param.union_type = MM_MSG_UNION_CODE;
+		param.code = ret;
+		MMRADIO_POST_MSG(radio, MM_MESSAGE_ERROR, &param);
+	}
 
-	*pFreq = radio->freq;
+	pthread_mutex_lock( &radio->realize_lock );
+	radio->realize_cancel = false;
+	radio->realize_running = false;
+	pthread_mutex_unlock( &radio->realize_lock );
 
 	MMRADIO_LOG_FLEAVE();
 
-	return MM_ERROR_NONE;
+	return NULL;
 }
 
 int
-_mmradio_mute(mm_radio_t* radio)
+_mmradio_unrealize(mm_radio_t* radio)
 {
-	MMRADIO_LOG_FENTER();
+	int ret = MM_ERROR_NONE;
 	
+	MMRADIO_LOG_FENTER();
+
 	MMRADIO_CHECK_INSTANCE( radio );
-	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_MUTE );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_UNREALIZE );
 
-	if (radio->radio_fd < 0)
-	{
+	if( _mmradio_mute(radio) != MM_ERROR_NONE)
 		return MM_ERROR_RADIO_NOT_INITIALIZED;
-	}	
 
-	(radio->vctrl).id = V4L2_CID_AUDIO_MUTE;
-	(radio->vctrl).value = 1; //mute
+	/* nobody can access device after closing it. scan is stopped, seek in progress is finished,
+	 * and signal monitor leaves. command lock is released while waiting. so, state is checked again after it
+	 */
+	if ( radio->current_state == MM_RADIO_STATE_SCANNING )
+		_mmradio_stop_scan(radio);
+	_mmradio_wait_job(radio, 0);
+	_mmradio_stop_signal_monitor(radio);
+
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_UNREALIZE );
+
+	_mmradio_stop_quality_sampling(radio);
 
-	if (ioctl(radio->radio_fd, VIDIOC_S_CTRL, &(radio->vctrl)) < 0)
+	/* keep device and pipeline for a while. next realize can use them */
+	if ( radio->keep_warm > 0 && radio->radio_fd >= 0 )
 	{
-		return MM_ERROR_RADIO_NOT_INITIALIZED;
+#ifdef USE_GST_PIPELINE
+		if ( radio->current_state == MM_RADIO_STATE_PLAYING && radio->pGstreamer_s )
+			_mmradio_stop_pipeline(radio);
+#endif
+		if ( _mmradio_park(radio) == MM_ERROR_NONE )
+		{
+			MMRADIO_SET_STATE( radio, MM_RADIO_STATE_NULL );
+
+			MMRADIO_LOG_FLEAVE();
+
+			return MM_ERROR_NONE;
+		}
 	}
 
+	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_NULL );
+
+	ret = _mmradio_close_device(radio);
+
 	MMRADIO_LOG_FLEAVE();
-	
+
+	return ret;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_close_device()
+ * Desc   : close radio device and destroy pipeline
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_close_device(mm_radio_t* radio)
+{
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	/* close radio device here !!!! */
+	if (radio->radio_fd >= 0)
+	{
+		MMRADIO_TIMED(radio, MMRADIO_STAT_TUNER_OP(close), radio->backend->close(radio->backend_priv, radio->radio_fd));
+		radio->radio_fd = -1;
+	}
+
+	__mmradio_invalidate_shadow(radio);
+	__mmradio_invalidate_settings(radio);
+
+#ifdef USE_GST_PIPELINE
+	ret= _mmradio_destroy_pipeline(radio);
+	if ( ret ) {
+		debug_error("_mmradio_destroy_pipeline is failed\n");
+		return ret;
+	}
+#endif
+
+	MMRADIO_LOG_FLEAVE();
+
 	return MM_ERROR_NONE;
-	
 }
 
 int
-_mmradio_unmute(mm_radio_t* radio)
+_mmradio_destroy(mm_radio_t* radio)
 {
+	int ret = 0;
 	MMRADIO_LOG_FENTER();
 	
 	MMRADIO_CHECK_INSTANCE( radio );
-	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_UNMUTE );
-	MMRADIO_CHECK_DEVICE_STATE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_DESTROY );
+	
+	ret = mmradio_asm_deregister(&radio->sm);
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("failed to deregister asm server\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
 
-	(radio->vctrl).id = V4L2_CID_AUDIO_MUTE;
-	(radio->vctrl).value = 0; //unmute
+	_mmradio_unrealize( radio );
+
+	/* no more seek or scan. worker is idle when it's joined */
+	_mmradio_wait_job( radio, 0 );
+	_mmradio_stop_job_worker( radio );
+
+	/* parked device is not needed anymore */
+	_mmradio_unpark( radio, true );
+
+	MMRADIO_FREEIF( radio->history );
+	_mmradio_free_scan_results( radio );
 
-	if (ioctl(radio->radio_fd, VIDIOC_S_CTRL, &(radio->vctrl)) < 0)
+	/* refresh thread uses database and backend */
+	_mmradio_stop_station_refresh( radio );
+	_mmradio_close_station_db( radio );
+
+	if ( radio->scan_cancel_fd >= 0 )
 	{
-		return MM_ERROR_RADIO_NOT_INITIALIZED;
+		close( radio->scan_cancel_fd );
+		radio->scan_cancel_fd = -1;
+	}
+
+	if ( radio->backend_priv )
+	{
+		radio->backend->destroy(radio->backend_priv);
+		radio->backend_priv = NULL;
 	}
 
 	MMRADIO_LOG_FLEAVE();
@@ -532,113 +959,125 @@ _mmradio_unmute(mm_radio_t* radio)
 	return MM_ERROR_NONE;
 }
 
-/* --------------------------------------------------------------------------
- * Name   : __mmradio_set_deemphasis
- * Desc   : apply de-emphasis value to device
- * Param  :
- *	    [in] radio : radio handle
- * Return : zero on success, or negative value with error code
- *---------------------------------------------------------------------------*/
+
 int
-__mmradio_set_deemphasis(mm_radio_t* radio)
+_mmradio_set_frequency(mm_radio_t* radio, int freq) // unit should be KHz
 {
-	int value = 0;
-	
 	MMRADIO_LOG_FENTER();
 
 	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SET_FREQ );
+
+	MMRADIO_LOG_DEBUG("Setting %d frequency\n", freq);
 
-	/* get de-emphasis */
-	switch (radio->region_setting.deemphasis)
+	if (radio->radio_fd < 0)
 	{
-		case MM_RADIO_DEEMPHASIS_50_US:
-			value = 1;//V4L2_DEEMPHASIS_50_uS;
-			break;
+		MMRADIO_LOG_DEBUG("radio device is not opened yet. so, it will be applied\n", freq);
+		radio->freq = freq;
+		return MM_ERROR_NONE;
+	}
 
-		case MM_RADIO_DEEMPHASIS_75_US:
-			value = 2;//V4L2_DEEMPHASIS_75_uS;
-			break;
+	/* check frequency range. frequency of handle is kept if it's refused */
+	if ( freq < radio->region_setting.band_min
+		|| freq > radio->region_setting.band_max )
+	{
+		MMRADIO_LOG_ERROR("out of frequency range\n", freq);
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
 
-		default:
-			MMRADIO_LOG_ERROR("not availabe de-emphasis value\n");
-			return MM_ERROR_COMMON_INVALID_ARGUMENT;
+	/* only raster points of the region are legal */
+	if ( __mmradio_snap_frequency(radio, freq) != freq )
+	{
+		MMRADIO_LOG_DEBUG("%d KHz is not on channel raster. tuning to %d KHz\n", freq, __mmradio_snap_frequency(radio, freq));
+		freq = __mmradio_snap_frequency(radio, freq);
 	}
 
-	/* set it to device */
-	(radio->vctrl).id = (0x009d0000 | 0x900) +1;//V4L2_CID_TUNE_DEEMPHASIS;
-	(radio->vctrl).value = value;
+	/* set it */
+	(radio->vf).tuner = radio->tuner_index;
+	(radio->vf).frequency = RADIO_FREQ_FORMAT_SET(radio, freq);
 
-	if (ioctl(radio->radio_fd, VIDIOC_S_CTRL, &(radio->vctrl)) < 0)
+	if(MMRADIO_TUNER_OP(radio, set_frequency, &(radio->vf))< 0)
 	{
-		MMRADIO_LOG_ERROR("failed to set de-emphasis\n");
-		return MM_ERROR_RADIO_INTERNAL;
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
 	}
 
-	MMRADIO_LOG_FLEAVE();
+	radio->freq = freq;
+
+	__mmradio_update_shadow_freq(radio, freq);
 
+	MMRADIO_LOG_FLEAVE();
+	
 	return MM_ERROR_NONE;
+	
 }
 
 /* --------------------------------------------------------------------------
- * Name   : __mmradio_set_band_range
- * Desc   : apply max and min frequency to device
+ * Name   : _mmradio_tune_raw()
+ * Desc   : tune a tuner by one VIDIOC_S_FREQUENCY. range, raster, frequency of
+ *          the handle and shadow are left to the caller.
  * Param  :
  *	    [in] radio : radio handle
- * Return : zero on success, or negative value with error code
+ *	    [in] tuner : tuner to be tuned. NULL means the tuner of the handle
+ *	    [in] freq : frequency, KHz
+ * Return : zero on success, or -1 with errno
  *---------------------------------------------------------------------------*/
 int
-__mmradio_set_band_range(mm_radio_t* radio)
+_mmradio_tune_raw(mm_radio_t* radio, const MMRadioTuner_t* tuner, int freq)
 {
-	MMRADIO_LOG_FENTER();
-
-	MMRADIO_CHECK_INSTANCE( radio );
-
-	/* get min and max freq. */
-	(radio->vt).rangelow = RADIO_FREQ_FORMAT_SET(radio->region_setting.band_min);
-	(radio->vt).rangehigh = RADIO_FREQ_FORMAT_SET(radio->region_setting.band_max);
+	MMRadioTuner_t handle_tuner;
+	struct v4l2_frequency vf;
 
-	/* set it to device */
-	if (ioctl(radio->radio_fd, VIDIOC_S_TUNER, &(radio->vt)) < 0 )
+	if ( ! tuner )
 	{
-		MMRADIO_LOG_ERROR("failed to set band range\n");
-		return MM_ERROR_RADIO_INTERNAL;
+		handle_tuner.priv = radio->backend_priv;
+		handle_tuner.fd = radio->radio_fd;
+		handle_tuner.tuner_index = radio->tuner_index;
+		handle_tuner.freq_unit = radio->freq_unit;
+		tuner = &handle_tuner;
 	}
 
-	MMRADIO_LOG_FLEAVE();
+	memset(&vf, 0, sizeof(struct v4l2_frequency));
+	vf.tuner = tuner->tuner_index;
+	vf.type = V4L2_TUNER_RADIO;
+	vf.frequency = (unsigned int)((unsigned long long)freq * 10000 / tuner->freq_unit);
 
-	return MM_ERROR_NONE;
+	return (int)MMRADIO_TIMED( radio, MMRADIO_STAT_TUNER_OP(set_frequency),
+		radio->backend->set_frequency(tuner->priv, tuner->fd, &vf) );
 }
 
 int
-_mmradio_set_message_callback(mm_radio_t* radio, MMMessageCallback callback, void *user_param)
+_mmradio_get_frequency(mm_radio_t* radio, int* pFreq)
 {
+	int freq = 0;
 	MMRADIO_LOG_FENTER();
-	
+
 	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_GET_FREQ );
 
-	radio->msg_cb = callback;
-	radio->msg_cb_param = user_param;
+	return_val_if_fail( pFreq, MM_ERROR_INVALID_ARGUMENT );
 
-	MMRADIO_LOG_DEBUG("msg_cb : 0x%x msg_cb_param : 0x%x\n", (unsigned int)callback, (unsigned int)user_param);
+	/* just return stored frequency if radio device is not ready */
+	if ( radio->radio_fd < 0 )
+	{
+		MMRADIO_LOG_DEBUG("freq : %d\n", radio->freq);
+		*pFreq = radio->freq;
+		return MM_ERROR_NONE;
+	}
 
-	MMRADIO_LOG_FLEAVE();
+	if (MMRADIO_TUNER_OP(radio, get_frequency, &(radio->vf)) < 0)
+	{
+		MMRADIO_LOG_ERROR("failed to do VIDIOC_G_FREQUENCY\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}	
 
-	return MM_ERROR_NONE;
-}
-		
-int
-_mmradio_get_state(mm_radio_t* radio, int* pState)
-{
-	int state = 0;
+	freq = RADIO_FREQ_FORMAT_GET(radio, (radio->vf).frequency);
 
-	MMRADIO_LOG_FENTER();
-	
-	MMRADIO_CHECK_INSTANCE( radio );
-	return_val_if_fail( pState, MM_ERROR_INVALID_ARGUMENT );
-		
-	state = __mmradio_get_state( radio );
+	/* update freq in handle */
+	radio->freq = freq;
 
-	*pState = state;
+	__mmradio_update_shadow_freq(radio, freq);
+
+	*pFreq = radio->freq;
 
 	MMRADIO_LOG_FLEAVE();
 
@@ -646,90 +1085,356 @@ _mmradio_get_state(mm_radio_t* radio, int* pState)
 }
 
 int
-_mmradio_start(mm_radio_t* radio)
+_mmradio_mute(mm_radio_t* radio)
 {
-	int ret = MM_ERROR_NONE;
-	system_audio_route_t policy = SYSTEM_AUDIO_ROUTE_POLICY_DEFAULT;
-	
 	MMRADIO_LOG_FENTER();
 	
 	MMRADIO_CHECK_INSTANCE( radio );
-	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_START );
-
-	MMRADIO_LOG_DEBUG("now tune to frequency : %d\n", radio->freq);
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_MUTE );
 
-	ret = mmradio_asm_set_state(&radio->sm, ASM_STATE_PLAYING, ASM_RESOURCE_RADIO_TUNNER);
-	if ( ret )
+	if (radio->radio_fd < 0)
 	{
-		MMRADIO_LOG_ERROR("failed to set asm state to PLAYING\n");
-		return ret;
-	}
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+	}	
 
-	/* set stored frequency */
-	_mmradio_set_frequency( radio, radio->freq );
+	radio->settings.mute = 1;
 
-	/* unmute */
-	if( _mmradio_unmute(radio) != MM_ERROR_NONE)
+	if (__mmradio_apply_settings(radio) != MM_ERROR_NONE)
+	{
 		return MM_ERROR_RADIO_NOT_INITIALIZED;
-
-	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_PLAYING );
-#ifdef USE_GST_PIPELINE
-	ret = _mmradio_start_pipeline( radio );
-	if ( ret ) {
-		debug_error("_mmradio_start_pipeline is failed\n");
-		return ret;
 	}
-#endif
 
 	MMRADIO_LOG_FLEAVE();
-
-	return ret;
+	
+	return MM_ERROR_NONE;
+	
 }
 
 int
-_mmradio_stop(mm_radio_t* radio)
+_mmradio_unmute(mm_radio_t* radio)
 {
-	int ret = MM_ERROR_NONE;
-
 	MMRADIO_LOG_FENTER();
 	
 	MMRADIO_CHECK_INSTANCE( radio );
-	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_STOP );
-
-	if( _mmradio_mute(radio) != MM_ERROR_NONE)
-		return MM_ERROR_RADIO_NOT_INITIALIZED;
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_UNMUTE );
+	MMRADIO_CHECK_DEVICE_STATE( radio );
 
-	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_READY );
+	radio->settings.mute = 0;
 
-	ret = mmradio_asm_set_state(&radio->sm, ASM_STATE_STOP, ASM_RESOURCE_NONE);
-	if ( ret )
+	if (__mmradio_apply_settings(radio) != MM_ERROR_NONE)
 	{
-		MMRADIO_LOG_ERROR("failed to set asm state to PLAYING\n");
-		return ret;
-	}
-#ifdef USE_GST_PIPELINE
-	ret= _mmradio_stop_pipeline( radio );
-	if ( ret ) {
-		debug_error("_mmradio_stop_pipeline is failed\n");
-		return ret;
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
 	}
-#endif
 
 	MMRADIO_LOG_FLEAVE();
 
-	return ret;
+	return MM_ERROR_NONE;
 }
 
-#ifdef USE_GST_PIPELINE
-int
-_mmradio_realize_pipeline(mm_radio_t* radio)
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_get_deemphasis_value
+ * Desc   : convert de-emphasis to the value of V4L2 control
+ * Param  :
+ *	    [in] deemphasis : de-emphasis of region
+ * Return : V4L2 de-emphasis value, or -1 if it's not available
+ *---------------------------------------------------------------------------*/
+static int
+__mmradio_get_deemphasis_value(MMRadioDeemphasis deemphasis)
 {
-	int ret = MM_ERROR_NONE;
-
-	gst_init (NULL, NULL);
-	radio->pGstreamer_s = g_new0 (mm_radio_gstreamer_s, 1);
+	switch (deemphasis)
+	{
+		case MM_RADIO_DEEMPHASIS_50_US:
+			return 1;//V4L2_DEEMPHASIS_50_uS;
 
-	radio->pGstreamer_s->pipeline= gst_pipeline_new ("avsysaudio");
+		case MM_RADIO_DEEMPHASIS_75_US:
+			return 2;//V4L2_DEEMPHASIS_75_uS;
+
+		default:
+			return -1;
+	}
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_apply_settings
+ * Desc   : apply changed settings to device. unchanged ones are skipped.
+ *          tuner settings are set by one VIDIOC_S_TUNER and controls are set by
+ *          one VIDIOC_S_EXT_CTRLS. if driver can't do the latter, VIDIOC_S_CTRL is
+ *          used for each control.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+static int
+__mmradio_apply_settings(mm_radio_t* radio)
+{
+	MMRadioSettings_t* want = &radio->settings;
+	MMRadioSettings_t* have = &radio->applied;
+	struct v4l2_ext_control ctrl[2];
+	struct v4l2_ext_controls ctrls;
+	int count = 0;
+	int ioctls = 0;
+	int ret = MM_ERROR_NONE;
+	int i = 0;
+	bool timed = radio->stats_enabled;
+	unsigned long long begin = timed ? _mmradio_get_time_usec() : 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_DEVICE_STATE( radio );
+
+	/* tuner. band range is zero until region is applied */
+	if ( want->rangelow && want->rangehigh &&
+		( want->audmode != have->audmode || want->rangelow != have->rangelow || want->rangehigh != have->rangehigh ) )
+	{
+		(radio->vt).index = radio->tuner_index;
+		(radio->vt).audmode = want->audmode;
+		(radio->vt).rangelow = want->rangelow;
+		(radio->vt).rangehigh = want->rangehigh;
+
+		ioctls++;
+		if (MMRADIO_TUNER_OP(radio, set_tuner, &(radio->vt)) < 0)
+		{
+			MMRADIO_LOG_ERROR("failed to set tuner : %s\n", strerror(errno));
+			ret = MM_ERROR_RADIO_INTERNAL;
+			goto done;
+		}
+
+		have->audmode = want->audmode;
+		have->rangelow = want->rangelow;
+		have->rangehigh = want->rangehigh;
+	}
+
+	/* controls */
+	memset(ctrl, 0, sizeof(ctrl));
+
+	if ( want->deemphasis && want->deemphasis != have->deemphasis )
+	{
+		ctrl[count].id = MMRADIO_CID_TUNE_DEEMPHASIS;
+		ctrl[count].value = want->deemphasis;
+		count++;
+	}
+
+	if ( want->mute != have->mute )
+	{
+		ctrl[count].id = V4L2_CID_AUDIO_MUTE;
+		ctrl[count].value = want->mute;
+		count++;
+	}
+
+	if ( count == 0 )
+		goto done;
+
+	if ( ! radio->ext_ctrls_unsupported )
+	{
+		memset(&ctrls, 0, sizeof(ctrls));
+		ctrls.ctrl_class = 0;	/* controls of different classes */
+		ctrls.count = count;
+		ctrls.controls = ctrl;
+
+		ioctls++;
+		if (MMRADIO_TUNER_OP(radio, set_ext_ctrls, &ctrls) == 0)
+		{
+			for ( i = 0; i < count; i++ )
+				__mmradio_set_applied_ctrl(radio, ctrl[i].id, ctrl[i].value);
+			goto done;
+		}
+
+		/* old drivers don't have it. don't try again */
+		if ( errno == ENOTTY || errno == EINVAL )
+		{
+			MMRADIO_LOG_DEBUG("VIDIOC_S_EXT_CTRLS is not supported. using VIDIOC_S_CTRL\n");
+			radio->ext_ctrls_unsupported = true;
+		}
+		else
+		{
+			MMRADIO_LOG_ERROR("failed to set controls : %s\n", strerror(errno));
+		}
+	}
+
+	for ( i = 0; i < count; i++ )
+	{
+		(radio->vctrl).id = ctrl[i].id;
+		(radio->vctrl).value = ctrl[i].value;
+
+		ioctls++;
+		if (MMRADIO_TUNER_OP(radio, set_ctrl, &(radio->vctrl)) < 0)
+		{
+			MMRADIO_LOG_ERROR("failed to set control(0x%x) : %s\n", ctrl[i].id, strerror(errno));
+			ret = MM_ERROR_RADIO_INTERNAL;
+			break;
+		}
+
+		__mmradio_set_applied_ctrl(radio, ctrl[i].id, ctrl[i].value);
+	}
+
+done:
+	/* ioctls per apply are reported by statistics */
+	if ( timed )
+		_mmradio_stats_end_batch(radio, MMRADIO_STAT_APPLY_SETTINGS, ret, begin, ioctls);
+
+	MMRADIO_LOG_DEBUG("%d ioctl(s) for applying settings\n", ioctls);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
+
+static void
+__mmradio_set_applied_ctrl(mm_radio_t* radio, unsigned int id, int value)
+{
+	if ( id == V4L2_CID_AUDIO_MUTE )
+		radio->applied.mute = value;
+	else if ( id == MMRADIO_CID_TUNE_DEEMPHASIS )
+		radio->applied.deemphasis = value;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_invalidate_settings
+ * Desc   : forget settings of device. everything is applied again next time.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : none
+ *---------------------------------------------------------------------------*/
+static void
+__mmradio_invalidate_settings(mm_radio_t* radio)
+{
+	/* no requested value can be same with these */
+	radio->applied.audmode = (unsigned int)-1;
+	radio->applied.rangelow = 0;
+	radio->applied.rangehigh = 0;
+	radio->applied.deemphasis = -1;
+	radio->applied.mute = -1;
+
+	radio->ext_ctrls_unsupported = false;
+	radio->hw_seek_unsupported = false;
+
+	/* seek thresholds are lost with device. tuner's own ones are kept for default profile */
+	radio->seek_threshold_dirty = true;
+	radio->seek_threshold_applied = false;
+}
+
+int
+_mmradio_set_message_callback(mm_radio_t* radio, MMMessageCallback callback, void *user_param)
+{
+	MMRADIO_LOG_FENTER();
+	
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	radio->msg_cb = callback;
+	radio->msg_cb_param = user_param;
+
+	MMRADIO_LOG_DEBUG("msg_cb : 0x%x msg_cb_param : 0x%x\n", (unsigned int)callback, (unsigned int)user_param);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+		
+int
+_mmradio_get_state(mm_radio_t* radio, int* pState)
+{
+	int state = 0;
+
+	MMRADIO_LOG_FENTER();
+	
+	MMRADIO_CHECK_INSTANCE( radio );
+	return_val_if_fail( pState, MM_ERROR_INVALID_ARGUMENT );
+		
+	state = __mmradio_get_state( radio );
+
+	*pState = state;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+int
+_mmradio_start(mm_radio_t* radio)
+{
+	int ret = MM_ERROR_NONE;
+	system_audio_route_t policy = SYSTEM_AUDIO_ROUTE_POLICY_DEFAULT;
+	
+	MMRADIO_LOG_FENTER();
+	
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_START );
+
+	MMRADIO_LOG_DEBUG("now tune to frequency : %d\n", radio->freq);
+
+	ret = MMRADIO_TIMED(radio, MMRADIO_STAT_ASM_SET_STATE, mmradio_asm_set_state(&radio->sm, ASM_STATE_PLAYING, ASM_RESOURCE_RADIO_TUNNER));
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("failed to set asm state to PLAYING\n");
+		return ret;
+	}
+
+	/* set stored frequency */
+	_mmradio_set_frequency( radio, radio->freq );
+
+	/* unmute */
+	if( _mmradio_unmute(radio) != MM_ERROR_NONE)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_PLAYING );
+#ifdef USE_GST_PIPELINE
+	ret = _mmradio_start_pipeline( radio );
+	if ( ret ) {
+		debug_error("_mmradio_start_pipeline is failed\n");
+		return ret;
+	}
+#endif
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
+
+int
+_mmradio_stop(mm_radio_t* radio)
+{
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+	
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_STOP );
+
+	if( _mmradio_mute(radio) != MM_ERROR_NONE)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_READY );
+
+	ret = MMRADIO_TIMED(radio, MMRADIO_STAT_ASM_SET_STATE, mmradio_asm_set_state(&radio->sm, ASM_STATE_STOP, ASM_RESOURCE_NONE));
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("failed to set asm state to PLAYING\n");
+		return ret;
+	}
+#ifdef USE_GST_PIPELINE
+	ret= _mmradio_stop_pipeline( radio );
+	if ( ret ) {
+		debug_error("_mmradio_stop_pipeline is failed\n");
+		return ret;
+	}
+#endif
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
+
+#ifdef USE_GST_PIPELINE
+int
+_mmradio_realize_pipeline(mm_radio_t* radio)
+{
+	int ret = MM_ERROR_NONE;
+
+	gst_init (NULL, NULL);
+	radio->pGstreamer_s = g_new0 (mm_radio_gstreamer_s, 1);
+
+	radio->pGstreamer_s->pipeline= gst_pipeline_new ("avsysaudio");
 
 	radio->pGstreamer_s->avsysaudiosrc= gst_element_factory_make("avsysaudiosrc","fm audio src");
 	radio->pGstreamer_s->queue2= gst_element_factory_make("queue2","queue2");
@@ -766,14 +1471,14 @@ _mmradio_start_pipeline(mm_radio_t* radio)
 	GstStateChangeReturn ret_state;
 	debug_log("\n");
 
-	if(gst_element_set_state (radio->pGstreamer_s->pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+	if(MMRADIO_TIMED(radio, MMRADIO_STAT_GST_SET_STATE, gst_element_set_state (radio->pGstreamer_s->pipeline, GST_STATE_PLAYING)) == GST_STATE_CHANGE_FAILURE) {
 		mmf_debug(MMF_DEBUG_ERROR, "Fail to change pipeline state");
 		gst_object_unref (radio->pGstreamer_s->pipeline);
 		g_free (radio->pGstreamer_s);
 		return MM_ERROR_RADIO_INVALID_STATE;
 	}
 
-	ret_state = gst_element_get_state (radio->pGstreamer_s->pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+	ret_state = MMRADIO_TIMED(radio, MMRADIO_STAT_GST_GET_STATE, gst_element_get_state (radio->pGstreamer_s->pipeline, NULL, NULL, GST_CLOCK_TIME_NONE));
 	if (ret_state == GST_STATE_CHANGE_FAILURE) {
 		mmf_debug(MMF_DEBUG_ERROR, "GST_STATE_CHANGE_FAILURE");
 		gst_object_unref (radio->pGstreamer_s->pipeline);
@@ -792,14 +1497,14 @@ _mmradio_stop_pipeline(mm_radio_t* radio)
 	GstStateChangeReturn ret_state;
 
 	debug_log("\n");
-	if(gst_element_set_state (radio->pGstreamer_s->pipeline, GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+	if(MMRADIO_TIMED(radio, MMRADIO_STAT_GST_SET_STATE, gst_element_set_state (radio->pGstreamer_s->pipeline, GST_STATE_READY)) == GST_STATE_CHANGE_FAILURE) {
 		mmf_debug(MMF_DEBUG_ERROR, "Fail to change pipeline state");
 		gst_object_unref (radio->pGstreamer_s->pipeline);
 		g_free (radio->pGstreamer_s);
 		return MM_ERROR_RADIO_INVALID_STATE;
 	}
 
-	ret_state = gst_element_get_state (radio->pGstreamer_s->pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+	ret_state = MMRADIO_TIMED(radio, MMRADIO_STAT_GST_GET_STATE, gst_element_get_state (radio->pGstreamer_s->pipeline, NULL, NULL, GST_CLOCK_TIME_NONE));
 	if (ret_state == GST_STATE_CHANGE_FAILURE) {
 		mmf_debug(MMF_DEBUG_ERROR, "GST_STATE_CHANGE_FAILURE");
 		gst_object_unref (radio->pGstreamer_s->pipeline);
@@ -818,24 +1523,30 @@ _mmradio_destroy_pipeline(mm_radio_t * radio)
 	GstStateChangeReturn ret_state;
 	debug_log("\n");
 
-	if(gst_element_set_state (radio->pGstreamer_s->pipeline, GST_STATE_NULL) == GST_STATE_CHANGE_FAILURE) {
+	if ( ! radio->pGstreamer_s )
+		return MM_ERROR_NONE;
+
+	if(MMRADIO_TIMED(radio, MMRADIO_STAT_GST_SET_STATE, gst_element_set_state (radio->pGstreamer_s->pipeline, GST_STATE_NULL)) == GST_STATE_CHANGE_FAILURE) {
 		mmf_debug(MMF_DEBUG_ERROR, "Fail to change pipeline state");
 		gst_object_unref (radio->pGstreamer_s->pipeline);
 		g_free (radio->pGstreamer_s);
+		radio->pGstreamer_s = NULL;
 		return MM_ERROR_RADIO_INVALID_STATE;
 	}
 
-	ret_state = gst_element_get_state (radio->pGstreamer_s->pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+	ret_state = MMRADIO_TIMED(radio, MMRADIO_STAT_GST_GET_STATE, gst_element_get_state (radio->pGstreamer_s->pipeline, NULL, NULL, GST_CLOCK_TIME_NONE));
 	if (ret_state == GST_STATE_CHANGE_FAILURE) {
 		mmf_debug(MMF_DEBUG_ERROR, "GST_STATE_CHANGE_FAILURE");
 		gst_object_unref (radio->pGstreamer_s->pipeline);
 		g_free (radio->pGstreamer_s);
+		radio->pGstreamer_s = NULL;
 		return MM_ERROR_RADIO_INVALID_STATE;
 	} else {
 		mmf_debug (MMF_DEBUG_LOG, "[%s][%05d] GST_STATE_NULL ret_state = %d (GST_STATE_CHANGE_SUCCESS)\n", __func__, __LINE__, ret_state);
 	}
 	gst_object_unref (radio->pGstreamer_s->pipeline);
 	g_free (radio->pGstreamer_s);
+	radio->pGstreamer_s = NULL;
 	return ret;
 }
 #endif
@@ -856,14 +1567,13 @@ _mmradio_seek(mm_radio_t* radio, MMRadioSeekDirectionType direction)
 	MMRADIO_LOG_DEBUG("trying to seek. direction[0:UP/1:DOWN) %d\n", direction);
 	radio->seek_direction = direction;
 
-	ret = pthread_create(&radio->seek_thread, NULL,
-		(void *)__mmradio_seek_thread, (void *)radio);
+	/* software seek checks them. stopped scan leaves them set */
+	__mmradio_reset_scan_cancel(radio);
 
-	if ( ret )
-	{
-		MMRADIO_LOG_DEBUG("failed create thread\n");
-		return MM_ERROR_RADIO_INTERNAL;
-	}
+	/* seeks of rapid presses run one by one */
+	ret = _mmradio_submit_job(radio, (MMRadioJobFunc_t)__mmradio_seek_thread, "seek", NULL);
+	if ( ret != MM_ERROR_NONE )
+		return ret;
 
 	MMRADIO_LOG_FLEAVE();
 
@@ -878,21 +1588,26 @@ _mmradio_start_scan(mm_radio_t* radio)
 	MMRADIO_CHECK_INSTANCE( radio );
 	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_START_SCAN );
 
-	int scan_tr_id = 0;
- 	
-	radio->stop_scan = false;
+	int ret = MM_ERROR_NONE;
 
-	scan_tr_id = pthread_create(&radio->scan_thread, NULL,
-		(void *)__mmradio_scan_thread, (void *)radio);
+	/* last scan leaves them set when it's stopped */
+	__mmradio_reset_scan_cancel(radio);
 
-	if (scan_tr_id != 0) 
-	{
-		MMRADIO_LOG_DEBUG("failed to create thread : scan\n");
-		return MM_ERROR_RADIO_NOT_INITIALIZED;
-	}
+	if ( _mmradio_begin_scan_results(radio) != MM_ERROR_NONE )
+		return MM_ERROR_RADIO_INTERNAL;
 
+	/* before the job. it sets READY when it's done, which can be before submit returns */
 	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_SCANNING );
 
+	ret = _mmradio_submit_job(radio, (MMRadioJobFunc_t)__mmradio_scan_thread, "scan", &radio->scan_job);
+	if ( ret != MM_ERROR_NONE )
+	{
+		MMRADIO_LOG_DEBUG("failed to queue scan\n");
+		_mmradio_end_scan_results(radio, true);
+		MMRADIO_SET_STATE( radio, MM_RADIO_STATE_READY );
+		return ret;
+	}
+
 	MMRADIO_LOG_FLEAVE();
 
 	return MM_ERROR_NONE;
@@ -908,13 +1623,23 @@ _mmradio_stop_scan(mm_radio_t* radio)
 		
 	radio->stop_scan = true;
 
- 	if( radio->scan_thread > 0 )
+ 	if( radio->scan_job )
 	{	
-		pthread_cancel(radio->scan_thread);
-		pthread_join(radio->scan_thread, NULL);
-	 	radio->scan_thread = 0;
+		/* scan job finishes it by itself. READY and SCAN_STOP come from there.
+		 * command lock is released while waiting, since callback of the scan can call API.
+		 * called from the callback, it doesn't wait. scan is finished after the callback returns
+		 */
+		_mmradio_abort_scan(radio);
+		_mmradio_wait_job(radio, radio->scan_job);
+
+		MMRADIO_LOG_FLEAVE();
+
+		return MM_ERROR_NONE;
 	}
 
+	/* no job to finish it. stations not posted yet are dropped */
+	_mmradio_end_scan_results(radio, true);
+
  	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_READY );
 	MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_STOP, NULL);
 
@@ -923,13 +1648,59 @@ _mmradio_stop_scan(mm_radio_t* radio)
 	return MM_ERROR_NONE;
 }
 
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_abort_scan()
+ * Desc   : make scan thread stop by itself. waits of it are woken up, and hardware seek in progress is aborted
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_abort_scan(mm_radio_t* radio)
+{
+	int freq = radio->freq;
+
+	radio->stop_scan = true;
+
+	if ( eventfd_write(radio->scan_cancel_fd, 1) < 0 )
+		MMRADIO_LOG_ERROR("failed to wake up scan : %s\n", strerror(errno));
+
+	/* hardware seek in progress is aborted by tuning. tuner stays at the last station */
+	pthread_mutex_lock(&radio->shadow_lock);
+	if ( radio->shadow.freq > 0 )
+		freq = radio->shadow.freq;
+	pthread_mutex_unlock(&radio->shadow_lock);
+
+	if ( _mmradio_tune_raw(radio, NULL, freq) < 0 )
+		MMRADIO_LOG_DEBUG("failed to abort seek : %s\n", strerror(errno));
+}
+
+/* stop token is cleared before next scan or seek. stopped one never clears it, since it can be still running */
+static void
+__mmradio_reset_scan_cancel(mm_radio_t* radio)
+{
+	eventfd_t value = 0;
+
+	eventfd_read(radio->scan_cancel_fd, &value);
+	radio->stop_scan = false;
+}
+
 void
 __mmradio_scan_thread(mm_radio_t* radio)
 {
 	int ret = 0;
 	int prev_freq = 0;
+	int start_freq = radio->region_setting.band_min;
+	int num_stations = 0;
+	int error = MM_ERROR_NONE;
+	bool out_of_budget = false;
+	bool top = false;
+	bool stopped = false;
+	MMRadioRetry_t retry;
+	MMRadioScanResult result;
+	unsigned long long begin = _mmradio_get_time_usec();
 	struct v4l2_hw_freq_seek vs = {0,};
-	vs.tuner = TUNER_INDEX;
+	vs.tuner = radio->tuner_index;
 	vs.type = V4L2_TUNER_RADIO;
 	vs.wrap_around = 0; /* around:1 not around:0 */
 	vs.seek_upward = 1; /* up : 1	------- down : 0 */
@@ -938,42 +1709,88 @@ __mmradio_scan_thread(mm_radio_t* radio)
 
 	MMRADIO_CHECK_INSTANCE( radio );
 
-	if( _mmradio_mute(radio) != MM_ERROR_NONE)
+	_mmradio_retry_init(&retry, &seek_retry_policy);
+	retry.cancel_fd = radio->scan_cancel_fd;
+
+	/* watchdog aborts scan when time budget runs out */
+	_mmradio_begin_scan_budget(radio);
+
+	/* stopped while it's queued */
+	if ( radio->stop_scan )
+		goto FINISHED;
+
+	__mmradio_set_seek_raster(radio, &vs);
+	__mmradio_apply_seek_threshold(radio);
+
+	error = _mmradio_mute(radio);
+	if( error != MM_ERROR_NONE)
 		goto FINISHED;
 
-	if( _mmradio_set_frequency(radio, radio->region_setting.band_min) != MM_ERROR_NONE)
+	/* interrupted scan continues after the last station it found */
+	if ( radio->scan_results.resume && radio->scan_results.checkpoint > start_freq )
+		start_freq = prev_freq = radio->scan_results.checkpoint;
+
+	error = _mmradio_set_frequency(radio, start_freq);
+	if( error != MM_ERROR_NONE)
 		goto FINISHED;
 
 	MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_START, NULL);
 	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_SCANNING );
 
+	/* stations of database go first in budgeted scan. tuner is back at band_min after it */
+	_mmradio_scan_known_stations(radio);
+
+	/* band is divided among tuners. software seek samples channels by one tuner */
+	if ( radio->num_scan_tuners > 0 && ! _mmradio_use_sw_seek(radio) )
+	{
+		error = _mmradio_parallel_scan(radio, &vs, start_freq, &num_stations, &retry);
+		if ( error != MM_ERROR_RADIO_NO_OP )
+			goto FINISHED;
+
+		error = MM_ERROR_NONE;
+		_mmradio_set_frequency(radio, start_freq);
+	}
+
 	while( ! radio->stop_scan )
 	{
 		int freq = 0;
 		MMMessageParamType param = {0,};
 
 		MMRADIO_LOG_DEBUG("scanning....\n");
-		ret = ioctl(radio->radio_fd, VIDIOC_S_HW_FREQ_SEEK, &vs);
+		ret = __mmradio_seek_once(radio, &vs);
 
 		if( ret == -1 )
 		{
+			/* seek is aborted by stop */
+			if ( radio->stop_scan )
+				break;
+
 			if ( errno == EAGAIN )
 			{
 				MMRADIO_LOG_ERROR("scanning timeout\n");
-				continue;
+				if ( ! radio->stop_scan && _mmradio_retry_backoff(&retry) )
+					continue;
+
+				MMRADIO_LOG_ERROR("giving up scanning after %d retries\n", retry.attempts);
+				error = MM_ERROR_RADIO_INTERNAL;
+				break;
 			}
 			else if ( errno == EINVAL )
 			{
 				MMRADIO_LOG_ERROR("The tuner index is out of bounds or the value in the type field is wrong.");
+				error = MM_ERROR_RADIO_INTERNAL;
 				break;
 			}
 			else
 			{
 				MMRADIO_LOG_ERROR("Error: %s, %d\n", strerror(errno), errno);
+				error = MM_ERROR_RADIO_INTERNAL;
 				break;
 			}
 		}
 
+		_mmradio_retry_reset(&retry);
+
 		/* now we can get new frequency from radio device */
 
 		if ( radio->stop_scan ) break;
@@ -985,6 +1802,8 @@ __mmradio_scan_thread(mm_radio_t* radio)
 		}
 		else
 		{
+			freq = __mmradio_snap_frequency(radio, freq);
+
 			if ( freq < prev_freq )
 			{
 				MMRADIO_LOG_DEBUG("scanning wrapped around. stopping scan\n");
@@ -992,38 +1811,81 @@ __mmradio_scan_thread(mm_radio_t* radio)
 			}
 
 			if ( freq == prev_freq)
+			{
+				/* top channel again. nothing is above it */
+				if ( freq >= __mmradio_get_raster_max(radio) )
+					break;
+
 				continue;
+			}
 
 			prev_freq = param.radio_scan.frequency = freq;
 			MMRADIO_LOG_DEBUG("scanning : new frequency : [%d]\n", param.radio_scan.frequency);
 			
-			/* drop if max freq is scanned */
-			if (radio, param.radio_scan.frequency == radio->region_setting.band_max )
+			/* seek stops at the top channel also when it runs into band limit */
+			top = ( param.radio_scan.frequency >= __mmradio_get_raster_max(radio) );
+			if ( top && ! __mmradio_is_top_station(radio, freq) )
 			{
-				MMRADIO_LOG_DEBUG("%d freq is dropping...and stopping scan\n", param.radio_scan.frequency);
+				MMRADIO_LOG_DEBUG("%d freq is band limit...and stopping scan\n", param.radio_scan.frequency);
 				break;
 			}
 
 			if ( radio->stop_scan ) break; // doesn't need to post
 
-			MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_INFO, &param);
+			_mmradio_add_scan_result(radio, freq, -1);
+			num_stations++;
+
+			_mmradio_post_scan_progress(radio, freq);
+
+			if ( top )
+				break;
 		}
 	}
 FINISHED:
-	radio->scan_thread = 0;
-	
-	MMRADIO_SET_STATE( radio, MM_RADIO_STATE_READY );
+	/* aborted by watchdog. it finishes as usual with stations found so far */
+	out_of_budget = _mmradio_end_scan_budget(radio);
+	if ( out_of_budget )
+	{
+		eventfd_t value = 0;
+
+		MMRADIO_LOG_DEBUG("scan is out of time budget\n");
+		eventfd_read(radio->scan_cancel_fd, &value);
+		radio->stop_scan = false;
+	}
+
+	/* stopped by user or ASM, or out of budget. it can be resumed from the checkpoint.
+	 * stop_scan is left as it is. next scan clears it when it starts
+	 */
+	stopped = radio->stop_scan;
+	radio->scan_results.resumable = ( stopped || out_of_budget );
+	radio->scan_results.resume = false;
+
+	/* last batch goes before SCAN_FINISH. stations not posted yet are dropped if it's stopped */
+	_mmradio_end_scan_results(radio, stopped);
+
+	/* distinct stations. hits merged into others are not counted */
+	num_stations = radio->scan_results.num_stations;
 
-	if ( ! radio->stop_scan )
+	/* next scan can be started as soon as it's READY. result is taken before */
+	__mmradio_get_scan_result(radio, &result, num_stations, &retry, begin, error, out_of_budget);
+
+	/* unrealize from callback of the scan doesn't wait for it. handle can be NULL already */
+	if ( radio->current_state == MM_RADIO_STATE_SCANNING )
+	{
+		MMRADIO_SET_STATE( radio, MM_RADIO_STATE_READY );
+	}
+
+	if ( stopped )
+	{
+		MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_STOP, NULL);
+	}
+	else
 	{
 		MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_FINISH, NULL);
+		__mmradio_post_scan_result(radio, &result);
 	}
 
 	MMRADIO_LOG_FLEAVE();
-
-	pthread_exit(NULL);
-
-	return;
 }
 
 bool 
@@ -1033,7 +1895,7 @@ __is_tunable_frequency(mm_radio_t* radio, int freq)
 
 	MMRADIO_CHECK_INSTANCE( radio );
 
-	if ( freq == radio->region_setting.band_max|| freq == radio->region_setting.band_min )
+	if ( freq > __mmradio_get_raster_max(radio) || freq < radio->region_setting.band_min )
 		return false;
 
 	MMRADIO_LOG_FLEAVE();
@@ -1041,6 +1903,55 @@ __is_tunable_frequency(mm_radio_t* radio, int freq)
 	return true;
 }
 
+/* signal of a channel. tuner stays there. -1 on failure or stop */
+static int
+__mmradio_read_channel_signal(mm_radio_t* radio, int freq)
+{
+	struct v4l2_tuner vt;
+
+	if ( _mmradio_tune_raw(radio, NULL, freq) < 0 )
+		return -1;
+
+	if ( _mmradio_wait_cancel(radio->scan_cancel_fd, _mmradio_sw_seek_settle(radio)) )
+		return -1;
+
+	memset(&vt, 0, sizeof(struct v4l2_tuner));
+	vt.index = radio->tuner_index;
+	if ( MMRADIO_TUNER_OP(radio, get_tuner, &vt) < 0 )
+		return -1;
+
+	return (int)vt.signal;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_is_top_station
+ * Desc   : seek stops at the top channel also when it runs into band limit.
+ *          it's a station if it's over seek threshold, and it's not the edge of the station below it
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] freq : top channel of the band, KHz
+ * Return : true if there is a station
+ *---------------------------------------------------------------------------*/
+static bool
+__mmradio_is_top_station(mm_radio_t* radio, int freq)
+{
+	int signal = __mmradio_read_channel_signal(radio, freq);
+	int below = 0;
+
+	if ( signal < _mmradio_sw_seek_threshold(radio) )
+		return false;
+
+	below = __mmradio_read_channel_signal(radio, freq - radio->region_setting.channel_spacing);
+
+	/* tuner goes back to the station */
+	if ( __mmradio_read_channel_signal(radio, freq) < 0 )
+		return false;
+
+	MMRADIO_LOG_DEBUG("top channel %d KHz : signal %d, %d below it\n", freq, signal, below);
+
+	return ( signal >= below );
+}
+
 void
 __mmradio_seek_thread(mm_radio_t* radio)
 {
@@ -1048,9 +1959,11 @@ __mmradio_seek_thread(mm_radio_t* radio)
 	int freq = 0;
 	bool seek_stop = false;
 	MMMessageParamType param = {0,};
+	MMRadioRetry_t retry;
+	unsigned long long begin = _mmradio_get_time_usec();
 	struct v4l2_hw_freq_seek vs = {0,};
 
-	vs.tuner = TUNER_INDEX;
+	vs.tuner = radio->tuner_index;
 	vs.type = V4L2_TUNER_RADIO;
 	vs.wrap_around = DEFAULT_WRAP_AROUND;
 
@@ -1058,6 +1971,11 @@ __mmradio_seek_thread(mm_radio_t* radio)
 
 	MMRADIO_CHECK_INSTANCE( radio );
 
+	_mmradio_retry_init(&retry, &seek_retry_policy);
+
+	__mmradio_set_seek_raster(radio, &vs);
+	__mmradio_apply_seek_threshold(radio);
+
 	/* check direction */
 	switch( radio->seek_direction )
 	{
@@ -1075,14 +1993,17 @@ __mmradio_seek_thread(mm_radio_t* radio)
 	
 	while (  ! seek_stop )
 	{	
-		ret = ioctl( radio->radio_fd, VIDIOC_S_HW_FREQ_SEEK, &vs );
+		ret = __mmradio_seek_once( radio, &vs );
 
 		if( ret == -1 )
 		{
 			if ( errno == EAGAIN )
 			{
-				/* FIXIT : we need retrying code here */
-				MMRADIO_LOG_ERROR("scanning timeout\n");
+				MMRADIO_LOG_ERROR("seeking timeout\n");
+				if ( _mmradio_retry_backoff(&retry) )
+					continue;
+
+				MMRADIO_LOG_ERROR("giving up seeking after %d retries\n", retry.attempts);
 				goto SEEK_FAILED;
 			}
 			else if ( errno == EINVAL )
@@ -1097,6 +2018,8 @@ __mmradio_seek_thread(mm_radio_t* radio)
 			}
 		}
 
+		_mmradio_retry_reset(&retry);
+
 		/* now we can get new frequency from radio device */
 		ret = _mmradio_get_frequency(radio, &freq);
 		if ( ret )
@@ -1105,6 +2028,8 @@ __mmradio_seek_thread(mm_radio_t* radio)
 			goto SEEK_FAILED;
 		}
 
+		freq = __mmradio_snap_frequency(radio, freq);
+
 		MMRADIO_LOG_DEBUG("found frequency = %d\n", freq);
 
 		/* if same freq is found, ignore it and search next one. */
@@ -1139,26 +2064,24 @@ __mmradio_seek_thread(mm_radio_t* radio)
 		param.radio_scan.frequency = radio->prev_seek_freq = freq;
 		MMRADIO_LOG_DEBUG("seeking : new frequency : [%d]\n", param.radio_scan.frequency);
 		MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SEEK_FINISH, &param);
+		__mmradio_post_seek_result(radio, freq, &retry, begin);
 		seek_stop = true;
 	}
 
-	radio->seek_thread = 0;
-
 	MMRADIO_LOG_FLEAVE();
 
-	pthread_exit(NULL);
 	return;
 
 SEEK_FAILED:
 	/* freq -1 means it's failed to seek */
 	param.radio_scan.frequency = -1;
 	MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SEEK_FINISH, &param);
-	pthread_exit(NULL);
+	__mmradio_post_seek_result(radio, -1, &retry, begin);
 	return;
 }
 
-static bool
-__mmradio_post_message(mm_radio_t* radio, enum MMMessageType msgtype, MMMessageParamType* param)
+bool
+_mmradio_post_message(mm_radio_t* radio, enum MMMessageType msgtype, MMMessageParamType* param)
 {
 	MMRADIO_CHECK_INSTANCE( radio );
 
@@ -1179,8 +2102,8 @@ __mmradio_post_message(mm_radio_t* radio, enum MMMessageType msgtype, MMMessageP
 	return true;
 }
 
-static int
- __mmradio_check_state(mm_radio_t* radio, MMRadioCommand command)
+int
+ _mmradio_check_state(mm_radio_t* radio, MMRadioCommand command)
  {
 	 MMRadioStateType radio_state = MM_RADIO_STATE_NUM;
 
@@ -1242,6 +2165,13 @@ static int
  		}
  		break;
 
+ 		case MMRADIO_COMMAND_SWEEP:
+ 		{
+ 			if ( radio_state != MM_RADIO_STATE_READY )
+ 				goto INVALID_STATE;
+ 		}
+ 		break;
+
  		case MMRADIO_COMMAND_START_SCAN:
  		{
  			if ( radio_state == MM_RADIO_STATE_SCANNING )
@@ -1287,6 +2217,30 @@ static int
 		}
 		break;
 
+		case MMRADIO_COMMAND_SET_BACKEND:
+		case MMRADIO_COMMAND_SET_DEVICE:
+		{
+			if ( radio_state != MM_RADIO_STATE_NULL )
+				goto INVALID_STATE;
+		}
+		break;
+
+		case MMRADIO_COMMAND_SET_SCAN_TUNERS:
+		case MMRADIO_COMMAND_SET_SCAN_BATCH:
+		case MMRADIO_COMMAND_SET_SCAN_DEDUP:
+		{
+			if ( radio_state != MM_RADIO_STATE_NULL && radio_state != MM_RADIO_STATE_READY )
+				goto INVALID_STATE;
+		}
+		break;
+
+		case MMRADIO_COMMAND_SIGNAL_MONITOR:
+		{
+			if ( radio_state == MM_RADIO_STATE_NULL )
+				goto INVALID_STATE;
+		}
+		break;
+
  		default:
  			MMRADIO_LOG_DEBUG("not handled in FSM. don't care it\n");
  		break;
@@ -1388,7 +2342,6 @@ ASM_cb_result_t
 __mmradio_asm_callback(int handle, ASM_event_sources_t event_source, ASM_sound_commands_t command, unsigned int sound_status, void* cb_data)
 {
 	mm_radio_t* radio = (mm_radio_t*) cb_data;
-	int result = MM_ERROR_NONE;
 	ASM_cb_result_t	cb_res = ASM_CB_RES_NONE;
 
 	MMRADIO_LOG_FENTER();
@@ -1401,43 +2354,20 @@ __mmradio_asm_callback(int handle, ASM_event_sources_t event_source, ASM_sound_c
 		case ASM_COMMAND_PAUSE:
 		{
 			MMRADIO_LOG_DEBUG("ASM asked me to stop. cmd : %d\n", command);
-			switch(event_source)
-			{
-				case ASM_EVENT_SOURCE_CALL_START:
-				case ASM_EVENT_SOURCE_ALARM_START:
-				case ASM_EVENT_SOURCE_EARJACK_UNPLUG:
-				case ASM_EVENT_SOURCE_OTHER_APP:
-				{
-					radio->sm.by_asm_cb = MMRADIO_ASM_CB_POSTMSG;					
-					result = _mmradio_stop(radio);
-					if( result ) 
-					{
-						MMRADIO_LOG_ERROR("failed to stop radio\n");
-					}
-
-					MMRADIO_LOG_DEBUG("skip unrealize in asm callback")
-				}
-				break;
 
-				case ASM_EVENT_SOURCE_RESOURCE_CONFLICT:
-				default:
-				{
-					radio->sm.by_asm_cb = MMRADIO_ASM_CB_SKIP_POSTMSG;					
-					result = _mmradio_stop(radio);
-					if( result ) 
-					{
-						MMRADIO_LOG_ERROR("failed to stop radio\n");
-					}
-
-					radio->sm.by_asm_cb = MMRADIO_ASM_CB_POSTMSG;
-					result = _mmradio_unrealize(radio);
-					if ( result ) 
-					{
-						MMRADIO_LOG_ERROR("failed to unrealize radio\n");
-					}
-				}
-				break;
+			/* command holding the lock can be waiting for sound server, which is calling this now.
+			 * so, never block on it. tuner worker stops radio after the command
+			 */
+			if ( pthread_mutex_trylock(&radio->cmd_lock) == 0 )
+			{
+				__mmradio_asm_stop(radio, event_source);
+				MMRADIO_CMD_UNLOCK( radio );
+			}
+			else
+			{
+				__mmradio_defer_asm_stop(radio, event_source);
 			}
+
 			cb_res = ASM_CB_RES_STOP;
 		}
 		break;
@@ -1466,6 +2396,106 @@ __mmradio_asm_callback(int handle, ASM_event_sources_t event_source, ASM_sound_c
 	return cb_res;
 }
 
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_asm_stop()
+ * Desc   : stop radio as ASM asked. it's called with command lock.
+ *          stopping scan and unrealize release it while waiting for tuner worker
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] event_source : event which made ASM stop radio
+ * Return : None
+ *---------------------------------------------------------------------------*/
+static void
+__mmradio_asm_stop(mm_radio_t* radio, ASM_event_sources_t event_source)
+{
+	int result = MM_ERROR_NONE;
+
+	/* scan keeps its checkpoint. it can be resumed when ASM lets us play again */
+	if ( radio->current_state == MM_RADIO_STATE_SCANNING )
+	{
+		result = _mmradio_stop_scan(radio);
+		if ( result )
+			MMRADIO_LOG_ERROR("failed to stop scan\n");
+	}
+
+	switch(event_source)
+	{
+		case ASM_EVENT_SOURCE_CALL_START:
+		case ASM_EVENT_SOURCE_ALARM_START:
+		case ASM_EVENT_SOURCE_EARJACK_UNPLUG:
+		case ASM_EVENT_SOURCE_OTHER_APP:
+		{
+			radio->sm.by_asm_cb = MMRADIO_ASM_CB_POSTMSG;
+			result = _mmradio_stop(radio);
+			if( result )
+			{
+				MMRADIO_LOG_ERROR("failed to stop radio\n");
+			}
+
+			MMRADIO_LOG_DEBUG("skip unrealize in asm callback")
+		}
+		break;
+
+		case ASM_EVENT_SOURCE_RESOURCE_CONFLICT:
+		default:
+		{
+			radio->sm.by_asm_cb = MMRADIO_ASM_CB_SKIP_POSTMSG;
+			result = _mmradio_stop(radio);
+			if( result )
+			{
+				MMRADIO_LOG_ERROR("failed to stop radio\n");
+			}
+
+			radio->sm.by_asm_cb = MMRADIO_ASM_CB_POSTMSG;
+			result = _mmradio_unrealize(radio);
+			if ( result )
+			{
+				MMRADIO_LOG_ERROR("failed to unrealize radio\n");
+			}
+		}
+		break;
+	}
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_defer_asm_stop()
+ * Desc   : a command holds the lock when ASM asks to stop. scan and sweep stop at once by the token,
+ *          and states are changed by tuner worker when the command releases the lock
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] event_source : event which made ASM stop radio
+ * Return : None
+ *---------------------------------------------------------------------------*/
+static void
+__mmradio_defer_asm_stop(mm_radio_t* radio, ASM_event_sources_t event_source)
+{
+	MMRADIO_LOG_DEBUG("command is running. stop by ASM is deferred\n");
+
+	radio->asm_stop_src = event_source;
+	radio->asm_stop_pending = true;
+
+	if ( radio->current_state == MM_RADIO_STATE_SCANNING )
+		_mmradio_abort_scan(radio);
+
+	if ( _mmradio_submit_job(radio, (MMRadioJobFunc_t)__mmradio_asm_stop_job, "asm stop", NULL) != MM_ERROR_NONE )
+		MMRADIO_LOG_ERROR("failed to queue stop by ASM\n");
+}
+
+/* job of deferred stop. worker takes command lock after the command which held it */
+static void
+__mmradio_asm_stop_job(mm_radio_t* radio)
+{
+	MMRADIO_CMD_LOCK( radio );
+
+	if ( radio->asm_stop_pending )
+	{
+		radio->asm_stop_pending = false;
+		__mmradio_asm_stop(radio, (ASM_event_sources_t)radio->asm_stop_src);
+	}
+
+	MMRADIO_CMD_UNLOCK( radio );
+}
+
 int _mmradio_get_region_type(mm_radio_t*radio, MMRadioRegionType *type)
 {
 	MMRADIO_LOG_FENTER();
@@ -1480,6 +2510,15 @@ int _mmradio_get_region_type(mm_radio_t*radio, MMRadioRegionType *type)
 	return MM_ERROR_NONE;
 }
 
+/* region which is or will be applied at realize */
+MMRadioRegionType _mmradio_get_current_region(mm_radio_t* radio)
+{
+	if ( radio->region_setting.country == MM_RADIO_REGION_GROUP_NONE )
+		return RADIO_DEFAULT_REGION;
+
+	return radio->region_setting.country;
+}
+
 int _mmradio_get_region_frequency_range(mm_radio_t* radio, unsigned int *min_freq, unsigned int *max_freq)
 {
 	MMRADIO_LOG_FENTER();
@@ -1494,3 +2533,840 @@ int _mmradio_get_region_frequency_range(mm_radio_t* radio, unsigned int *min_fre
 	MMRADIO_LOG_FLEAVE();
 	return MM_ERROR_NONE;
 }
+
+int _mmradio_get_channel_spacing(mm_radio_t* radio, int *spacing)
+{
+	MMRADIO_LOG_FENTER();
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_GET_REGION );
+
+	return_val_if_fail( spacing, MM_ERROR_INVALID_ARGUMENT );
+
+	*spacing = radio->region_setting.channel_spacing;
+
+	MMRADIO_LOG_FLEAVE();
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_seek_profile()
+ * Desc   : set seek profile. tuner is programmed at next seek or scan.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] profile : seek profile
+ *	    [in] threshold : thresholds for MM_RADIO_SEEK_PROFILE_CUSTOM
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_seek_profile(mm_radio_t* radio, MMRadioSeekProfileType profile, const MMRadioSeekThreshold* threshold)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( profile >= MM_RADIO_SEEK_PROFILE_DEFAULT && profile < MM_RADIO_SEEK_PROFILE_NUM,
+		MM_ERROR_INVALID_ARGUMENT );
+
+	if ( profile == MM_RADIO_SEEK_PROFILE_CUSTOM )
+	{
+		return_val_if_fail( threshold, MM_ERROR_INVALID_ARGUMENT );
+
+		/* width of register fields */
+		if ( threshold->rssi < 0 || threshold->rssi > 0xff ||
+			threshold->snr < 0 || threshold->snr > 0xf ||
+			threshold->impulse < 0 || threshold->impulse > 0xf )
+		{
+			MMRADIO_LOG_ERROR("invalid seek threshold : rssi %d, snr %d, impulse %d\n",
+				threshold->rssi, threshold->snr, threshold->impulse);
+			return MM_ERROR_INVALID_ARGUMENT;
+		}
+
+		radio->seek_threshold = *threshold;
+	}
+	else
+	{
+		radio->seek_threshold = seek_profile_table[profile];
+	}
+
+	radio->seek_profile = profile;
+	radio->seek_threshold_dirty = true;
+
+	MMRADIO_LOG_DEBUG("seek profile : %d\n", profile);
+
+	MMRADIO_LOG_FLEAVE();
+	return MM_ERROR_NONE;
+}
+
+int
+_mmradio_get_seek_profile(mm_radio_t* radio, MMRadioSeekProfileType* profile, MMRadioSeekThreshold* threshold)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( profile, MM_ERROR_INVALID_ARGUMENT );
+
+	*profile = radio->seek_profile;
+
+	if ( threshold )
+		*threshold = radio->seek_threshold;
+
+	MMRADIO_LOG_FLEAVE();
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_apply_seek_threshold
+ * Desc   : program thresholds of seek profile if they are changed.
+ *          tuner's own ones are read before first apply and written back for default profile.
+ *          tuner which can't take them seeks with its own ones.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : None
+ *---------------------------------------------------------------------------*/
+static void
+__mmradio_apply_seek_threshold(mm_radio_t* radio)
+{
+	if ( ! radio->seek_threshold_dirty )
+		return;
+
+	radio->seek_threshold_dirty = false;
+	radio->seek_threshold_applied = false;
+
+	if ( radio->seek_profile == MM_RADIO_SEEK_PROFILE_DEFAULT )
+	{
+		/* nothing is programmed yet. tuner has its own ones */
+		if ( ! radio->seek_threshold_saved )
+			return;
+
+		if ( MMRADIO_TUNER_OP(radio, set_seek_threshold, &radio->seek_threshold_power_on) < 0 )
+			MMRADIO_LOG_WARNING("seek threshold is not restored : %s\n", strerror(errno));
+
+		return;
+	}
+
+	if ( ! radio->seek_threshold_saved )
+	{
+		if ( MMRADIO_TUNER_OP(radio, get_seek_threshold, &radio->seek_threshold_power_on) < 0 )
+		{
+			MMRADIO_LOG_WARNING("seek threshold is not applied. can't read tuner's own ones : %s\n", strerror(errno));
+			return;
+		}
+		radio->seek_threshold_saved = true;
+	}
+
+	if ( MMRADIO_TUNER_OP(radio, set_seek_threshold, &radio->seek_threshold) < 0 )
+	{
+		MMRADIO_LOG_WARNING("seek threshold is not applied : %s\n", strerror(errno));
+		return;
+	}
+
+	radio->seek_threshold_applied = true;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_seek_once()
+ * Desc   : find next station by the seek engine of the tuner.
+ *          in auto, software seek takes over if tuner refuses hardware seek.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] vs : seek request
+ * Return : zero on success, or -1 with errno
+ *---------------------------------------------------------------------------*/
+static int
+__mmradio_seek_once(mm_radio_t* radio, struct v4l2_hw_freq_seek* vs)
+{
+	if ( _mmradio_use_sw_seek(radio) )
+		return _mmradio_sw_seek(radio, vs);
+
+	if ( MMRADIO_TUNER_OP(radio, hw_seek, vs) == 0 )
+		return 0;
+
+	/* old drivers give EINVAL for unknown ioctl */
+	if ( radio->seek_engine == MM_RADIO_SEEK_ENGINE_AUTO && ( errno == ENOTTY || errno == EINVAL ) )
+	{
+		MMRADIO_LOG_DEBUG("hardware seek is refused : %s. using software seek\n", strerror(errno));
+		radio->hw_seek_unsupported = true;
+		return _mmradio_sw_seek(radio, vs);
+	}
+
+	return -1;
+}
+
+static void
+__mmradio_post_seek_result(mm_radio_t* radio, int freq, MMRadioRetry_t* retry, unsigned long long begin)
+{
+	MMMessageParamType param = {0,};
+	MMRadioSeekResult result;
+
+	memset(&result, 0, sizeof(MMRadioSeekResult));
+	result.frequency = freq;
+	result.profile = radio->seek_profile;
+	result.threshold = radio->seek_threshold;
+	result.applied = radio->seek_threshold_applied;
+
+	/* tuner is seeking with its own ones */
+	if ( ! radio->seek_threshold_applied && radio->seek_threshold_saved )
+		result.threshold = radio->seek_threshold_power_on;
+	result.retries = retry->retries;
+	result.elapsed = (int)( ( _mmradio_get_time_usec() - begin ) / 1000 );
+
+	/* result is valid only while callback is running */
+	param.data = &result;
+	MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SEEK_RESULT, &param);
+}
+
+static void
+__mmradio_get_scan_result(mm_radio_t* radio, MMRadioScanResult* result, int num_stations, MMRadioRetry_t* retry, unsigned long long begin, int error, bool out_of_budget)
+{
+	memset(result, 0, sizeof(MMRadioScanResult));
+	result->num_stations = num_stations;
+	result->retries = retry->retries;
+	result->elapsed = (int)( ( _mmradio_get_time_usec() - begin ) / 1000 );
+	result->error = error;
+	result->merged = radio->scan_results.merged;
+	result->out_of_budget = out_of_budget;
+}
+
+static void
+__mmradio_post_scan_result(mm_radio_t* radio, MMRadioScanResult* result)
+{
+	MMMessageParamType param = {0,};
+
+	/* result is valid only while callback is running */
+	param.data = result;
+	MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_SCAN_RESULT, &param);
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_freq_unit
+ * Desc   : get unit of tuner frequency from capability
+ * Param  :
+ *	    [in] capability : capability of tuner or band
+ * Return : unit of frequency, 0.1Hz
+ *---------------------------------------------------------------------------*/
+unsigned int
+_mmradio_get_freq_unit(unsigned int capability)
+{
+#ifdef V4L2_TUNER_CAP_1HZ
+	if ( capability & V4L2_TUNER_CAP_1HZ )
+		return FREQ_UNIT_1HZ;
+#endif
+	if ( capability & V4L2_TUNER_CAP_LOW )
+		return FREQ_UNIT_LOW;
+
+	return FREQ_UNIT_HIGH;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_query_bands
+ * Desc   : get frequency unit and FM range of tuner. radio->vt should have tuner info.
+ *          bands are enumerated if driver supports it. otherwise, range of tuner is used.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : none
+ *---------------------------------------------------------------------------*/
+static void
+__mmradio_query_bands(mm_radio_t* radio)
+{
+	struct v4l2_frequency_band band;
+	int num_bands = 0;
+	int index = 0;
+
+	radio->freq_unit = _mmradio_get_freq_unit((radio->vt).capability);
+	radio->hw_band_min = RADIO_FREQ_FORMAT_GET(radio, (radio->vt).rangelow);
+	radio->hw_band_max = RADIO_FREQ_FORMAT_GET(radio, (radio->vt).rangehigh);
+
+	for ( index = 0; ; index++ )
+	{
+		int low = 0;
+		int high = 0;
+
+		memset(&band, 0, sizeof(band));
+		band.tuner = radio->tuner_index;
+		band.type = V4L2_TUNER_RADIO;
+		band.index = index;
+
+		if ( MMRADIO_TUNER_OP(radio, enum_freq_bands, &band) < 0 )
+			break;
+
+		if ( ! ( band.modulation & V4L2_BAND_MODULATION_FM ) )
+			continue;
+
+		/* all FM bands are merged */
+		low = RADIO_FREQ_FORMAT_GET(radio, band.rangelow);
+		high = RADIO_FREQ_FORMAT_GET(radio, band.rangehigh);
+
+		if ( num_bands == 0 || low < radio->hw_band_min )
+			radio->hw_band_min = low;
+		if ( num_bands == 0 || high > radio->hw_band_max )
+			radio->hw_band_max = high;
+
+		num_bands++;
+	}
+
+	MMRADIO_LOG_DEBUG("tuner unit : %u.%uHz, FM range : %d ~ %d KHz (%d band(s))\n",
+		radio->freq_unit / 10, radio->freq_unit % 10, radio->hw_band_min, radio->hw_band_max, num_bands);
+}
+
+/* highest legal frequency of the region */
+static int
+__mmradio_get_raster_max(mm_radio_t* radio)
+{
+	int spacing = radio->region_setting.channel_spacing;
+	int band_min = radio->region_setting.band_min;
+	int band_max = radio->region_setting.band_max;
+
+	if ( spacing <= 0 )
+		return band_max;
+
+	return band_min + ( ( band_max - band_min ) / spacing ) * spacing;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_snap_frequency
+ * Desc   : get the nearest legal frequency in the region
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] freq : frequency, KHz
+ * Return : frequency on channel raster, KHz
+ *---------------------------------------------------------------------------*/
+static int
+__mmradio_snap_frequency(mm_radio_t* radio, int freq)
+{
+	int spacing = radio->region_setting.channel_spacing;
+	int band_min = radio->region_setting.band_min;
+	int raster_max = __mmradio_get_raster_max(radio);
+
+	if ( spacing <= 0 || band_min <= 0 )
+		return freq;
+
+	if ( freq <= band_min )
+		return band_min;
+
+	if ( freq >= raster_max )
+		return raster_max;
+
+	return band_min + ( ( freq - band_min + spacing / 2 ) / spacing ) * spacing;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_set_seek_raster
+ * Desc   : let hardware seek visit only legal frequencies of the region
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [out] vs : seek request
+ * Return : none
+ *---------------------------------------------------------------------------*/
+static void
+__mmradio_set_seek_raster(mm_radio_t* radio, struct v4l2_hw_freq_seek* vs)
+{
+	/* Hz. zero means driver default */
+	vs->spacing = radio->region_setting.channel_spacing * 1000;
+
+#ifdef V4L2_TUNER_CAP_HWSEEK_BOUNDED
+	/* without this capability, driver seeks in the band range of tuner */
+	if ( (radio->vt).capability & V4L2_TUNER_CAP_HWSEEK_BOUNDED )
+	{
+		vs->rangelow = RADIO_FREQ_FORMAT_SET(radio, radio->region_setting.band_min);
+		vs->rangehigh = RADIO_FREQ_FORMAT_SET(radio, __mmradio_get_raster_max(radio));
+	}
+#endif
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_backend()
+ * Desc   : replace tuner backend of radio handle
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] backend : tuner backend operations
+ *	    [in] config : backend specific configuration
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_backend(mm_radio_t* radio, const MMRadioBackendOps* backend, const void* config)
+{
+	void* priv = NULL;
+
+	MMRADIO_LOG_FENTER();
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SET_BACKEND );
+
+	/* parked device belongs to old one */
+	_mmradio_unpark( radio, true );
+
+	return_val_if_fail( backend, MM_ERROR_INVALID_ARGUMENT );
+
+	/* device should be closed to change backend */
+	if ( radio->radio_fd >= 0 )
+	{
+		MMRADIO_LOG_ERROR("radio device is still opened\n");
+		return MM_ERROR_RADIO_INVALID_STATE;
+	}
+
+	/* secondary tuner of refresh belongs to old one */
+	if ( radio->refresh_thread )
+	{
+		MMRADIO_LOG_ERROR("station refresh is running\n");
+		return MM_ERROR_RADIO_INVALID_STATE;
+	}
+
+	priv = backend->create(config);
+	if ( ! priv )
+	{
+		MMRADIO_LOG_ERROR("failed to create tuner backend [%s]\n", backend->name);
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	if ( radio->backend_priv )
+		radio->backend->destroy(radio->backend_priv);
+
+	radio->backend = backend;
+	radio->backend_priv = priv;
+
+	MMRADIO_LOG_DEBUG("tuner backend : %s\n", backend->name);
+
+	MMRADIO_LOG_FLEAVE();
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_device()
+ * Desc   : bind radio handle to the device and the tuner of it
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] device : path of device. NULL means default device
+ *	    [in] tuner_index : index of tuner
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_device(mm_radio_t* radio, const char* device, int tuner_index)
+{
+	MMRADIO_LOG_FENTER();
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SET_DEVICE );
+
+	/* parked device belongs to old one */
+	_mmradio_unpark( radio, true );
+
+	return_val_if_fail( tuner_index >= 0, MM_ERROR_INVALID_ARGUMENT );
+
+	if ( ! device )
+		device = DEFAULT_DEVICE;
+
+	if ( strlen(device) >= sizeof(radio->device) )
+	{
+		MMRADIO_LOG_ERROR("too long device path : %s\n", device);
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	/* device should be closed to change it */
+	if ( radio->radio_fd >= 0 )
+	{
+		MMRADIO_LOG_ERROR("radio device is still opened\n");
+		return MM_ERROR_RADIO_INVALID_STATE;
+	}
+
+	strncpy(radio->device, device, sizeof(radio->device) - 1);
+	radio->device[sizeof(radio->device) - 1] = '\0';
+	radio->tuner_index = tuner_index;
+
+	MMRADIO_LOG_DEBUG("radio device : %s, tuner : %d\n", radio->device, radio->tuner_index);
+
+	MMRADIO_LOG_FLEAVE();
+	return MM_ERROR_NONE;
+}
+
+unsigned long long
+_mmradio_get_time_usec(void)
+{
+	struct timespec ts = {0,};
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+void
+_mmradio_retry_init(MMRadioRetry_t* retry, const MMRadioRetryPolicy_t* policy)
+{
+	memset(retry, 0, sizeof(MMRadioRetry_t));
+	retry->policy = policy;
+	retry->cancel_fd = -1;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_wait_cancel()
+ * Desc   : sleep until timeout, or until cancellation event is readable. event is not consumed
+ * Param  :
+ *	    [in] fd : cancellation event. -1 means just sleeping
+ *	    [in] usec : timeout
+ * Return : true if it's woken up by event
+ *---------------------------------------------------------------------------*/
+bool
+_mmradio_wait_cancel(int fd, int usec)
+{
+	struct pollfd pfd;
+
+	if ( fd < 0 )
+	{
+		usleep(usec);
+		return false;
+	}
+
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	/* msec of poll is rounded up not to return early */
+	if ( poll(&pfd, 1, ( usec + 999 ) / 1000) > 0 )
+		return true;
+
+	return false;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_retry_backoff()
+ * Desc   : wait for backoff if another attempt is allowed.
+ *          attempts of a run of failures are bounded by count and deadline.
+ * Param  :
+ *	    [in] retry : retry state
+ * Return : true if caller should try again
+ *---------------------------------------------------------------------------*/
+bool
+_mmradio_retry_backoff(MMRadioRetry_t* retry)
+{
+	const MMRadioRetryPolicy_t* policy = retry->policy;
+	unsigned long long now = _mmradio_get_time_usec();
+
+	if ( ! retry->first_failure )
+	{
+		retry->first_failure = now;
+		retry->attempts = 0;
+		retry->backoff = policy->initial_backoff;
+	}
+
+	if ( retry->attempts >= policy->max_retries )
+		return false;
+
+	/* no retry which can't finish before deadline */
+	if ( now + (unsigned long long)retry->backoff * 1000 > retry->first_failure + (unsigned long long)policy->deadline * 1000 )
+		return false;
+
+	if ( _mmradio_wait_cancel(retry->cancel_fd, retry->backoff * 1000) )
+		return false;
+
+	retry->attempts++;
+	retry->retries++;
+
+	retry->backoff *= 2;
+	if ( retry->backoff > policy->max_backoff )
+		retry->backoff = policy->max_backoff;
+
+	return true;
+}
+
+/* run of failures is over. total count of retries is kept */
+void
+_mmradio_retry_reset(MMRadioRetry_t* retry)
+{
+	retry->first_failure = 0;
+}
+
+static void
+__mmradio_update_shadow_freq(mm_radio_t* radio, int freq)
+{
+	pthread_mutex_lock(&radio->shadow_lock);
+
+	/* signal strength is not valid anymore if frequency is changed */
+	if ( radio->shadow.freq != freq )
+		radio->shadow.signal_time = 0;
+
+	radio->shadow.freq = freq;
+	radio->shadow.freq_time = _mmradio_get_time_usec();
+
+	pthread_mutex_unlock(&radio->shadow_lock);
+}
+
+static void
+__mmradio_update_shadow_signal(mm_radio_t* radio, int signal)
+{
+	pthread_mutex_lock(&radio->shadow_lock);
+
+	radio->shadow.signal = signal;
+	radio->shadow.signal_time = _mmradio_get_time_usec();
+
+	pthread_mutex_unlock(&radio->shadow_lock);
+}
+
+static void
+__mmradio_invalidate_shadow(mm_radio_t* radio)
+{
+	pthread_mutex_lock(&radio->shadow_lock);
+
+	radio->shadow.freq_time = 0;
+	radio->shadow.signal_time = 0;
+
+	pthread_mutex_unlock(&radio->shadow_lock);
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_read_shadow()
+ * Desc   : read a value of shadow if it's not older than max_age
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] value : address of shadow value
+ *	    [in] time : address of time of shadow value
+ *	    [in] max_age : acceptable age, msec. negative value accepts any age
+ *	    [out] pValue : value of shadow
+ * Return : true if value is available
+ *---------------------------------------------------------------------------*/
+static bool
+__mmradio_read_shadow(mm_radio_t* radio, int* value, unsigned long long* time, int max_age, int* pValue)
+{
+	bool fresh = false;
+
+	pthread_mutex_lock(&radio->shadow_lock);
+
+	if ( *time )
+	{
+		if ( max_age < 0 || _mmradio_get_time_usec() - *time <= (unsigned long long)max_age * 1000 )
+		{
+			*pValue = *value;
+			fresh = true;
+		}
+	}
+
+	pthread_mutex_unlock(&radio->shadow_lock);
+
+	return fresh;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_lock_for_refresh()
+ * Desc   : take command lock to refresh shadow.
+ *          if other command is running and it's not forced, it doesn't wait.
+ *          the running command will update shadow anyway.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] max_age : acceptable age, msec. zero means forced refresh
+ * Return : true if command lock is taken
+ *---------------------------------------------------------------------------*/
+static bool
+__mmradio_lock_for_refresh(mm_radio_t* radio, int max_age)
+{
+	if ( max_age == 0 )
+	{
+		MMRADIO_CMD_LOCK( radio );
+		return true;
+	}
+
+	return ( pthread_mutex_trylock( &radio->cmd_lock ) == 0 );
+}
+
+int
+_mmradio_get_signal_strength(mm_radio_t* radio, int* value)
+{
+	struct v4l2_tuner vt = {0,};
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_DEVICE_STATE( radio );
+
+	return_val_if_fail( value, MM_ERROR_INVALID_ARGUMENT );
+
+	vt.index = radio->tuner_index;
+
+	if ( MMRADIO_TUNER_OP(radio, get_tuner, &vt) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to get tuner\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	*value = vt.signal;
+
+	__mmradio_update_shadow_signal(radio, vt.signal);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_tuner_status()
+ * Desc   : get snapshot of tuner status. backend gives it at once if it can.
+ *          otherwise, generic V4L2 requests are used for frequency, signal and stereo.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [out] status : tuner status
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_get_tuner_status(mm_radio_t* radio, MMRadioTunerStatus* status)
+{
+	struct v4l2_tuner vt = {0,};
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_GET_FREQ );
+	MMRADIO_CHECK_DEVICE_STATE( radio );
+
+	return_val_if_fail( status, MM_ERROR_INVALID_ARGUMENT );
+
+	if ( MMRADIO_TUNER_OP(radio, get_status, status) == 0 )
+	{
+		/* frequency first. it invalidates signal of old frequency */
+		if ( status->valid & MM_RADIO_STATUS_FREQUENCY )
+		{
+			radio->freq = status->frequency;
+			__mmradio_update_shadow_freq(radio, status->frequency);
+		}
+
+		if ( status->valid & MM_RADIO_STATUS_SIGNAL )
+			__mmradio_update_shadow_signal(radio, status->signal);
+
+		MMRADIO_LOG_FLEAVE();
+		return MM_ERROR_NONE;
+	}
+
+	if ( errno != ENOTTY )
+	{
+		MMRADIO_LOG_ERROR("failed to get tuner status : %s\n", strerror(errno));
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	memset(status, 0, sizeof(MMRadioTunerStatus));
+
+	ret = _mmradio_get_frequency(radio, &status->frequency);
+	if ( ret != MM_ERROR_NONE )
+		return ret;
+
+	vt.index = radio->tuner_index;
+
+	if ( MMRADIO_TUNER_OP(radio, get_tuner, &vt) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to get tuner\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	__mmradio_update_shadow_signal(radio, vt.signal);
+
+	status->valid = MM_RADIO_STATUS_FREQUENCY | MM_RADIO_STATUS_SIGNAL | MM_RADIO_STATUS_STEREO;
+	status->signal = vt.signal;
+	status->stereo = ( vt.rxsubchans & V4L2_TUNER_SUB_STEREO ) ? 1 : 0;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_cached_frequency()
+ * Desc   : get frequency from shadow. device is accessed only when shadow is too old.
+ *          NOTE : it should be called without command lock.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] max_age : acceptable age of value, msec. zero means reading from device always
+ *	    [out] pFreq : frequency, KHz
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_get_cached_frequency(mm_radio_t* radio, int max_age, int* pFreq)
+{
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	return_val_if_fail( pFreq, MM_ERROR_INVALID_ARGUMENT );
+
+	if ( max_age < 0 )
+		max_age = SHADOW_DEFAULT_MAX_AGE;
+
+	if ( max_age && __mmradio_read_shadow(radio, &radio->shadow.freq, &radio->shadow.freq_time, max_age, pFreq) )
+		return MM_ERROR_NONE;
+
+	if ( ! __mmradio_lock_for_refresh(radio, max_age) )
+	{
+		/* someone is tuning now. previous value is better than waiting */
+		if ( __mmradio_read_shadow(radio, &radio->shadow.freq, &radio->shadow.freq_time, -1, pFreq) )
+			return MM_ERROR_NONE;
+
+		MMRADIO_CMD_LOCK( radio );
+	}
+
+	ret = _mmradio_get_frequency(radio, pFreq);
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_tuned_frequency()
+ * Desc   : get the frequency tuner was tuned to successfully last time, from shadow.
+ *          it never takes command lock.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : frequency, KHz. zero if it's not known
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_get_tuned_frequency(mm_radio_t* radio)
+{
+	int freq = 0;
+
+	if ( ! __mmradio_read_shadow(radio, &radio->shadow.freq, &radio->shadow.freq_time, -1, &freq) )
+		return 0;
+
+	return freq;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_cached_signal_strength()
+ * Desc   : get signal strength from shadow. device is accessed only when shadow is too old.
+ *          NOTE : it should be called without command lock.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] max_age : acceptable age of value, msec. zero means reading from device always
+ *	    [out] value : signal strength
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_get_cached_signal_strength(mm_radio_t* radio, int max_age, int* value)
+{
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	return_val_if_fail( value, MM_ERROR_INVALID_ARGUMENT );
+
+	if ( max_age < 0 )
+		max_age = SHADOW_DEFAULT_MAX_AGE;
+
+	if ( max_age && __mmradio_read_shadow(radio, &radio->shadow.signal, &radio->shadow.signal_time, max_age, value) )
+		return MM_ERROR_NONE;
+
+	if ( ! __mmradio_lock_for_refresh(radio, max_age) )
+	{
+		/* someone is tuning now. previous value is better than waiting */
+		if ( __mmradio_read_shadow(radio, &radio->shadow.signal, &radio->shadow.signal_time, -1, value) )
+			return MM_ERROR_NONE;
+
+		MMRADIO_CMD_LOCK( radio );
+	}
+
+	ret = _mmradio_get_signal_strength(radio, value);
+
+	MMRADIO_CMD_UNLOCK( radio );
+
+	MMRADIO_LOG_DEBUG("signal strength = %d\n", *value);
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
@@ -0,0 +1,616 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL DATA TYPE DEFINITIONS:
+---------------------------------------------------------------------------*/
+typedef struct {
+	int frequency;			/* KHz */
+	int signal;
+} MMRadioScanHit_t;
+
+struct MMRadioParallelScan;
+
+/* a tuner and its range of band. channels in (start, high] are scanned */
+typedef struct {
+	struct MMRadioParallelScan* pscan;
+	MMRadioTuner_t dev;
+	bool cloned;				/* priv and fd of dev are ours. otherwise they are the ones of the handle */
+
+	int start;					/* KHz. tuner is tuned here first */
+	int high;					/* KHz. the last channel to be reported */
+	bool top;					/* high is the top of channel raster. seek stops there at band limit too */
+
+	pthread_t thread;
+	pthread_t abort_thread;		/* tunes the tuner to abort seek on stop */
+	MMRadioScanHit_t* hits;		/* in order of frequency. written by worker only */
+	int capacity;
+	int num_hits;
+	bool done;
+	int error;					/* errno of the failure. zero if worker is done without error */
+	MMRadioRetry_t retry;
+} MMRadioScanWorker_t;
+
+typedef struct MMRadioParallelScan {
+	mm_radio_t* radio;
+	struct v4l2_hw_freq_seek vs;	/* template of seek request */
+	int low;						/* KHz. band_min, or checkpoint of resumed scan */
+	pthread_mutex_t lock;
+	int notify_fd;					/* eventfd. workers write it when they find a station or finish */
+	bool stop;
+	int num_workers;
+	MMRadioScanWorker_t workers[MM_RADIO_MAX_SCAN_TUNERS + 1];
+} MMRadioParallelScan_t;
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static bool	__mmradio_pscan_open_tuner(MMRadioParallelScan_t* pscan, MMRadioScanWorker_t* worker, const MMRadioScanTuner_t* tuner);
+static void	__mmradio_pscan_close_tuner(MMRadioParallelScan_t* pscan, MMRadioScanWorker_t* worker);
+static void	__mmradio_pscan_partition(MMRadioParallelScan_t* pscan);
+static void*	__mmradio_pscan_worker(void* data);
+static void*	__mmradio_pscan_abort(void* data);
+static int		__mmradio_pscan_signal(MMRadioScanWorker_t* worker, int freq);
+static bool	__mmradio_pscan_is_top_station(MMRadioScanWorker_t* worker, int freq, int signal);
+static int		__mmradio_pscan_seek(MMRadioScanWorker_t* worker, struct v4l2_hw_freq_seek* vs, int* freq);
+static bool	__mmradio_pscan_wait(MMRadioParallelScan_t* pscan, MMRadioScanWorker_t* worker, int index);
+static void	__mmradio_pscan_post(MMRadioParallelScan_t* pscan, const MMRadioScanHit_t* hit);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_scan_tuners()
+ * Desc   : set additional tuners of scan. device paths are copied
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] tuners : additional tuners. can be NULL if num_tuners is zero
+ *	    [in] num_tuners : number of tuners. zero means scan by the tuner of the handle only
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_scan_tuners(mm_radio_t* radio, const MMRadioScanTuner* tuners, int num_tuners)
+{
+	int i = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SET_SCAN_TUNERS );
+
+	return_val_if_fail( num_tuners >= 0 && num_tuners <= MM_RADIO_MAX_SCAN_TUNERS, MM_ERROR_INVALID_ARGUMENT );
+	return_val_if_fail( tuners || num_tuners == 0, MM_ERROR_INVALID_ARGUMENT );
+
+	for ( i = 0; i < num_tuners; i++ )
+	{
+		return_val_if_fail( tuners[i].device, MM_ERROR_INVALID_ARGUMENT );
+		return_val_if_fail( tuners[i].tuner_index >= 0, MM_ERROR_INVALID_ARGUMENT );
+		return_val_if_fail( strlen(tuners[i].device) < sizeof(radio->scan_tuners[i].device), MM_ERROR_INVALID_ARGUMENT );
+	}
+
+	for ( i = 0; i < num_tuners; i++ )
+	{
+		strncpy(radio->scan_tuners[i].device, tuners[i].device, sizeof(radio->scan_tuners[i].device) - 1);
+		radio->scan_tuners[i].device[sizeof(radio->scan_tuners[i].device) - 1] = '\0';
+		radio->scan_tuners[i].tuner_index = tuners[i].tuner_index;
+
+		MMRADIO_LOG_DEBUG("scan tuner %d : %s, tuner %d\n", i, radio->scan_tuners[i].device, radio->scan_tuners[i].tuner_index);
+	}
+
+	radio->num_scan_tuners = num_tuners;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_parallel_scan()
+ * Desc   : scan band by the tuner of the handle and additional tuners at once.
+ *          band is divided into ranges of same number of channels, and a worker seeks up in each range.
+ *          it's called from scan thread after the tuner of the handle is tuned to low.
+ *          results are posted by the caller thread in order of frequency as workers find them.
+ *          on stop, seeks of additional tuners are aborted by tuning, and workers are joined.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] vs : seek request of the handle. spacing and range are used
+ *	    [in] low : KHz. channels above it are scanned
+ *	    [out] num_stations : number of stations posted
+ *	    [in/out] retry : retries of workers are added
+ * Return : zero on success, MM_ERROR_RADIO_NO_OP if serial scan should be used, or other error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_parallel_scan(mm_radio_t* radio, const struct v4l2_hw_freq_seek* vs, int low, int* num_stations, MMRadioRetry_t* retry)
+{
+	MMRadioParallelScan_t* pscan = NULL;
+	int error = MM_ERROR_NONE;
+	int last = 0;
+	int i = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	*num_stations = 0;
+
+	if ( radio->region_setting.channel_spacing <= 0 || radio->region_setting.band_min <= 0 ||
+		low >= radio->region_setting.band_max )
+		return MM_ERROR_RADIO_NO_OP;
+
+	pscan = (MMRadioParallelScan_t*)malloc(sizeof(MMRadioParallelScan_t));
+	if ( ! pscan )
+		return MM_ERROR_RADIO_NO_OP;
+
+	memset(pscan, 0, sizeof(MMRadioParallelScan_t));
+	pscan->radio = radio;
+	pscan->vs = *vs;
+	pscan->low = ( low > radio->region_setting.band_min ) ? low : radio->region_setting.band_min;
+	pscan->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if ( pscan->notify_fd < 0 )
+	{
+		free(pscan);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+	pthread_mutex_init(&pscan->lock, NULL);
+
+	/* tuner of the handle takes the first range */
+	pscan->workers[0].pscan = pscan;
+	pscan->workers[0].dev.priv = radio->backend_priv;
+	pscan->workers[0].dev.fd = radio->radio_fd;
+	pscan->workers[0].dev.tuner_index = radio->tuner_index;
+	pscan->workers[0].dev.freq_unit = radio->freq_unit;
+	pscan->num_workers = 1;
+
+	for ( i = 0; i < radio->num_scan_tuners; i++ )
+	{
+		if ( __mmradio_pscan_open_tuner(pscan, &pscan->workers[pscan->num_workers], &radio->scan_tuners[i]) )
+			pscan->num_workers++;
+	}
+
+	if ( pscan->num_workers < 2 )
+	{
+		MMRADIO_LOG_ERROR("no additional tuner is available. scanning by one tuner\n");
+		error = MM_ERROR_RADIO_NO_OP;
+		goto DONE;
+	}
+
+	__mmradio_pscan_partition(pscan);
+
+	for ( i = 0; i < pscan->num_workers; i++ )
+	{
+		MMRadioScanWorker_t* worker = &pscan->workers[i];
+
+		worker->capacity = ( worker->high - worker->start ) / radio->region_setting.channel_spacing + 1;
+		worker->hits = (MMRadioScanHit_t*)malloc(sizeof(MMRadioScanHit_t) * worker->capacity);
+		_mmradio_retry_init(&worker->retry, retry->policy);
+		worker->retry.cancel_fd = radio->scan_cancel_fd;
+
+		if ( ! worker->hits || pthread_create(&worker->thread, NULL, __mmradio_pscan_worker, (void*)worker) )
+		{
+			MMRADIO_LOG_ERROR("failed to create thread : scan worker %d\n", i);
+			worker->thread = 0;
+			worker->done = true;
+			worker->error = ENOMEM;
+		}
+	}
+
+	/* merge. ranges are in order, and so are hits of a range */
+	for ( i = 0; i < pscan->num_workers && error == MM_ERROR_NONE; i++ )
+	{
+		MMRadioScanWorker_t* worker = &pscan->workers[i];
+		int index = 0;
+
+		while ( __mmradio_pscan_wait(pscan, worker, index) )
+		{
+			MMRadioScanHit_t hit = worker->hits[index++];
+
+			/* same station seen by two tuners */
+			if ( hit.frequency <= last )
+				continue;
+
+			__mmradio_pscan_post(pscan, &hit);
+			last = hit.frequency;
+			(*num_stations)++;
+		}
+
+		/* nothing is posted after stop */
+		if ( radio->stop_scan )
+			break;
+
+		if ( worker->error )
+		{
+			MMRADIO_LOG_ERROR("worker %d failed : %s\n", i, strerror(worker->error));
+
+			/* same as serial scan. software seek takes over in auto */
+			if ( ( worker->error == ENOTTY || worker->error == EINVAL ) &&
+				*num_stations == 0 && radio->seek_engine == MM_RADIO_SEEK_ENGINE_AUTO )
+			{
+				radio->hw_seek_unsupported = true;
+				error = MM_ERROR_RADIO_NO_OP;
+			}
+			else
+			{
+				error = MM_ERROR_RADIO_INTERNAL;
+			}
+		}
+	}
+
+DONE:
+	pthread_mutex_lock(&pscan->lock);
+	pscan->stop = true;
+	pthread_mutex_unlock(&pscan->lock);
+
+	/* seeks in progress are aborted by tuning. the tuner of the handle is tuned by stop_scan.
+	 * others are tuned at the same time not to wait for them one by one.
+	 */
+	for ( i = 1; i < pscan->num_workers && radio->stop_scan; i++ )
+	{
+		MMRadioScanWorker_t* worker = &pscan->workers[i];
+
+		if ( ! worker->thread || worker->done )
+			continue;
+
+		if ( pthread_create(&worker->abort_thread, NULL, __mmradio_pscan_abort, (void*)worker) )
+		{
+			worker->abort_thread = 0;
+			__mmradio_pscan_abort(worker);
+		}
+	}
+
+	for ( i = 0; i < pscan->num_workers; i++ )
+	{
+		MMRadioScanWorker_t* worker = &pscan->workers[i];
+
+		if ( worker->abort_thread )
+			pthread_join(worker->abort_thread, NULL);
+
+		if ( worker->thread )
+			pthread_join(worker->thread, NULL);
+
+		retry->retries += worker->retry.retries;
+
+		MMRADIO_FREEIF( worker->hits );
+		__mmradio_pscan_close_tuner(pscan, worker);
+	}
+
+	MMRADIO_LOG_DEBUG("%d stations by %d tuners\n", *num_stations, pscan->num_workers);
+
+	pthread_mutex_destroy(&pscan->lock);
+	close(pscan->notify_fd);
+	free(pscan);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return error;
+}
+
+static bool
+__mmradio_pscan_open_tuner(MMRadioParallelScan_t* pscan, MMRadioScanWorker_t* worker, const MMRadioScanTuner_t* tuner)
+{
+	mm_radio_t* radio = pscan->radio;
+	struct v4l2_tuner vt;
+
+	memset(worker, 0, sizeof(MMRadioScanWorker_t));
+	worker->pscan = pscan;
+	worker->dev.fd = -1;
+	worker->cloned = true;
+
+	/* same backend as the handle. simulated one sees same stations */
+	worker->dev.priv = radio->backend->clone(radio->backend_priv);
+	if ( ! worker->dev.priv )
+		return false;
+
+	worker->dev.fd = radio->backend->open(worker->dev.priv, tuner->device);
+	if ( worker->dev.fd < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to open %s : %s\n", tuner->device, strerror(errno));
+		__mmradio_pscan_close_tuner(pscan, worker);
+		return false;
+	}
+
+	worker->dev.tuner_index = tuner->tuner_index;
+
+	memset(&vt, 0, sizeof(struct v4l2_tuner));
+	vt.index = worker->dev.tuner_index;
+	if ( radio->backend->get_tuner(worker->dev.priv, worker->dev.fd, &vt) < 0 )
+	{
+		MMRADIO_LOG_ERROR("tuner %d of %s is not available\n", worker->dev.tuner_index, tuner->device);
+		__mmradio_pscan_close_tuner(pscan, worker);
+		return false;
+	}
+
+	worker->dev.freq_unit = _mmradio_get_freq_unit(vt.capability);
+
+	/* same thresholds as the tuner of the handle */
+	if ( radio->seek_threshold_applied )
+		radio->backend->set_seek_threshold(worker->dev.priv, worker->dev.fd, &radio->seek_threshold);
+
+	return true;
+}
+
+static void
+__mmradio_pscan_close_tuner(MMRadioParallelScan_t* pscan, MMRadioScanWorker_t* worker)
+{
+	mm_radio_t* radio = pscan->radio;
+
+	if ( ! worker->cloned )
+		return;
+
+	if ( worker->dev.fd >= 0 )
+	{
+		radio->backend->close(worker->dev.priv, worker->dev.fd);
+		worker->dev.fd = -1;
+	}
+
+	if ( worker->dev.priv )
+	{
+		radio->backend->destroy(worker->dev.priv);
+		worker->dev.priv = NULL;
+	}
+}
+
+/* channels from low to the top of channel raster are divided evenly.
+ * low is never reported, and the top is reported only if it's on air as serial scan does.
+ */
+static void
+__mmradio_pscan_partition(MMRadioParallelScan_t* pscan)
+{
+	mm_radio_t* radio = pscan->radio;
+	int spacing = radio->region_setting.channel_spacing;
+	int low = pscan->low;
+	int channels = ( radio->region_setting.band_max - low ) / spacing;
+	int i = 0;
+
+	for ( i = 0; i < pscan->num_workers; i++ )
+	{
+		MMRadioScanWorker_t* worker = &pscan->workers[i];
+
+		worker->start = low + ( channels * i / pscan->num_workers ) * spacing;
+		worker->high = low + ( channels * ( i + 1 ) / pscan->num_workers ) * spacing;
+
+		worker->top = ( i == pscan->num_workers - 1 );
+
+		MMRADIO_LOG_DEBUG("worker %d : (%d, %d] KHz\n", i, worker->start, worker->high);
+	}
+}
+
+static void*
+__mmradio_pscan_worker(void* data)
+{
+	MMRadioScanWorker_t* worker = (MMRadioScanWorker_t*)data;
+	MMRadioParallelScan_t* pscan = worker->pscan;
+	mm_radio_t* radio = pscan->radio;
+	int spacing = radio->region_setting.channel_spacing;
+	struct v4l2_hw_freq_seek vs = pscan->vs;
+	int prev_freq = worker->start;
+	int error = 0;
+
+	vs.tuner = worker->dev.tuner_index;
+
+	/* without bounded seek, driver seeks in whole band. it's stopped after the range anyway.
+	 * range never goes over the top of channel raster
+	 */
+	if ( vs.rangehigh )
+	{
+		vs.rangelow = (unsigned int)((unsigned long long)worker->start * 10000 / worker->dev.freq_unit);
+		vs.rangehigh = (unsigned int)((unsigned long long)( worker->top ? worker->high : worker->high + spacing ) * 10000 / worker->dev.freq_unit);
+	}
+
+	if ( _mmradio_tune_raw(radio, &worker->dev, worker->start) < 0 )
+		error = errno;
+
+	while ( ! error && ! pscan->stop && ! radio->stop_scan )
+	{
+		struct v4l2_tuner vt;
+		int freq = 0;
+
+		if ( __mmradio_pscan_seek(worker, &vs, &freq) < 0 )
+		{
+			/* seek is aborted by stop */
+			if ( pscan->stop || radio->stop_scan )
+				break;
+
+			if ( errno == EAGAIN && _mmradio_retry_backoff(&worker->retry) )
+				continue;
+
+			error = errno;
+			break;
+		}
+
+		_mmradio_retry_reset(&worker->retry);
+
+		/* end of range, or wrapped around */
+		if ( freq > worker->high || freq <= prev_freq )
+			break;
+
+		prev_freq = freq;
+
+		memset(&vt, 0, sizeof(struct v4l2_tuner));
+		vt.index = worker->dev.tuner_index;
+		if ( MMRADIO_TIMED(radio, MMRADIO_STAT_TUNER_OP(get_tuner),
+				radio->backend->get_tuner(worker->dev.priv, worker->dev.fd, &vt)) < 0 )
+			vt.signal = 0;
+
+		/* seek stops at the top channel also when it runs into band limit. same check with serial scan */
+		if ( worker->top && freq >= worker->high && ! __mmradio_pscan_is_top_station(worker, freq, vt.signal) )
+			break;
+
+		pthread_mutex_lock(&pscan->lock);
+		if ( worker->num_hits < worker->capacity )
+		{
+			worker->hits[worker->num_hits].frequency = freq;
+			worker->hits[worker->num_hits].signal = vt.signal;
+			worker->num_hits++;
+		}
+		pthread_mutex_unlock(&pscan->lock);
+
+		eventfd_write(pscan->notify_fd, 1);
+
+		/* nothing is above the top channel */
+		if ( worker->top && freq >= worker->high )
+			break;
+	}
+
+	pthread_mutex_lock(&pscan->lock);
+	worker->error = error;
+	worker->done = true;
+	pthread_mutex_unlock(&pscan->lock);
+
+	eventfd_write(pscan->notify_fd, 1);
+
+	return NULL;
+}
+
+static void*
+__mmradio_pscan_abort(void* data)
+{
+	MMRadioScanWorker_t* worker = (MMRadioScanWorker_t*)data;
+	mm_radio_t* radio = worker->pscan->radio;
+
+	if ( _mmradio_tune_raw(radio, &worker->dev, worker->start) < 0 )
+		MMRADIO_LOG_DEBUG("failed to abort seek : %s\n", strerror(errno));
+
+	return NULL;
+}
+
+/* signal of a channel by the tuner of worker. tuner stays there. -1 on failure or stop */
+static int
+__mmradio_pscan_signal(MMRadioScanWorker_t* worker, int freq)
+{
+	mm_radio_t* radio = worker->pscan->radio;
+	struct v4l2_tuner vt;
+
+	if ( _mmradio_tune_raw(radio, &worker->dev, freq) < 0 )
+		return -1;
+
+	if ( _mmradio_wait_cancel(radio->scan_cancel_fd, _mmradio_sw_seek_settle(radio)) )
+		return -1;
+
+	memset(&vt, 0, sizeof(struct v4l2_tuner));
+	vt.index = worker->dev.tuner_index;
+	if ( radio->backend->get_tuner(worker->dev.priv, worker->dev.fd, &vt) < 0 )
+		return -1;
+
+	return (int)vt.signal;
+}
+
+/* top channel is a station if it's over seek threshold, and it's not the edge of the station below it */
+static bool
+__mmradio_pscan_is_top_station(MMRadioScanWorker_t* worker, int freq, int signal)
+{
+	mm_radio_t* radio = worker->pscan->radio;
+
+	if ( signal < _mmradio_sw_seek_threshold(radio) )
+		return false;
+
+	return ( signal >= __mmradio_pscan_signal(worker, freq - radio->region_setting.channel_spacing) );
+}
+
+/* seek up once. freq is on channel raster, KHz */
+static int
+__mmradio_pscan_seek(MMRadioScanWorker_t* worker, struct v4l2_hw_freq_seek* vs, int* freq)
+{
+	mm_radio_t* radio = worker->pscan->radio;
+	int spacing = radio->region_setting.channel_spacing;
+	int band_min = radio->region_setting.band_min;
+	struct v4l2_frequency vf;
+
+	if ( MMRADIO_TIMED(radio, MMRADIO_STAT_TUNER_OP(hw_seek),
+			radio->backend->hw_seek(worker->dev.priv, worker->dev.fd, vs)) < 0 )
+		return -1;
+
+	memset(&vf, 0, sizeof(struct v4l2_frequency));
+	vf.tuner = worker->dev.tuner_index;
+	if ( MMRADIO_TIMED(radio, MMRADIO_STAT_TUNER_OP(get_frequency),
+			radio->backend->get_frequency(worker->dev.priv, worker->dev.fd, &vf)) < 0 )
+		return -1;
+
+	*freq = (int)((unsigned long long)vf.frequency * worker->dev.freq_unit / 10000);
+	if ( *freq > band_min )
+		*freq = band_min + ( ( *freq - band_min + spacing / 2 ) / spacing ) * spacing;
+
+	return 0;
+}
+
+/* wait until hit of index is found. false if worker is done, or scan is stopped */
+static bool
+__mmradio_pscan_wait(MMRadioParallelScan_t* pscan, MMRadioScanWorker_t* worker, int index)
+{
+	mm_radio_t* radio = pscan->radio;
+	bool found = false;
+
+	pthread_mutex_lock(&pscan->lock);
+
+	while ( ! radio->stop_scan && index >= worker->num_hits && ! worker->done )
+	{
+		struct pollfd fds[2];
+		eventfd_t value = 0;
+
+		pthread_mutex_unlock(&pscan->lock);
+
+		/* notification after unlock is kept in eventfd. it's never missed */
+		fds[0].fd = pscan->notify_fd;
+		fds[0].events = POLLIN;
+		fds[0].revents = 0;
+		fds[1].fd = radio->scan_cancel_fd;
+		fds[1].events = POLLIN;
+		fds[1].revents = 0;
+
+		if ( poll(fds, 2, -1) < 0 && errno != EINTR )
+			MMRADIO_LOG_ERROR("failed to poll : %s\n", strerror(errno));
+
+		eventfd_read(pscan->notify_fd, &value);
+
+		pthread_mutex_lock(&pscan->lock);
+	}
+
+	found = ( ! radio->stop_scan && index < worker->num_hits );
+
+	pthread_mutex_unlock(&pscan->lock);
+
+	return found;
+}
+
+static void
+__mmradio_pscan_post(MMRadioParallelScan_t* pscan, const MMRadioScanHit_t* hit)
+{
+	MMRADIO_LOG_DEBUG("scanning : new frequency : [%d]\n", hit->frequency);
+
+	/* signal is the one of the tuner which found it */
+	_mmradio_add_scan_result(pscan->radio, hit->frequency, hit->signal);
+
+	_mmradio_post_scan_progress(pscan->radio, hit->frequency);
+}
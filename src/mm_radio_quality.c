@@ -0,0 +1,398 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL #defines:
+---------------------------------------------------------------------------*/
+#define SAMPLER_DEFAULT_INTERVAL	100		/* msec */
+#define QUALITY_BUCKETS				256		/* histogram for percentiles */
+#define RSSI_BUCKET_SHIFT			8		/* RSSI is 0 ~ 65535 */
+
+#ifndef MIN
+#define MIN(a, b)	( (a) < (b) ? (a) : (b) )
+#endif
+#ifndef MAX
+#define MAX(a, b)	( (a) > (b) ? (a) : (b) )
+#endif
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static void*	__mmradio_sampler_thread(void* data);
+static void	__mmradio_push_sample(mm_radio_t* radio, const MMRadioQuality_t* quality);
+static int		__mmradio_get_bucket(MMRadioQualityType type, int value);
+static int		__mmradio_get_percentile(MMRadioQualityType type, const int* histogram, int count, int percent);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_start_quality_sampling()
+ * Desc   : start sampling signal quality into history. history is cleared.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] interval : sampling interval, msec. zero or negative means default.
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_start_quality_sampling(mm_radio_t* radio, int interval)
+{
+	int ret = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SIGNAL_MONITOR );
+	MMRADIO_CHECK_DEVICE_STATE( radio );
+
+	radio->sampler_interval = ( interval > 0 ) ? interval : SAMPLER_DEFAULT_INTERVAL;
+
+	/* already running. just interval is updated */
+	if ( radio->sampler_thread )
+	{
+		MMRADIO_LOG_DEBUG("quality sampler is running already\n");
+		return MM_ERROR_NONE;
+	}
+
+	/* history lives until the handle is destroyed. readers never see it released */
+	if ( ! radio->history )
+	{
+		radio->history = (MMRadioQualitySample_t*)calloc(MMRADIO_QUALITY_HISTORY, sizeof(MMRadioQualitySample_t));
+		if ( ! radio->history )
+		{
+			MMRADIO_LOG_ERROR("failed to allocate quality history\n");
+			return MM_ERROR_RADIO_NO_FREE_SPACE;
+		}
+	}
+
+	radio->history_head = 0;
+	radio->quality_unsupported = false;
+
+	if ( pipe(radio->sampler_wakeup) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to create pipe : %s\n", strerror(errno));
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	ret = pthread_create(&radio->sampler_thread, NULL, __mmradio_sampler_thread, (void*)radio);
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("failed to create thread : sampler\n");
+		close(radio->sampler_wakeup[0]);
+		close(radio->sampler_wakeup[1]);
+		radio->sampler_wakeup[0] = radio->sampler_wakeup[1] = -1;
+		radio->sampler_thread = 0;
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_stop_quality_sampling()
+ * Desc   : stop sampling signal quality. it's called before closing device.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_stop_quality_sampling(mm_radio_t* radio)
+{
+	char wakeup = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	if ( ! radio->sampler_thread )
+		return MM_ERROR_NONE;
+
+	/* sampler never takes command lock. so, it's safe to join here */
+	if ( write(radio->sampler_wakeup[1], &wakeup, 1) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to wake up sampler : %s\n", strerror(errno));
+	}
+
+	pthread_join(radio->sampler_thread, NULL);
+	radio->sampler_thread = 0;
+
+	close(radio->sampler_wakeup[0]);
+	close(radio->sampler_wakeup[1]);
+	radio->sampler_wakeup[0] = radio->sampler_wakeup[1] = -1;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_quality_stats()
+ * Desc   : get statistics of signal quality over time window.
+ *          history is scanned in place from the newest one. a sample which is
+ *          overwritten while reading is skipped.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] type : type of quality
+ *	    [in] window : time window, msec. zero or negative means whole history.
+ *	    [out] stats : statistics
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_get_quality_stats(mm_radio_t* radio, MMRadioQualityType type, int window, MMRadioQualityStats* stats)
+{
+	int histogram[QUALITY_BUCKETS];
+	unsigned long long oldest = 0;
+	unsigned int head = 0;
+	unsigned int count = 0;
+	unsigned int i = 0;
+	long long sum = 0;
+	int n = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( stats, MM_ERROR_INVALID_ARGUMENT );
+	return_val_if_fail( type >= 0 && type < MM_RADIO_QUALITY_NUM, MM_ERROR_INVALID_ARGUMENT );
+
+	memset(stats, 0, sizeof(MMRadioQualityStats));
+
+	if ( ! radio->history )
+		return MM_ERROR_NONE;
+
+	memset(histogram, 0, sizeof(histogram));
+
+	if ( window > 0 )
+	{
+		unsigned long long now = _mmradio_get_time_usec();
+		unsigned long long span = (unsigned long long)window * 1000;
+
+		oldest = ( now > span ) ? now - span : 0;
+	}
+
+	head = radio->history_head;
+	__sync_synchronize();
+
+	count = ( head < MMRADIO_QUALITY_HISTORY ) ? head : MMRADIO_QUALITY_HISTORY;
+
+	for ( i = 0; i < count; i++ )
+	{
+		const MMRadioQualitySample_t* slot = &radio->history[(head - 1 - i) & (MMRADIO_QUALITY_HISTORY - 1)];
+		unsigned int seq = slot->seq;
+		unsigned long long time = 0;
+		unsigned int valid = 0;
+		int value = 0;
+
+		__sync_synchronize();
+		time = slot->time;
+		valid = slot->valid;
+		value = slot->value[type];
+		__sync_synchronize();
+
+		/* being written, or overwritten by newer one */
+		if ( ( seq & 1 ) || seq != slot->seq )
+			continue;
+
+		if ( time < oldest )
+			break;
+
+		if ( ! ( valid & ( 1 << type ) ) )
+			continue;
+
+		if ( n == 0 || value < stats->min )
+			stats->min = value;
+		if ( n == 0 || value > stats->max )
+			stats->max = value;
+
+		sum += value;
+		histogram[__mmradio_get_bucket(type, value)]++;
+		n++;
+	}
+
+	if ( n == 0 )
+		return MM_ERROR_NONE;
+
+	stats->num_samples = n;
+	stats->mean = (int)( sum / n );
+	stats->p10 = __mmradio_get_percentile(type, histogram, n, 10);
+	stats->p50 = __mmradio_get_percentile(type, histogram, n, 50);
+	stats->p90 = __mmradio_get_percentile(type, histogram, n, 90);
+
+	/* bucket resolution shouldn't go out of real range */
+	stats->p10 = MAX(stats->min, MIN(stats->p10, stats->max));
+	stats->p50 = MAX(stats->min, MIN(stats->p50, stats->max));
+	stats->p90 = MAX(stats->min, MIN(stats->p90, stats->max));
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+static int
+__mmradio_get_bucket(MMRadioQualityType type, int value)
+{
+	if ( type == MM_RADIO_QUALITY_RSSI )
+		value >>= RSSI_BUCKET_SHIFT;
+
+	if ( value < 0 )
+		return 0;
+
+	if ( value >= QUALITY_BUCKETS )
+		return QUALITY_BUCKETS - 1;
+
+	return value;
+}
+
+static int
+__mmradio_get_percentile(MMRadioQualityType type, const int* histogram, int count, int percent)
+{
+	int rank = ( count * percent + 99 ) / 100;
+	int acc = 0;
+	int bucket = 0;
+
+	if ( rank < 1 )
+		rank = 1;
+
+	for ( bucket = 0; bucket < QUALITY_BUCKETS - 1; bucket++ )
+	{
+		acc += histogram[bucket];
+		if ( acc >= rank )
+			break;
+	}
+
+	/* middle of the bucket */
+	if ( type == MM_RADIO_QUALITY_RSSI )
+		return ( bucket << RSSI_BUCKET_SHIFT ) + ( 1 << ( RSSI_BUCKET_SHIFT - 1 ) );
+
+	return bucket;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_read_quality()
+ * Desc   : read signal quality of the tuner of the handle. RSSI only if backend can't give more
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [out] quality : signal quality
+ * Return : zero on success, or -1 with errno
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_read_quality(mm_radio_t* radio, MMRadioQuality_t* quality)
+{
+	struct v4l2_tuner vt;
+
+	if ( ! radio->quality_unsupported )
+	{
+		if ( MMRADIO_TUNER_OP(radio, get_quality, quality) == 0 )
+			return 0;
+
+		if ( errno != ENOTTY )
+			return -1;
+
+		MMRADIO_LOG_DEBUG("tuner doesn't give signal quality. sampling RSSI only\n");
+		radio->quality_unsupported = true;
+	}
+
+	memset(&vt, 0, sizeof(vt));
+	vt.index = radio->tuner_index;
+
+	if ( MMRADIO_TUNER_OP(radio, get_tuner, &vt) < 0 )
+		return -1;
+
+	memset(quality, 0, sizeof(MMRadioQuality_t));
+	quality->valid = MMRADIO_QUALITY_VALID_RSSI;
+	quality->value[MM_RADIO_QUALITY_RSSI] = vt.signal;
+
+	return 0;
+}
+
+/* single writer. readers check seq to detect a sample being overwritten */
+static void
+__mmradio_push_sample(mm_radio_t* radio, const MMRadioQuality_t* quality)
+{
+	unsigned int head = radio->history_head;
+	MMRadioQualitySample_t* slot = &radio->history[head & (MMRADIO_QUALITY_HISTORY - 1)];
+
+	slot->seq++;
+	__sync_synchronize();
+
+	slot->time = _mmradio_get_time_usec();
+	slot->valid = quality->valid;
+	memcpy(slot->value, quality->value, sizeof(slot->value));
+
+	__sync_synchronize();
+	slot->seq++;
+
+	__sync_synchronize();
+	radio->history_head = head + 1;
+}
+
+static void*
+__mmradio_sampler_thread(void* data)
+{
+	mm_radio_t* radio = (mm_radio_t*)data;
+
+	MMRADIO_LOG_FENTER();
+
+	while ( 1 )
+	{
+		MMRadioQuality_t quality;
+		struct pollfd fds;
+		int ret = 0;
+
+		if ( _mmradio_read_quality(radio, &quality) == 0 )
+			__mmradio_push_sample(radio, &quality);
+
+		fds.fd = radio->sampler_wakeup[0];
+		fds.events = POLLIN;
+		fds.revents = 0;
+
+		ret = poll(&fds, 1, radio->sampler_interval);
+		if ( ret < 0 && errno != EINTR )
+		{
+			MMRADIO_LOG_ERROR("failed to poll : %s\n", strerror(errno));
+			break;
+		}
+
+		if ( ret > 0 )
+			break;
+	}
+
+	MMRADIO_LOG_FLEAVE();
+
+	return NULL;
+}
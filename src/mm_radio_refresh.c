@@ -0,0 +1,518 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL #defines:
+---------------------------------------------------------------------------*/
+#define REFRESH_DEFAULT_SLICE		50		/* msec */
+#define REFRESH_DEFAULT_INTERVAL	1000	/* msec */
+
+/*---------------------------------------------------------------------------
+    LOCAL DATA TYPE DEFINITIONS:
+---------------------------------------------------------------------------*/
+/* state kept between slices */
+typedef struct {
+	mm_radio_t* radio;
+	MMRadioTuner_t secondary;		/* fd is -1 if there's none */
+	unsigned int visit;				/* known station to be revisited next */
+	int cursor;						/* next channel to be explored. index of channel raster */
+	int prev_signal[2];				/* signal of previous two channels. -1 if unknown */
+} MMRadioRefresh_t;
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static void*	__mmradio_refresh_thread(void* data);
+static bool	__mmradio_refresh_open_secondary(MMRadioRefresh_t* refresh);
+static void	__mmradio_refresh_close_secondary(MMRadioRefresh_t* refresh);
+static bool	__mmradio_refresh_is_idle(mm_radio_t* radio);
+static bool	__mmradio_refresh_slice(MMRadioRefresh_t* refresh, MMRadioTuner_t* tuner);
+static int		__mmradio_refresh_sample(MMRadioRefresh_t* refresh, MMRadioTuner_t* tuner, int freq);
+static bool	__mmradio_refresh_is_known(const MMRadioStation* stations, int num_stations, int freq);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_start_station_refresh()
+ * Desc   : start refreshing station database in background
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] config : configuration. NULL means default
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_start_station_refresh(mm_radio_t* radio, const MMRadioRefreshConfig* config)
+{
+	int ret = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	/* nowhere to keep stations */
+	if ( radio->station_db.fd < 0 )
+	{
+		MMRADIO_LOG_ERROR("station database is not opened\n");
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+	}
+
+	if ( radio->refresh_thread )
+	{
+		MMRADIO_LOG_DEBUG("station refresh is running already\n");
+		return MM_ERROR_RADIO_NO_OP;
+	}
+
+	memset(&radio->refresh_config, 0, sizeof(MMRadioRefreshConfig));
+	if ( config )
+	{
+		radio->refresh_config = *config;
+
+		if ( config->device )
+		{
+			return_val_if_fail( config->tuner_index >= 0, MM_ERROR_INVALID_ARGUMENT );
+			return_val_if_fail( strlen(config->device) < sizeof(radio->refresh_device), MM_ERROR_INVALID_ARGUMENT );
+
+			strncpy(radio->refresh_device, config->device, sizeof(radio->refresh_device) - 1);
+			radio->refresh_device[sizeof(radio->refresh_device) - 1] = '\0';
+			radio->refresh_config.device = radio->refresh_device;
+		}
+	}
+
+	if ( radio->refresh_config.slice <= 0 )
+		radio->refresh_config.slice = REFRESH_DEFAULT_SLICE;
+	if ( radio->refresh_config.interval <= 0 )
+		radio->refresh_config.interval = REFRESH_DEFAULT_INTERVAL;
+
+	if ( pipe(radio->refresh_wakeup) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to create pipe : %s\n", strerror(errno));
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	ret = pthread_create(&radio->refresh_thread, NULL, __mmradio_refresh_thread, (void*)radio);
+	if ( ret )
+	{
+		MMRADIO_LOG_ERROR("failed to create thread : refresh\n");
+		close(radio->refresh_wakeup[0]);
+		close(radio->refresh_wakeup[1]);
+		radio->refresh_wakeup[0] = radio->refresh_wakeup[1] = -1;
+		radio->refresh_thread = 0;
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_stop_station_refresh()
+ * Desc   : stop refreshing station database.
+ *          it's safe to be called with command lock. refresh thread never waits for it.
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_stop_station_refresh(mm_radio_t* radio)
+{
+	char wakeup = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	if ( ! radio->refresh_thread )
+		return MM_ERROR_NONE;
+
+	if ( write(radio->refresh_wakeup[1], &wakeup, 1) < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to wake up refresh : %s\n", strerror(errno));
+	}
+
+	pthread_join(radio->refresh_thread, NULL);
+	radio->refresh_thread = 0;
+
+	close(radio->refresh_wakeup[0]);
+	close(radio->refresh_wakeup[1]);
+	radio->refresh_wakeup[0] = radio->refresh_wakeup[1] = -1;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+int
+_mmradio_set_refresh_idle(mm_radio_t* radio, int idle)
+{
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	radio->refresh_idle = idle ? true : false;
+
+	return MM_ERROR_NONE;
+}
+
+static void*
+__mmradio_refresh_thread(void* data)
+{
+	mm_radio_t* radio = (mm_radio_t*)data;
+	MMRadioRefresh_t refresh;
+	bool secondary = false;
+
+	MMRADIO_LOG_FENTER();
+
+	memset(&refresh, 0, sizeof(MMRadioRefresh_t));
+	refresh.radio = radio;
+	refresh.secondary.fd = -1;
+	refresh.prev_signal[0] = refresh.prev_signal[1] = -1;
+
+	if ( radio->refresh_config.device )
+	{
+		secondary = __mmradio_refresh_open_secondary(&refresh);
+		if ( ! secondary )
+			MMRADIO_LOG_ERROR("secondary tuner is not available. using idle periods\n");
+	}
+
+	while ( 1 )
+	{
+		struct pollfd fds;
+		bool changed = false;
+		int ret = 0;
+
+		fds.fd = radio->refresh_wakeup[0];
+		fds.events = POLLIN;
+		fds.revents = 0;
+
+		ret = poll(&fds, 1, radio->refresh_config.interval);
+		if ( ret < 0 )
+		{
+			if ( errno == EINTR )
+				continue;
+
+			MMRADIO_LOG_ERROR("failed to poll : %s\n", strerror(errno));
+			break;
+		}
+
+		if ( fds.revents )
+			break;
+
+		if ( secondary )
+		{
+			changed = __mmradio_refresh_slice(&refresh, &refresh.secondary);
+		}
+		else if ( pthread_mutex_trylock(&radio->cmd_lock) == 0 )
+		{
+			/* tuner of the handle. it's tuned back after the slice.
+			 * commands wait for the slice since the tuner is away from the frequency until then
+			 */
+			if ( __mmradio_refresh_is_idle(radio) )
+			{
+				MMRadioTuner_t tuner;
+
+				tuner.priv = radio->backend_priv;
+				tuner.fd = radio->radio_fd;
+				tuner.tuner_index = radio->tuner_index;
+				tuner.freq_unit = radio->freq_unit;
+
+				changed = __mmradio_refresh_slice(&refresh, &tuner);
+
+				if ( _mmradio_tune_raw(radio, NULL, radio->freq) < 0 )
+					MMRADIO_LOG_ERROR("failed to tune back to %d KHz\n", radio->freq);
+			}
+
+			MMRADIO_CMD_UNLOCK( radio );
+		}
+
+		if ( changed )
+		{
+			MMMessageParamType param = {0,};
+			int num_stations = 0;
+
+			_mmradio_get_stations(radio, NULL, 0, &num_stations);
+
+			param.union_type = MM_MSG_UNION_CODE;
+			param.code = num_stations;
+			MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_STATIONS_CHANGED, &param);
+		}
+	}
+
+	__mmradio_refresh_close_secondary(&refresh);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return NULL;
+}
+
+static bool
+__mmradio_refresh_open_secondary(MMRadioRefresh_t* refresh)
+{
+	mm_radio_t* radio = refresh->radio;
+	MMRadioTuner_t* tuner = &refresh->secondary;
+	struct v4l2_tuner vt;
+
+	/* same backend as the handle. simulated one sees same stations */
+	tuner->priv = radio->backend->clone(radio->backend_priv);
+	if ( ! tuner->priv )
+		return false;
+
+	tuner->fd = radio->backend->open(tuner->priv, radio->refresh_config.device);
+	if ( tuner->fd < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to open %s : %s\n", radio->refresh_config.device, strerror(errno));
+		__mmradio_refresh_close_secondary(refresh);
+		return false;
+	}
+
+	tuner->tuner_index = radio->refresh_config.tuner_index;
+
+	memset(&vt, 0, sizeof(struct v4l2_tuner));
+	vt.index = tuner->tuner_index;
+	if ( radio->backend->get_tuner(tuner->priv, tuner->fd, &vt) < 0 )
+	{
+		MMRADIO_LOG_ERROR("tuner %d of %s is not available\n", tuner->tuner_index, radio->refresh_config.device);
+		__mmradio_refresh_close_secondary(refresh);
+		return false;
+	}
+
+	tuner->freq_unit = _mmradio_get_freq_unit(vt.capability);
+
+	MMRADIO_LOG_DEBUG("secondary tuner : %s, tuner %d\n", radio->refresh_config.device, tuner->tuner_index);
+
+	return true;
+}
+
+static void
+__mmradio_refresh_close_secondary(MMRadioRefresh_t* refresh)
+{
+	mm_radio_t* radio = refresh->radio;
+	MMRadioTuner_t* tuner = &refresh->secondary;
+
+	if ( tuner->fd >= 0 )
+	{
+		radio->backend->close(tuner->priv, tuner->fd);
+		tuner->fd = -1;
+	}
+
+	if ( tuner->priv )
+	{
+		radio->backend->destroy(tuner->priv);
+		tuner->priv = NULL;
+	}
+}
+
+/* called with command lock. nobody listens, and nothing else is using tuner */
+static bool
+__mmradio_refresh_is_idle(mm_radio_t* radio)
+{
+	if ( radio->radio_fd < 0 || _mmradio_job_busy(radio) )
+		return false;
+
+	if ( radio->current_state == MM_RADIO_STATE_READY )
+		return true;
+
+	if ( radio->current_state == MM_RADIO_STATE_PLAYING )
+		return ( radio->settings.mute || radio->refresh_idle );
+
+	return false;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_refresh_slice()
+ * Desc   : revisit one of known stations, and explore channels between them until slice is over.
+ *          channel is a station if its signal is local peak above threshold.
+ * Param  :
+ *	    [in] refresh : refresh state
+ *	    [in] tuner : tuner to be used
+ * Return : true if station is added or removed
+ *---------------------------------------------------------------------------*/
+static bool
+__mmradio_refresh_slice(MMRadioRefresh_t* refresh, MMRadioTuner_t* tuner)
+{
+	mm_radio_t* radio = refresh->radio;
+	MMRadioStation* stations = NULL;
+	int num_stations = 0;
+	int threshold = _mmradio_sw_seek_threshold(radio);
+	int band_min = radio->region_setting.band_min;
+	int band_max = radio->region_setting.band_max;
+	int spacing = radio->region_setting.channel_spacing;
+	unsigned long long end = _mmradio_get_time_usec() + (unsigned long long)radio->refresh_config.slice * 1000;
+	int num_channels = 0;
+	int unexplored = 0;
+	bool changed = false;
+
+	/* region is not applied yet */
+	if ( band_min <= 0 || spacing <= 0 || band_max < band_min )
+		return false;
+
+	num_channels = ( band_max - band_min ) / spacing + 1;
+
+	if ( _mmradio_get_stations(radio, NULL, 0, &num_stations) != MM_ERROR_NONE )
+		return false;
+
+	if ( num_stations > 0 )
+	{
+		stations = (MMRadioStation*)malloc(sizeof(MMRadioStation) * num_stations);
+		if ( ! stations )
+			return false;
+
+		_mmradio_get_stations(radio, stations, num_stations, &num_stations);
+	}
+
+	/* known station. missed twice in a row means it's gone */
+	if ( num_stations > 0 )
+	{
+		MMRadioStation station = stations[refresh->visit++ % num_stations];
+		int signal = __mmradio_refresh_sample(refresh, tuner, station.frequency);
+
+		if ( signal >= threshold / 2 )
+		{
+			station.rssi = signal;
+			station.last_seen = 0;
+			_mmradio_merge_stations(radio, &station, 1);
+		}
+		else if ( signal >= 0 && station.rssi > 0 && station.rssi < threshold / 2 )
+		{
+			MMRADIO_LOG_DEBUG("station %d KHz is gone\n", station.frequency);
+			_mmradio_invalidate_stations(radio, station.frequency);
+			changed = true;
+		}
+		else if ( signal >= 0 )
+		{
+			/* missed once. it's not seen now. zero is signal of station never measured, e.g. merged by application */
+			station.rssi = ( signal > 0 ) ? signal : 1;
+			_mmradio_merge_stations(radio, &station, 1);
+		}
+	}
+
+	/* channels between known stations. whole band is passed once at most, so it doesn't spin when all are known */
+	while ( _mmradio_get_time_usec() < end && unexplored <= num_channels )
+	{
+		int freq = band_min + refresh->cursor * spacing;
+		int signal = 0;
+
+		if ( freq > band_max )
+		{
+			refresh->cursor = 0;
+			refresh->prev_signal[0] = refresh->prev_signal[1] = -1;
+			continue;
+		}
+
+		refresh->cursor++;
+
+		if ( __mmradio_refresh_is_known(stations, num_stations, freq) )
+		{
+			refresh->prev_signal[0] = refresh->prev_signal[1] = -1;
+			unexplored++;
+			continue;
+		}
+
+		unexplored = 0;
+
+		signal = __mmradio_refresh_sample(refresh, tuner, freq);
+		if ( signal < 0 )
+			break;
+
+		/* previous channel is a peak */
+		if ( refresh->prev_signal[1] >= threshold &&
+			refresh->prev_signal[1] >= refresh->prev_signal[0] && refresh->prev_signal[1] >= signal &&
+			! __mmradio_refresh_is_known(stations, num_stations, freq - spacing) )
+		{
+			MMRadioStation station;
+
+			memset(&station, 0, sizeof(MMRadioStation));
+			station.frequency = freq - spacing;
+			station.rssi = refresh->prev_signal[1];
+			station.pi = -1;
+
+			MMRADIO_LOG_DEBUG("new station %d KHz\n", station.frequency);
+			if ( _mmradio_merge_stations(radio, &station, 1) == MM_ERROR_NONE )
+				changed = true;
+		}
+
+		refresh->prev_signal[0] = refresh->prev_signal[1];
+		refresh->prev_signal[1] = signal;
+	}
+
+	MMRADIO_FREEIF( stations );
+
+	return changed;
+}
+
+/* signal of channel, or -1 on failure */
+static int
+__mmradio_refresh_sample(MMRadioRefresh_t* refresh, MMRadioTuner_t* tuner, int freq)
+{
+	mm_radio_t* radio = refresh->radio;
+	struct v4l2_tuner vt;
+
+	if ( _mmradio_tune_raw(radio, tuner, freq) < 0 )
+		return -1;
+
+	usleep(_mmradio_sw_seek_settle(radio));
+
+	memset(&vt, 0, sizeof(struct v4l2_tuner));
+	vt.index = tuner->tuner_index;
+	if ( MMRADIO_TIMED(radio, MMRADIO_STAT_TUNER_OP(get_tuner),
+			radio->backend->get_tuner(tuner->priv, tuner->fd, &vt)) < 0 )
+		return -1;
+
+	return (int)vt.signal;
+}
+
+/* stations are in order of frequency */
+static bool
+__mmradio_refresh_is_known(const MMRadioStation* stations, int num_stations, int freq)
+{
+	int low = 0;
+	int high = num_stations - 1;
+
+	while ( low <= high )
+	{
+		int mid = ( low + high ) / 2;
+
+		if ( stations[mid].frequency == freq )
+			return true;
+
+		if ( stations[mid].frequency < freq )
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+
+	return false;
+}
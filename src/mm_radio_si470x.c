@@ -0,0 +1,359 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* si470x path of V4L2 backend.
+ * generic V4L2 needs separate requests for frequency, signal and stereo, and has no RDS ready
+ * and AFC rail at all. si470x has all of them in STATUSRSSI and READCHAN. so, they are read
+ * directly from the chip when the driver allows register access.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/* older kernel header calls bridge as host */
+#ifndef V4L2_CHIP_MATCH_BRIDGE
+#define V4L2_CHIP_MATCH_BRIDGE		V4L2_CHIP_MATCH_HOST
+#endif
+
+/* signal scale of driver. the ideal factor is 0xffff / 75 dBuV = 873.8 */
+#define SI470X_RSSI_TO_SIGNAL(x_rssi)	( (x_rssi) * 873 + 8 * (x_rssi) / 10 )
+
+static int
+__mmradio_si470x_read(int fd, unsigned int reg, unsigned short* value)
+{
+#ifdef VIDIOC_DBG_G_REGISTER
+	struct v4l2_dbg_register dbg;
+
+	memset(&dbg, 0, sizeof(dbg));
+	dbg.match.type = V4L2_CHIP_MATCH_BRIDGE;
+	dbg.match.addr = 0;
+	dbg.reg = reg;
+
+	if ( ioctl(fd, VIDIOC_DBG_G_REGISTER, &dbg) < 0 )
+		return -1;
+
+	*value = (unsigned short)dbg.val;
+
+	return 0;
+#else
+	errno = ENOTTY;
+	return -1;
+#endif
+}
+
+static int
+__mmradio_si470x_write(int fd, unsigned int reg, unsigned short value)
+{
+#ifdef VIDIOC_DBG_S_REGISTER
+	struct v4l2_dbg_register dbg;
+
+	memset(&dbg, 0, sizeof(dbg));
+	dbg.match.type = V4L2_CHIP_MATCH_BRIDGE;
+	dbg.match.addr = 0;
+	dbg.reg = reg;
+	dbg.val = value;
+
+	return ioctl(fd, VIDIOC_DBG_S_REGISTER, &dbg);
+#else
+	errno = ENOTTY;
+	return -1;
+#endif
+}
+
+/* read-modify-write. register is not written if the field has the value already */
+static int
+__mmradio_si470x_update(int fd, unsigned int reg, unsigned short mask, unsigned short value)
+{
+	unsigned short old = 0;
+
+	if ( __mmradio_si470x_read(fd, reg, &old) < 0 )
+		return -1;
+
+	if ( ( old & mask ) == ( value & mask ) )
+		return 0;
+
+	return __mmradio_si470x_write(fd, reg, ( old & ~mask ) | ( value & mask ));
+}
+
+static int
+__mmradio_si470x_read_band(int fd, MMRadioSi470x_t* chip)
+{
+	unsigned short sysconfig2 = 0;
+	int band = 0;
+	int space = 0;
+
+	if ( __mmradio_si470x_read(fd, SYSCONFIG2, &sysconfig2) < 0 )
+		return -1;
+
+	band = ( sysconfig2 & SYSCONFIG2_BAND ) >> SYSCONFIG2_BAND_OFFSET;
+	space = ( sysconfig2 & SYSCONFIG2_SPACE ) >> SYSCONFIG2_SPACE_OFFSET;
+
+	pthread_mutex_lock(&chip->band_lock);
+
+	/* 0 : 87.5 ~ 108MHz, 1 : 76 ~ 108MHz, 2 : 76 ~ 90MHz */
+	chip->band_bottom = ( band == 0 ) ? 87500 : 76000;
+
+	/* 0 : 200KHz, 1 : 100KHz, 2 : 50KHz */
+	chip->spacing = ( space == 0 ) ? 200 : ( space == 1 ) ? 100 : 50;
+
+	pthread_mutex_unlock(&chip->band_lock);
+
+	return 0;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_si470x_init()
+ * Desc   : initialize state of chip path. called once when backend is created.
+ * Param  :
+ *	    [out] chip : state of chip path
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_si470x_init(MMRadioSi470x_t* chip)
+{
+	memset(chip, 0, sizeof(MMRadioSi470x_t));
+	pthread_mutex_init(&chip->band_lock, NULL);
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_si470x_deinit()
+ * Desc   : release state of chip path
+ * Param  :
+ *	    [in] chip : state of chip path
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_si470x_deinit(MMRadioSi470x_t* chip)
+{
+	pthread_mutex_destroy(&chip->band_lock);
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_si470x_probe()
+ * Desc   : check the device is si470x and its registers are readable.
+ *          register access needs debug support of kernel. if it's not there,
+ *          the device is used as generic V4L2 tuner.
+ * Param  :
+ *	    [in] fd : descriptor of radio device
+ *	    [out] chip : state of chip path
+ * Return : non-zero if chip path is available
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_si470x_probe(int fd, MMRadioSi470x_t* chip)
+{
+	struct v4l2_capability vc;
+	unsigned short deviceid = 0;
+
+	chip->present = 0;
+
+	memset(&vc, 0, sizeof(vc));
+	if ( ioctl(fd, VIDIOC_QUERYCAP, &vc) < 0 )
+		return 0;
+
+	if ( strncmp((const char*)vc.driver, DEFAULT_CHIP_MODEL, sizeof(vc.driver)) != 0 )
+		return 0;
+
+	if ( __mmradio_si470x_read(fd, DEVICEID, &deviceid) < 0 )
+	{
+		MMRADIO_LOG_DEBUG("si470x registers are not readable : %s\n", strerror(errno));
+		return 0;
+	}
+
+	if ( ( deviceid & DEVICEID_MFGID ) != DEVICEID_MFGID_SILABS )
+	{
+		MMRADIO_LOG_DEBUG("unknown manufacturer : 0x%04x\n", deviceid);
+		return 0;
+	}
+
+	if ( __mmradio_si470x_read_band(fd, chip) < 0 )
+		return 0;
+
+	chip->present = 1;
+
+	MMRADIO_LOG_DEBUG("si470x found. band from %d KHz, %d KHz spacing\n", chip->band_bottom, chip->spacing);
+
+	return 1;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_si470x_update_band()
+ * Desc   : read band of chip again. VIDIOC_S_TUNER can change it.
+ *          if the register can't be read now, next status read retries it.
+ * Param  :
+ *	    [in] fd : descriptor of radio device
+ *	    [in] chip : state of chip path
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_si470x_update_band(int fd, MMRadioSi470x_t* chip)
+{
+	int err = errno;
+
+	if ( ! chip->present )
+		return;
+
+	if ( __mmradio_si470x_read_band(fd, chip) < 0 )
+	{
+		pthread_mutex_lock(&chip->band_lock);
+		chip->spacing = 0;
+		pthread_mutex_unlock(&chip->band_lock);
+	}
+
+	errno = err;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_si470x_get_status()
+ * Desc   : read STATUSRSSI and READCHAN and decode them.
+ *          debug register interface reads one register per ioctl. so, it takes
+ *          two ioctls back to back. they give stereo, RDS and AFC rail bits too,
+ *          which G_FREQUENCY and G_TUNER don't.
+ *          band is read by the third one only if it couldn't be read on S_TUNER.
+ *          si470x doesn't measure SNR. so, it's not valid.
+ * Param  :
+ *	    [in] fd : descriptor of radio device
+ *	    [in] chip : state of chip path
+ *	    [out] status : tuner status. frequency is KHz
+ * Return : zero on success, or -1 with errno
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_si470x_get_status(int fd, MMRadioSi470x_t* chip, MMRadioTunerStatus* status)
+{
+	unsigned short regs[READCHAN - STATUSRSSI + 1];
+	unsigned int reg = 0;
+	int band_bottom = 0;
+	int spacing = 0;
+	int rssi = 0;
+
+	if ( ! chip->present )
+	{
+		errno = ENOTTY;
+		return -1;
+	}
+
+	pthread_mutex_lock(&chip->band_lock);
+	band_bottom = chip->band_bottom;
+	spacing = chip->spacing;
+	pthread_mutex_unlock(&chip->band_lock);
+
+	/* reading band failed on VIDIOC_S_TUNER */
+	if ( ! spacing )
+	{
+		if ( __mmradio_si470x_read_band(fd, chip) < 0 )
+			return -1;
+
+		pthread_mutex_lock(&chip->band_lock);
+		band_bottom = chip->band_bottom;
+		spacing = chip->spacing;
+		pthread_mutex_unlock(&chip->band_lock);
+	}
+
+	for ( reg = STATUSRSSI; reg <= READCHAN; reg++ )
+	{
+		if ( __mmradio_si470x_read(fd, reg, &regs[reg - STATUSRSSI]) < 0 )
+			return -1;
+	}
+
+	rssi = regs[0] & STATUSRSSI_RSSI;
+
+	memset(status, 0, sizeof(MMRadioTunerStatus));
+	status->valid = MM_RADIO_STATUS_FREQUENCY | MM_RADIO_STATUS_SIGNAL | MM_RADIO_STATUS_STEREO |
+		MM_RADIO_STATUS_RDS_READY | MM_RADIO_STATUS_AFC_RAIL;
+	status->frequency = band_bottom + ( regs[1] & READCHAN_READCHAN ) * spacing;
+	status->signal = SI470X_RSSI_TO_SIGNAL(rssi);
+	status->stereo = ( regs[0] & STATUSRSSI_ST ) ? 1 : 0;
+	status->rds_ready = ( regs[0] & STATUSRSSI_RDSR ) ? 1 : 0;
+	status->afc_rail = ( regs[0] & STATUSRSSI_AFCRL ) ? 1 : 0;
+
+	return 0;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_si470x_get_seek_threshold()
+ * Desc   : read seek thresholds from SYSCONFIG2 and SYSCONFIG3
+ * Param  :
+ *	    [in] fd : descriptor of radio device
+ *	    [in] chip : state of chip path
+ *	    [out] threshold : seek thresholds
+ * Return : zero on success, or -1 with errno
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_si470x_get_seek_threshold(int fd, MMRadioSi470x_t* chip, MMRadioSeekThreshold* threshold)
+{
+	unsigned short sysconfig2 = 0;
+	unsigned short sysconfig3 = 0;
+
+	if ( ! chip->present )
+	{
+		errno = ENOTTY;
+		return -1;
+	}
+
+	if ( __mmradio_si470x_read(fd, SYSCONFIG2, &sysconfig2) < 0 )
+		return -1;
+
+	if ( __mmradio_si470x_read(fd, SYSCONFIG3, &sysconfig3) < 0 )
+		return -1;
+
+	threshold->rssi = ( sysconfig2 & SYSCONFIG2_SEEKTH ) >> SYSCONFIG2_SEEKTH_OFFSET;
+	threshold->snr = ( sysconfig3 & SYSCONFIG3_SKSNR ) >> SYSCONFIG3_SKSNR_OFFSET;
+	threshold->impulse = ( sysconfig3 & SYSCONFIG3_SKCNT ) >> SYSCONFIG3_SKCNT_OFFSET;
+
+	return 0;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_si470x_set_seek_threshold()
+ * Desc   : write seek thresholds to SYSCONFIG2 and SYSCONFIG3
+ * Param  :
+ *	    [in] fd : descriptor of radio device
+ *	    [in] chip : state of chip path
+ *	    [in] threshold : seek thresholds
+ * Return : zero on success, or -1 with errno
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_si470x_set_seek_threshold(int fd, MMRadioSi470x_t* chip, const MMRadioSeekThreshold* threshold)
+{
+	unsigned short sysconfig3 = 0;
+
+	if ( ! chip->present )
+	{
+		errno = ENOTTY;
+		return -1;
+	}
+
+	if ( __mmradio_si470x_update(fd, SYSCONFIG2, SYSCONFIG2_SEEKTH,
+		threshold->rssi << SYSCONFIG2_SEEKTH_OFFSET) < 0 )
+		return -1;
+
+	sysconfig3 = ( threshold->snr << SYSCONFIG3_SKSNR_OFFSET ) | ( threshold->impulse << SYSCONFIG3_SKCNT_OFFSET );
+
+	if ( __mmradio_si470x_update(fd, SYSCONFIG3, SYSCONFIG3_SKSNR | SYSCONFIG3_SKCNT, sysconfig3) < 0 )
+		return -1;
+
+	MMRADIO_LOG_DEBUG("seek threshold : rssi %d, snr %d, impulse %d\n", threshold->rssi, threshold->snr, threshold->impulse);
+
+	return 0;
+}
@@ -0,0 +1,679 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* in-process simulated tuner. it behaves like radio-si470x driver on /dev/radio0 */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <mm_debug.h>
+
+#include "mm_radio_backend.h"
+#include "mm_radio_utils.h"
+
+#define SIM_DEVICE				"/dev/null"
+#define SIM_DRIVER				"radio-sim"
+#define SIM_CARD				"Simulated FM tuner"
+
+#define SIM_FREQ_FRAC			16		/* V4L2_TUNER_CAP_LOW, 62.5Hz unit */
+#define SIM_DEFAULT_STEP		100		/* KHz */
+#define SIM_DEFAULT_RANGELOW	76000	/* KHz */
+#define SIM_DEFAULT_RANGEHIGH	108000	/* KHz */
+#define SIM_TUNER_CAPS			(V4L2_TUNER_CAP_LOW | V4L2_TUNER_CAP_STEREO)
+#define SIM_HWSEEK_CAPS			V4L2_TUNER_CAP_HWSEEK_BOUNDED
+#define SIM_SIGNAL_PER_DBUV		874		/* signal scale of si470x. 0xffff / 75 dBuV */
+#define SIM_DB_PER_SNR_STEP		6		/* seek SNR threshold 1 ~ 15 */
+
+typedef struct {
+	MMRadioSimConfig config;		/* stations points to own copy */
+	pthread_mutex_t lock;
+	pthread_cond_t tuned;			/* frequency is set. it wakes up hardware seek */
+	unsigned int tune_seq;			/* increased whenever frequency is set */
+
+	/* tuner registers */
+	unsigned int freq;			/* KHz */
+	unsigned int rangelow;		/* KHz */
+	unsigned int rangehigh;		/* KHz */
+	unsigned int audmode;
+	int mute;
+	int deemphasis;
+	int seek_signal;			/* seek stops above it */
+	int seek_snr;				/* dB. zero means disabled */
+	MMRadioSeekThreshold seek_regs;	/* threshold registers. power-on ones give seek_threshold of config */
+	int seek_failures;			/* hardware seeks left to fail before next success */
+} mm_radio_sim_t;
+
+static void
+__mmradio_sim_delay(int usec)
+{
+	if ( usec > 0 )
+		usleep(usec);
+}
+
+/* called with sim lock. false if frequency is set while waiting */
+static bool
+__mmradio_sim_step_wait(mm_radio_sim_t* sim, int usec, unsigned int tune_seq)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	ts.tv_sec += usec / 1000000;
+	ts.tv_nsec += ( usec % 1000000 ) * 1000L;
+	if ( ts.tv_nsec >= 1000000000L )
+	{
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000L;
+	}
+
+	while ( sim->tune_seq == tune_seq )
+	{
+		if ( pthread_cond_timedwait(&sim->tuned, &sim->lock, &ts) == ETIMEDOUT )
+			break;
+	}
+
+	return ( sim->tune_seq == tune_seq );
+}
+
+static int
+__mmradio_sim_signal(mm_radio_sim_t* sim, int freq)
+{
+	int signal = sim->config.noise_floor;
+	int i = 0;
+
+	for ( i = 0; i < sim->config.num_stations; i++ )
+	{
+		const MMRadioSimStation* station = &sim->config.stations[i];
+		int detune = abs(freq - station->frequency);
+		int value = station->signal - (sim->config.rolloff * detune / 100);
+
+		if ( value > signal )
+			signal = value;
+	}
+
+	return signal;
+}
+
+/* called with sim lock. impulse threshold isn't simulated */
+static int
+__mmradio_sim_seek_stop(mm_radio_sim_t* sim, int freq)
+{
+	int signal = __mmradio_sim_signal(sim, freq);
+
+	if ( signal <= sim->seek_signal )
+		return 0;
+
+	if ( sim->seek_snr && ( signal - sim->config.noise_floor ) / 1000 < sim->seek_snr )
+		return 0;
+
+	return 1;
+}
+
+static void*
+__mmradio_sim_create(const void* config)
+{
+	const MMRadioSimConfig* sim_config = (const MMRadioSimConfig*)config;
+	mm_radio_sim_t* sim = NULL;
+	MMRadioSimStation* stations = NULL;
+
+	if ( ! sim_config )
+		return NULL;
+
+	sim = (mm_radio_sim_t*)malloc(sizeof(mm_radio_sim_t));
+	if ( ! sim )
+		return NULL;
+	memset(sim, 0, sizeof(mm_radio_sim_t));
+
+	sim->config = *sim_config;
+	sim->config.stations = NULL;
+
+	if ( sim_config->num_stations > 0 && sim_config->stations )
+	{
+		stations = (MMRadioSimStation*)malloc(sizeof(MMRadioSimStation) * sim_config->num_stations);
+		if ( ! stations )
+		{
+			free(sim);
+			return NULL;
+		}
+		memcpy(stations, sim_config->stations, sizeof(MMRadioSimStation) * sim_config->num_stations);
+		sim->config.stations = stations;
+	}
+	else
+	{
+		sim->config.num_stations = 0;
+	}
+
+	if ( sim->config.step <= 0 )
+		sim->config.step = SIM_DEFAULT_STEP;
+
+	sim->freq = SIM_DEFAULT_RANGELOW;
+	sim->rangelow = SIM_DEFAULT_RANGELOW;
+	sim->rangehigh = SIM_DEFAULT_RANGEHIGH;
+	sim->audmode = V4L2_TUNER_MODE_STEREO;
+	sim->mute = 1;
+	sim->seek_signal = sim->config.seek_threshold;
+	sim->seek_regs.rssi = sim->config.seek_threshold / SIM_SIGNAL_PER_DBUV;
+	sim->seek_failures = sim->config.seek_failures;
+
+	pthread_mutex_init(&sim->lock, NULL);
+
+	{
+		pthread_condattr_t attr;
+
+		pthread_condattr_init(&attr);
+		pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+		pthread_cond_init(&sim->tuned, &attr);
+		pthread_condattr_destroy(&attr);
+	}
+
+	return sim;
+}
+
+static void
+__mmradio_sim_destroy(void* priv)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+
+	if ( ! sim )
+		return;
+
+	pthread_cond_destroy(&sim->tuned);
+	pthread_mutex_destroy(&sim->lock);
+	free((void*)sim->config.stations);
+	free(sim);
+}
+
+/* same stations on air. tuner state is its own */
+static void*
+__mmradio_sim_clone(void* priv)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+
+	return __mmradio_sim_create(&sim->config);
+}
+
+static int
+__mmradio_sim_open(void* priv, const char* device)
+{
+	/* simulated tuner has no node. but we are holding a real descriptor
+	 * so that every check on radio_fd works same as real device.
+	 */
+	return open(SIM_DEVICE, O_RDONLY);
+}
+
+static int
+__mmradio_sim_close(void* priv, int fd)
+{
+	return close(fd);
+}
+
+static int
+__mmradio_sim_query_cap(void* priv, int fd, struct v4l2_capability* vc)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	memset(vc, 0, sizeof(struct v4l2_capability));
+	strncpy((char*)vc->driver, SIM_DRIVER, sizeof(vc->driver) - 1);
+	strncpy((char*)vc->card, SIM_CARD, sizeof(vc->card) - 1);
+	strncpy((char*)vc->bus_info, "sim", sizeof(vc->bus_info) - 1);
+	vc->capabilities = V4L2_CAP_TUNER | V4L2_CAP_RADIO;
+	if ( ! sim->config.no_hw_seek )
+		vc->capabilities |= V4L2_CAP_HW_FREQ_SEEK;
+
+	return 0;
+}
+
+static int
+__mmradio_sim_get_tuner(void* priv, int fd, struct v4l2_tuner* vt)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+
+	if ( vt->index != 0 )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	memset(vt, 0, sizeof(struct v4l2_tuner));
+	strncpy((char*)vt->name, "FM", sizeof(vt->name) - 1);
+	vt->type = V4L2_TUNER_RADIO;
+	vt->capability = SIM_TUNER_CAPS | ( sim->config.no_hw_seek ? 0 : SIM_HWSEEK_CAPS );
+	vt->rangelow = sim->rangelow * SIM_FREQ_FRAC;
+	vt->rangehigh = sim->rangehigh * SIM_FREQ_FRAC;
+	vt->audmode = sim->audmode;
+	vt->signal = __mmradio_sim_signal(sim, sim->freq);
+	vt->rxsubchans = ( (int)vt->signal > sim->config.seek_threshold ) ?
+		V4L2_TUNER_SUB_STEREO : V4L2_TUNER_SUB_MONO;
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return 0;
+}
+
+static int
+__mmradio_sim_enum_freq_bands(void* priv, int fd, struct v4l2_frequency_band* band)
+{
+	/* just one FM band. it's whole range of the tuner */
+	if ( band->tuner != 0 || band->index != 0 )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	band->type = V4L2_TUNER_RADIO;
+	band->capability = SIM_TUNER_CAPS;
+	band->rangelow = SIM_DEFAULT_RANGELOW * SIM_FREQ_FRAC;
+	band->rangehigh = SIM_DEFAULT_RANGEHIGH * SIM_FREQ_FRAC;
+	band->modulation = V4L2_BAND_MODULATION_FM;
+
+	return 0;
+}
+
+static int
+__mmradio_sim_set_tuner(void* priv, int fd, struct v4l2_tuner* vt)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+	unsigned int low = vt->rangelow / SIM_FREQ_FRAC;
+	unsigned int high = vt->rangehigh / SIM_FREQ_FRAC;
+
+	if ( vt->index != 0 )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	sim->audmode = vt->audmode;
+
+	/* band range is applied only when it's reasonable. same as si470x */
+	if ( low && high && low < high )
+	{
+		sim->rangelow = low;
+		sim->rangehigh = high;
+
+		if ( sim->freq < low || sim->freq > high )
+			sim->freq = low;
+	}
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return 0;
+}
+
+static int
+__mmradio_sim_set_frequency(void* priv, int fd, struct v4l2_frequency* vf)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+	unsigned int freq = vf->frequency / SIM_FREQ_FRAC;
+	int ret = 0;
+
+	if ( vf->tuner != 0 )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	if ( freq < sim->rangelow || freq > sim->rangehigh )
+	{
+		errno = EINVAL;
+		ret = -1;
+	}
+	else
+	{
+		sim->freq = freq;
+
+		/* seek in progress is aborted */
+		sim->tune_seq++;
+		pthread_cond_broadcast(&sim->tuned);
+	}
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return ret;
+}
+
+static int
+__mmradio_sim_get_frequency(void* priv, int fd, struct v4l2_frequency* vf)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+
+	if ( vf->tuner != 0 )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	vf->type = V4L2_TUNER_RADIO;
+	vf->frequency = sim->freq * SIM_FREQ_FRAC;
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return 0;
+}
+
+static int
+__mmradio_sim_hw_seek(void* priv, int fd, struct v4l2_hw_freq_seek* vs)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+	int step = sim->config.step;
+	int low = 0;
+	int high = 0;
+	int steps = 0;
+	int max_steps = 0;
+	int freq = 0;
+	int ret = 0;
+	unsigned int tune_seq = 0;
+
+	if ( sim->config.no_hw_seek )
+	{
+		errno = ENOTTY;
+		return -1;
+	}
+
+	if ( vs->tuner != 0 || vs->type != V4L2_TUNER_RADIO )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	pthread_mutex_lock(&sim->lock);
+	tune_seq = sim->tune_seq;
+	pthread_mutex_unlock(&sim->lock);
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	/* tuner is busy. caller should try again */
+	if ( sim->seek_failures > 0 )
+	{
+		sim->seek_failures--;
+		pthread_mutex_unlock(&sim->lock);
+		errno = EAGAIN;
+		return -1;
+	}
+
+	/* spacing and range of request are used if they are given */
+	if ( vs->spacing >= 1000 )
+		step = vs->spacing / 1000;
+
+	low = ( vs->rangelow ) ? (int)(vs->rangelow / SIM_FREQ_FRAC) : (int)sim->rangelow;
+	high = ( vs->rangehigh ) ? (int)(vs->rangehigh / SIM_FREQ_FRAC) : (int)sim->rangehigh;
+
+	freq = sim->freq;
+	max_steps = (high - low) / step + 1;
+
+	for ( steps = 0; steps < max_steps; steps++ )
+	{
+		freq += vs->seek_upward ? step : -step;
+
+		/* band limit */
+		if ( freq > high || freq < low )
+		{
+			if ( ! vs->wrap_around )
+			{
+				/* si470x stops at the band limit and reports it as a success */
+				sim->freq = vs->seek_upward ? high : low;
+				break;
+			}
+
+			freq = vs->seek_upward ? low : high;
+		}
+
+		/* others can access tuner while stepping. tuning aborts seek */
+		if ( ! __mmradio_sim_step_wait(sim, sim->config.seek_step_latency, tune_seq) )
+		{
+			pthread_mutex_unlock(&sim->lock);
+			errno = EINTR;
+			return -1;
+		}
+
+		if ( __mmradio_sim_seek_stop(sim, freq) )
+		{
+			sim->freq = freq;
+			break;
+		}
+	}
+
+	/* went around whole band without any station */
+	if ( steps == max_steps )
+	{
+		errno = EAGAIN;
+		ret = -1;
+	}
+	else
+	{
+		sim->seek_failures = sim->config.seek_failures;
+	}
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return ret;
+}
+
+/* called with sim lock */
+static int
+__mmradio_sim_apply_ctrl(mm_radio_sim_t* sim, unsigned int id, int value)
+{
+	switch ( id )
+	{
+		case V4L2_CID_AUDIO_MUTE:
+			sim->mute = value;
+			break;
+
+		case MMRADIO_CID_TUNE_DEEMPHASIS:
+			sim->deemphasis = value;
+			break;
+
+		default:
+			errno = EINVAL;
+			return -1;
+	}
+
+	return 0;
+}
+
+static int
+__mmradio_sim_set_ctrl(void* priv, int fd, struct v4l2_control* vctrl)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+	int ret = 0;
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	ret = __mmradio_sim_apply_ctrl(sim, vctrl->id, vctrl->value);
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return ret;
+}
+
+static int
+__mmradio_sim_set_ext_ctrls(void* priv, int fd, struct v4l2_ext_controls* ctrls)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+	unsigned int i = 0;
+
+	/* one round trip for all controls */
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	for ( i = 0; i < ctrls->count; i++ )
+	{
+		if ( __mmradio_sim_apply_ctrl(sim, ctrls->controls[i].id, ctrls->controls[i].value) < 0 )
+		{
+			ctrls->error_idx = i;
+			pthread_mutex_unlock(&sim->lock);
+			return -1;
+		}
+	}
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return 0;
+}
+
+static int
+__mmradio_sim_get_quality(void* priv, int fd, MMRadioQuality_t* quality)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+	int signal = 0;
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+	signal = __mmradio_sim_signal(sim, sim->freq);
+	pthread_mutex_unlock(&sim->lock);
+
+	/* SNR is 1dB per 1000 above noise floor. no multipath in simulation */
+	memset(quality, 0, sizeof(MMRadioQuality_t));
+	quality->valid = MMRADIO_QUALITY_VALID_RSSI | MMRADIO_QUALITY_VALID_SNR;
+	quality->value[MM_RADIO_QUALITY_RSSI] = signal;
+	quality->value[MM_RADIO_QUALITY_SNR] = ( signal - sim->config.noise_floor ) / 1000;
+
+	return 0;
+}
+
+static int
+__mmradio_sim_get_status(void* priv, int fd, MMRadioTunerStatus* status)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+	int signal = 0;
+
+	/* one round trip like si470x registers */
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	signal = __mmradio_sim_signal(sim, sim->freq);
+
+	memset(status, 0, sizeof(MMRadioTunerStatus));
+	status->valid = MM_RADIO_STATUS_FREQUENCY | MM_RADIO_STATUS_SIGNAL | MM_RADIO_STATUS_SNR | MM_RADIO_STATUS_STEREO;
+	status->frequency = sim->freq;
+	status->signal = signal;
+	status->snr = ( signal - sim->config.noise_floor ) / 1000;
+	status->stereo = ( sim->audmode == V4L2_TUNER_MODE_STEREO && signal > sim->config.seek_threshold ) ? 1 : 0;
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return 0;
+}
+
+static int
+__mmradio_sim_get_seek_threshold(void* priv, int fd, MMRadioSeekThreshold* threshold)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	*threshold = sim->seek_regs;
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return 0;
+}
+
+static int
+__mmradio_sim_set_seek_threshold(void* priv, int fd, const MMRadioSeekThreshold* threshold)
+{
+	mm_radio_sim_t* sim = (mm_radio_sim_t*)priv;
+
+	__mmradio_sim_delay(sim->config.latency);
+
+	pthread_mutex_lock(&sim->lock);
+
+	/* power-on registers bring back the threshold of config, which isn't on the register scale */
+	if ( threshold->rssi == sim->config.seek_threshold / SIM_SIGNAL_PER_DBUV && ! threshold->snr && ! threshold->impulse )
+		sim->seek_signal = sim->config.seek_threshold;
+	else
+		sim->seek_signal = threshold->rssi * SIM_SIGNAL_PER_DBUV;
+	sim->seek_snr = threshold->snr * SIM_DB_PER_SNR_STEP;
+	sim->seek_regs = *threshold;
+
+	pthread_mutex_unlock(&sim->lock);
+
+	return 0;
+}
+
+static int
+__mmradio_sim_subscribe_event(void* priv, int fd, struct v4l2_event_subscription* sub)
+{
+	/* no event. signal should be polled */
+	errno = ENOTTY;
+	return -1;
+}
+
+static int
+__mmradio_sim_dequeue_event(void* priv, int fd, struct v4l2_event* ev)
+{
+	errno = ENOTTY;
+	return -1;
+}
+
+const MMRadioBackendOps mmradio_backend_sim =
+{
+	.name = "sim",
+	.create = __mmradio_sim_create,
+	.destroy = __mmradio_sim_destroy,
+	.clone = __mmradio_sim_clone,
+	.open = __mmradio_sim_open,
+	.close = __mmradio_sim_close,
+	.query_cap = __mmradio_sim_query_cap,
+	.get_tuner = __mmradio_sim_get_tuner,
+	.enum_freq_bands = __mmradio_sim_enum_freq_bands,
+	.set_tuner = __mmradio_sim_set_tuner,
+	.set_frequency = __mmradio_sim_set_frequency,
+	.get_frequency = __mmradio_sim_get_frequency,
+	.hw_seek = __mmradio_sim_hw_seek,
+	.set_ctrl = __mmradio_sim_set_ctrl,
+	.set_ext_ctrls = __mmradio_sim_set_ext_ctrls,
+	.get_quality = __mmradio_sim_get_quality,
+	.get_status = __mmradio_sim_get_status,
+	.get_seek_threshold = __mmradio_sim_get_seek_threshold,
+	.set_seek_threshold = __mmradio_sim_set_seek_threshold,
+	.subscribe_event = __mmradio_sim_subscribe_event,
+	.dequeue_event = __mmradio_sim_dequeue_event,
+};
@@ -0,0 +1,577 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL #defines:
+---------------------------------------------------------------------------*/
+#define STATION_DB_MAGIC			"MMRS"
+#define STATION_DB_VERSION			1
+#define STATION_DB_INITIAL_CAPACITY	64		/* records */
+
+#define STATION_FLAG_RDS_PI			0x0001
+#define STATION_FLAG_RDS_PS			0x0002
+
+/*---------------------------------------------------------------------------
+    LOCAL DATA TYPE DEFINITIONS:
+---------------------------------------------------------------------------*/
+/* on-disk format. little endian, fixed size records after header.
+ * records are not sorted, and removed one is filled with the last one.
+ */
+typedef struct {
+	char magic[4];
+	uint16_t version;
+	uint16_t record_size;
+	uint32_t capacity;			/* records the file has room for */
+	uint32_t num_records;
+	uint32_t reserved[4];
+} MMRadioStationDbHeader_t;		/* 32 bytes */
+
+typedef struct {
+	uint32_t device;			/* hash of device path and tuner index */
+	uint16_t region;			/* MMRadioRegionType */
+	uint16_t flags;
+	uint32_t frequency;			/* KHz */
+	int32_t rssi;
+	int64_t last_seen;			/* seconds since the Epoch */
+	uint16_t pi;
+	char ps[8];					/* not terminated */
+	uint8_t reserved[6];
+} MMRadioStationRecord_t;		/* 40 bytes */
+
+#define STATION_DB_HEADER(x_db)		((MMRadioStationDbHeader_t*)(x_db)->map)
+#define STATION_DB_RECORDS(x_db)	((MMRadioStationRecord_t*)((char*)(x_db)->map + sizeof(MMRadioStationDbHeader_t)))
+#define STATION_DB_FILE_SIZE(x_capacity)	(sizeof(MMRadioStationDbHeader_t) + (size_t)(x_capacity) * sizeof(MMRadioStationRecord_t))
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static int		__mmradio_station_db_lock(MMRadioStationDb_t* db);
+static void	__mmradio_station_db_unlock(MMRadioStationDb_t* db);
+static int		__mmradio_station_db_map(MMRadioStationDb_t* db, size_t size);
+static int		__mmradio_station_db_format(MMRadioStationDb_t* db);
+static int		__mmradio_station_db_grow(MMRadioStationDb_t* db);
+static uint32_t	__mmradio_station_device_key(mm_radio_t* radio);
+static void	__mmradio_station_from_record(MMRadioStation* station, const MMRadioStationRecord_t* record);
+static int		__mmradio_station_compare(const void* a, const void* b);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_open_station_db()
+ * Desc   : open station database file and map it. file is created or cleared if it's not usable.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] path : database file. NULL just closes opened one.
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_open_station_db(mm_radio_t* radio, const char* path)
+{
+	MMRadioStationDb_t* db = &radio->station_db;
+	MMRadioStationDbHeader_t* header = NULL;
+	struct stat st;
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	_mmradio_close_station_db( radio );
+
+	if ( ! path )
+		return MM_ERROR_NONE;
+
+	pthread_mutex_lock( &db->lock );
+
+	db->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if ( db->fd < 0 )
+	{
+		MMRADIO_LOG_ERROR("failed to open station database %s : %s\n", path, strerror(errno));
+		pthread_mutex_unlock( &db->lock );
+		return ( errno == EACCES ) ? MM_ERROR_RADIO_PERMISSION_DENIED : MM_ERROR_RADIO_INTERNAL;
+	}
+
+	flock(db->fd, LOCK_EX);
+
+	if ( fstat(db->fd, &st) < 0 )
+	{
+		ret = MM_ERROR_RADIO_INTERNAL;
+		goto error;
+	}
+
+	/* too small to have header. it's a new one */
+	if ( (size_t)st.st_size < sizeof(MMRadioStationDbHeader_t) )
+	{
+		if ( __mmradio_station_db_format(db) < 0 )
+		{
+			ret = MM_ERROR_RADIO_NO_FREE_SPACE;
+			goto error;
+		}
+	}
+	else if ( __mmradio_station_db_map(db, st.st_size) < 0 )
+	{
+		ret = MM_ERROR_RADIO_INTERNAL;
+		goto error;
+	}
+
+	/* capacity is bounded by file size before it's used. size of huge one overflows */
+	header = STATION_DB_HEADER(db);
+	if ( memcmp(header->magic, STATION_DB_MAGIC, sizeof(header->magic)) ||
+		header->version != STATION_DB_VERSION ||
+		header->record_size != sizeof(MMRadioStationRecord_t) ||
+		header->capacity > ( db->size - sizeof(MMRadioStationDbHeader_t) ) / sizeof(MMRadioStationRecord_t) ||
+		header->num_records > header->capacity )
+	{
+		MMRADIO_LOG_WARNING("station database %s is not usable. clearing it\n", path);
+
+		if ( __mmradio_station_db_format(db) < 0 )
+		{
+			ret = MM_ERROR_RADIO_NO_FREE_SPACE;
+			goto error;
+		}
+	}
+
+	MMRADIO_LOG_DEBUG("station database %s : %u records\n", path, STATION_DB_HEADER(db)->num_records);
+
+	flock(db->fd, LOCK_UN);
+	pthread_mutex_unlock( &db->lock );
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+
+error:
+	MMRADIO_LOG_ERROR("failed to load station database %s : %s\n", path, strerror(errno));
+
+	flock(db->fd, LOCK_UN);
+	pthread_mutex_unlock( &db->lock );
+
+	_mmradio_close_station_db( radio );
+
+	return ret;
+}
+
+void
+_mmradio_close_station_db(mm_radio_t* radio)
+{
+	MMRadioStationDb_t* db = &radio->station_db;
+
+	pthread_mutex_lock( &db->lock );
+
+	if ( db->map )
+	{
+		munmap(db->map, db->size);
+		db->map = NULL;
+		db->size = 0;
+	}
+
+	if ( db->fd >= 0 )
+	{
+		close(db->fd);
+		db->fd = -1;
+	}
+
+	pthread_mutex_unlock( &db->lock );
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_stations()
+ * Desc   : get stations of current region and device in order of frequency.
+ *          if there are more than max_stations, the lowest ones are filled.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [out] stations : array to be filled. can be NULL if max_stations is zero
+ *	    [in] max_stations : number of elements of stations
+ *	    [out] num_stations : number of stations in database
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_get_stations(mm_radio_t* radio, MMRadioStation* stations, int max_stations, int* num_stations)
+{
+	MMRadioStationDb_t* db = &radio->station_db;
+	MMRadioStationRecord_t* records = NULL;
+	MMRadioRegionType region = _mmradio_get_current_region(radio);
+	uint32_t device = __mmradio_station_device_key(radio);
+	uint32_t i = 0;
+	int count = 0;
+	int highest = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( num_stations, MM_ERROR_INVALID_ARGUMENT );
+	return_val_if_fail( stations || max_stations <= 0, MM_ERROR_INVALID_ARGUMENT );
+
+	if ( __mmradio_station_db_lock(db) < 0 )
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	records = STATION_DB_RECORDS(db);
+
+	for ( i = 0; i < STATION_DB_HEADER(db)->num_records; i++ )
+	{
+		const MMRadioStationRecord_t* record = &records[i];
+
+		if ( record->device != device || record->region != region )
+			continue;
+
+		if ( count < max_stations )
+		{
+			__mmradio_station_from_record(&stations[count], record);
+			if ( stations[count].frequency > stations[highest].frequency )
+				highest = count;
+		}
+		else if ( max_stations > 0 && (int)record->frequency < stations[highest].frequency )
+		{
+			/* records are not in order. array keeps the lowest ones */
+			int j = 0;
+
+			__mmradio_station_from_record(&stations[highest], record);
+			for ( j = 0; j < max_stations; j++ )
+			{
+				if ( stations[j].frequency > stations[highest].frequency )
+					highest = j;
+			}
+		}
+
+		count++;
+	}
+
+	__mmradio_station_db_unlock(db);
+
+	if ( count < max_stations )
+		max_stations = count;
+
+	if ( max_stations > 0 )
+		qsort(stations, max_stations, sizeof(MMRadioStation), __mmradio_station_compare);
+
+	*num_stations = count;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_invalidate_stations()
+ * Desc   : remove stations of current region and device
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] frequency : KHz. zero means all of them
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_invalidate_stations(mm_radio_t* radio, int frequency)
+{
+	MMRadioStationDb_t* db = &radio->station_db;
+	MMRadioStationDbHeader_t* header = NULL;
+	MMRadioStationRecord_t* records = NULL;
+	MMRadioRegionType region = _mmradio_get_current_region(radio);
+	uint32_t device = __mmradio_station_device_key(radio);
+	uint32_t i = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( frequency >= 0, MM_ERROR_INVALID_ARGUMENT );
+
+	if ( __mmradio_station_db_lock(db) < 0 )
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	header = STATION_DB_HEADER(db);
+	records = STATION_DB_RECORDS(db);
+
+	while ( i < header->num_records )
+	{
+		MMRadioStationRecord_t* record = &records[i];
+
+		if ( record->device != device || record->region != region ||
+			( frequency && record->frequency != (uint32_t)frequency ) )
+		{
+			i++;
+			continue;
+		}
+
+		/* last one fills the hole. it's checked in next turn */
+		header->num_records--;
+		if ( i < header->num_records )
+			*record = records[header->num_records];
+	}
+
+	__mmradio_station_db_unlock(db);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_merge_stations()
+ * Desc   : update stations of same frequency, and add others
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] stations : stations to be merged
+ *	    [in] num_stations : number of stations
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_merge_stations(mm_radio_t* radio, const MMRadioStation* stations, int num_stations)
+{
+	MMRadioStationDb_t* db = &radio->station_db;
+	MMRadioRegionType region = _mmradio_get_current_region(radio);
+	uint32_t device = __mmradio_station_device_key(radio);
+	long long now = (long long)time(NULL);
+	int ret = MM_ERROR_NONE;
+	int n = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( stations || num_stations <= 0, MM_ERROR_INVALID_ARGUMENT );
+
+	if ( __mmradio_station_db_lock(db) < 0 )
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	for ( n = 0; n < num_stations; n++ )
+	{
+		const MMRadioStation* station = &stations[n];
+		MMRadioStationDbHeader_t* header = STATION_DB_HEADER(db);
+		MMRadioStationRecord_t* record = NULL;
+		uint32_t i = 0;
+
+		if ( station->frequency <= 0 )
+		{
+			ret = MM_ERROR_INVALID_ARGUMENT;
+			continue;
+		}
+
+		for ( i = 0; i < header->num_records; i++ )
+		{
+			MMRadioStationRecord_t* r = &STATION_DB_RECORDS(db)[i];
+
+			if ( r->device == device && r->region == region && r->frequency == (uint32_t)station->frequency )
+			{
+				record = r;
+				break;
+			}
+		}
+
+		if ( ! record )
+		{
+			if ( header->num_records == header->capacity && __mmradio_station_db_grow(db) < 0 )
+			{
+				MMRADIO_LOG_ERROR("failed to grow station database : %s\n", strerror(errno));
+				ret = MM_ERROR_RADIO_NO_FREE_SPACE;
+				break;
+			}
+
+			/* map can be moved by growing */
+			header = STATION_DB_HEADER(db);
+			record = &STATION_DB_RECORDS(db)[header->num_records];
+
+			memset(record, 0, sizeof(MMRadioStationRecord_t));
+			record->device = device;
+			record->region = region;
+			record->frequency = station->frequency;
+
+			header->num_records++;
+		}
+
+		record->rssi = station->rssi;
+		record->last_seen = station->last_seen ? station->last_seen : now;
+
+		if ( station->pi >= 0 )
+		{
+			record->pi = station->pi;
+			record->flags |= STATION_FLAG_RDS_PI;
+		}
+
+		if ( station->ps[0] )
+		{
+			strncpy(record->ps, station->ps, sizeof(record->ps));
+			record->flags |= STATION_FLAG_RDS_PS;
+		}
+	}
+
+	__mmradio_station_db_unlock(db);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
+
+/* take lock of handle and file. map follows the file if other one has grown it */
+static int
+__mmradio_station_db_lock(MMRadioStationDb_t* db)
+{
+	struct stat st;
+
+	pthread_mutex_lock( &db->lock );
+
+	if ( db->fd < 0 )
+	{
+		pthread_mutex_unlock( &db->lock );
+		return -1;
+	}
+
+	flock(db->fd, LOCK_EX);
+
+	if ( fstat(db->fd, &st) == 0 && (size_t)st.st_size != db->size )
+	{
+		if ( __mmradio_station_db_map(db, st.st_size) < 0 )
+		{
+			MMRADIO_LOG_ERROR("failed to map station database : %s\n", strerror(errno));
+			flock(db->fd, LOCK_UN);
+			pthread_mutex_unlock( &db->lock );
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void
+__mmradio_station_db_unlock(MMRadioStationDb_t* db)
+{
+	flock(db->fd, LOCK_UN);
+	pthread_mutex_unlock( &db->lock );
+}
+
+/* called with lock */
+static int
+__mmradio_station_db_map(MMRadioStationDb_t* db, size_t size)
+{
+	void* map = NULL;
+
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, db->fd, 0);
+	if ( map == MAP_FAILED )
+		return -1;
+
+	if ( db->map )
+		munmap(db->map, db->size);
+
+	db->map = map;
+	db->size = size;
+
+	return 0;
+}
+
+/* called with lock. file is cleared */
+static int
+__mmradio_station_db_format(MMRadioStationDb_t* db)
+{
+	MMRadioStationDbHeader_t* header = NULL;
+	size_t size = STATION_DB_FILE_SIZE(STATION_DB_INITIAL_CAPACITY);
+
+	if ( ftruncate(db->fd, 0) < 0 || ftruncate(db->fd, size) < 0 )
+		return -1;
+
+	if ( __mmradio_station_db_map(db, size) < 0 )
+		return -1;
+
+	header = STATION_DB_HEADER(db);
+	memcpy(header->magic, STATION_DB_MAGIC, sizeof(header->magic));
+	header->version = STATION_DB_VERSION;
+	header->record_size = sizeof(MMRadioStationRecord_t);
+	header->capacity = STATION_DB_INITIAL_CAPACITY;
+	header->num_records = 0;
+
+	return 0;
+}
+
+/* called with lock. capacity is doubled */
+static int
+__mmradio_station_db_grow(MMRadioStationDb_t* db)
+{
+	uint32_t capacity = STATION_DB_HEADER(db)->capacity * 2;
+	size_t size = STATION_DB_FILE_SIZE(capacity);
+
+	if ( ftruncate(db->fd, size) < 0 )
+		return -1;
+
+	if ( __mmradio_station_db_map(db, size) < 0 )
+		return -1;
+
+	STATION_DB_HEADER(db)->capacity = capacity;
+
+	return 0;
+}
+
+/* FNV-1a of device path and tuner index */
+static uint32_t
+__mmradio_station_device_key(mm_radio_t* radio)
+{
+	uint32_t hash = 2166136261U;
+	const char* p = NULL;
+
+	for ( p = radio->device; *p; p++ )
+	{
+		hash ^= (unsigned char)*p;
+		hash *= 16777619U;
+	}
+
+	hash ^= (uint32_t)radio->tuner_index;
+	hash *= 16777619U;
+
+	return hash;
+}
+
+static void
+__mmradio_station_from_record(MMRadioStation* station, const MMRadioStationRecord_t* record)
+{
+	memset(station, 0, sizeof(MMRadioStation));
+	station->frequency = record->frequency;
+	station->rssi = record->rssi;
+	station->last_seen = record->last_seen;
+	station->pi = ( record->flags & STATION_FLAG_RDS_PI ) ? record->pi : -1;
+	if ( record->flags & STATION_FLAG_RDS_PS )
+		memcpy(station->ps, record->ps, sizeof(record->ps));
+}
+
+static int
+__mmradio_station_compare(const void* a, const void* b)
+{
+	return ((const MMRadioStation*)a)->frequency - ((const MMRadioStation*)b)->frequency;
+}
@@ -0,0 +1,288 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <errno.h>
+#include <string.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL #defines:
+---------------------------------------------------------------------------*/
+#define STATS_SUB_BUCKETS_SHIFT		2		/* 4 buckets per power of 2 */
+#define STATS_SUB_BUCKETS			(1 << STATS_SUB_BUCKETS_SHIFT)
+
+/*---------------------------------------------------------------------------
+    LOCAL VARIABLE DEFINITIONS:
+---------------------------------------------------------------------------*/
+/* names of calls. indexed by MMRADIO_STAT_XXX */
+static const char* stat_names[MMRADIO_STAT_NUM] =
+{
+	[MMRADIO_STAT_TUNER_OP(open)] = "open",
+	[MMRADIO_STAT_TUNER_OP(close)] = "close",
+	[MMRADIO_STAT_TUNER_OP(query_cap)] = "VIDIOC_QUERYCAP",
+	[MMRADIO_STAT_TUNER_OP(get_tuner)] = "VIDIOC_G_TUNER",
+	[MMRADIO_STAT_TUNER_OP(enum_freq_bands)] = "VIDIOC_ENUM_FREQ_BANDS",
+	[MMRADIO_STAT_TUNER_OP(set_tuner)] = "VIDIOC_S_TUNER",
+	[MMRADIO_STAT_TUNER_OP(set_frequency)] = "VIDIOC_S_FREQUENCY",
+	[MMRADIO_STAT_TUNER_OP(get_frequency)] = "VIDIOC_G_FREQUENCY",
+	[MMRADIO_STAT_TUNER_OP(hw_seek)] = "VIDIOC_S_HW_FREQ_SEEK",
+	[MMRADIO_STAT_TUNER_OP(set_ctrl)] = "VIDIOC_S_CTRL",
+	[MMRADIO_STAT_TUNER_OP(set_ext_ctrls)] = "VIDIOC_S_EXT_CTRLS",
+	[MMRADIO_STAT_TUNER_OP(get_quality)] = "get_quality",
+	[MMRADIO_STAT_TUNER_OP(get_status)] = "get_status",
+	[MMRADIO_STAT_TUNER_OP(get_seek_threshold)] = "get_seek_threshold",
+	[MMRADIO_STAT_TUNER_OP(set_seek_threshold)] = "set_seek_threshold",
+	[MMRADIO_STAT_TUNER_OP(subscribe_event)] = "VIDIOC_SUBSCRIBE_EVENT",
+	[MMRADIO_STAT_TUNER_OP(dequeue_event)] = "VIDIOC_DQEVENT",
+	[MMRADIO_STAT_GST_SET_STATE] = "gst_element_set_state",
+	[MMRADIO_STAT_GST_GET_STATE] = "gst_element_get_state",
+	[MMRADIO_STAT_ASM_SET_STATE] = "ASM_set_sound_state",
+	[MMRADIO_STAT_APPLY_SETTINGS] = "apply_settings",
+};
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static int				__mmradio_stats_get_bucket(unsigned long long usec);
+static unsigned int		__mmradio_stats_get_bucket_usec(int bucket);
+static unsigned int		__mmradio_stats_get_percentile(const unsigned int* histogram, unsigned int count, int percent);
+static void				__mmradio_stats_record(MMRadioStat_t* s, int stat, long result, unsigned long long usec);
+static bool				__mmradio_stats_failed(int stat, long result);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_enable_stats()
+ * Desc   : enable or disable latency statistics
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] enable : true to enable
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_enable_stats(mm_radio_t* radio, bool enable)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	radio->stats_enabled = enable;
+
+	MMRADIO_LOG_DEBUG("statistics : %s\n", enable ? "enabled" : "disabled");
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_get_stats()
+ * Desc   : copy statistics of the calls made at least once
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [out] entries : array to be filled
+ *	    [in] max_entries : number of elements of entries
+ *	    [out] num_entries : number of entries filled
+ *	    [in] reset : clear statistics after reading
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_get_stats(mm_radio_t* radio, MMRadioStatsEntry* entries, int max_entries, int* num_entries, bool reset)
+{
+	int count = 0;
+	int i = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( num_entries, MM_ERROR_INVALID_ARGUMENT );
+	return_val_if_fail( entries || max_entries <= 0, MM_ERROR_INVALID_ARGUMENT );
+
+	pthread_mutex_lock(&radio->stats_lock);
+
+	for ( i = 0; i < MMRADIO_STAT_NUM && count < max_entries; i++ )
+	{
+		MMRadioStat_t* stat = &radio->stats[i];
+		MMRadioStatsEntry* entry = &entries[count];
+
+		if ( ! stat->count || ! stat_names[i] )
+			continue;
+
+		memset(entry, 0, sizeof(MMRadioStatsEntry));
+		strncpy(entry->name, stat_names[i], sizeof(entry->name) - 1);
+		entry->count = stat->count;
+		entry->errors = stat->errors;
+		entry->total_usec = stat->total;
+		entry->max_usec = stat->max;
+		entry->ioctls = stat->ioctls;
+		memcpy(entry->histogram, stat->histogram, sizeof(entry->histogram));
+
+		entry->p50_usec = __mmradio_stats_get_percentile(entry->histogram, entry->count, 50);
+		entry->p99_usec = __mmradio_stats_get_percentile(entry->histogram, entry->count, 99);
+
+		if ( reset )
+			memset(stat, 0, sizeof(MMRadioStat_t));
+
+		count++;
+	}
+
+	pthread_mutex_unlock(&radio->stats_lock);
+
+	*num_entries = count;
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_stats_end()
+ * Desc   : record latency of a call timed by MMRADIO_TIMED
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] stat : MMRADIO_STAT_XXX
+ *	    [in] result : return value of the call
+ *	    [in] begin : time when the call is started, usec
+ * Return : result as it is. errno is kept also.
+ *---------------------------------------------------------------------------*/
+long
+_mmradio_stats_end(mm_radio_t* radio, int stat, long result, unsigned long long begin)
+{
+	int saved_errno = errno;
+
+	pthread_mutex_lock(&radio->stats_lock);
+	__mmradio_stats_record(&radio->stats[stat], stat, result, _mmradio_get_time_usec() - begin);
+	pthread_mutex_unlock(&radio->stats_lock);
+
+	errno = saved_errno;
+
+	return result;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_stats_end_batch()
+ * Desc   : record latency of a batch of ioctls and how many are issued by it.
+ *          ioctls per call tell how many are saved by batching
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] stat : MMRADIO_STAT_XXX
+ *	    [in] result : zero on success, or negative value with error code
+ *	    [in] begin : time when the batch is started, usec
+ *	    [in] ioctls : number of ioctls issued by the batch
+ * Return : None
+ *---------------------------------------------------------------------------*/
+void
+_mmradio_stats_end_batch(mm_radio_t* radio, int stat, long result, unsigned long long begin, int ioctls)
+{
+	MMRadioStat_t* s = &radio->stats[stat];
+	int saved_errno = errno;
+
+	/* under the same lock as the call. readers see ioctls of the calls counted */
+	pthread_mutex_lock(&radio->stats_lock);
+	__mmradio_stats_record(s, stat, result, _mmradio_get_time_usec() - begin);
+	s->ioctls += ioctls;
+	pthread_mutex_unlock(&radio->stats_lock);
+
+	errno = saved_errno;
+}
+
+/* caller holds stats_lock */
+static void
+__mmradio_stats_record(MMRadioStat_t* s, int stat, long result, unsigned long long usec)
+{
+	s->count++;
+	s->total += usec;
+	s->histogram[__mmradio_stats_get_bucket(usec)]++;
+
+	if ( __mmradio_stats_failed(stat, result) )
+		s->errors++;
+
+	if ( usec > s->max )
+		s->max = (unsigned int)usec;
+}
+
+static bool
+__mmradio_stats_failed(int stat, long result)
+{
+	/* GStreamer returns GST_STATE_CHANGE_FAILURE. the others return negative value */
+	if ( stat == MMRADIO_STAT_GST_SET_STATE || stat == MMRADIO_STAT_GST_GET_STATE )
+		return ( result == GST_STATE_CHANGE_FAILURE );
+
+	return ( result < 0 );
+}
+
+static int
+__mmradio_stats_get_bucket(unsigned long long usec)
+{
+	int msb = 0;
+	int bucket = 0;
+
+	if ( usec < STATS_SUB_BUCKETS )
+		return (int)usec;
+
+	msb = 63 - __builtin_clzll(usec);
+	bucket = ( ( msb - STATS_SUB_BUCKETS_SHIFT + 1 ) << STATS_SUB_BUCKETS_SHIFT ) +
+		(int)( ( usec >> ( msb - STATS_SUB_BUCKETS_SHIFT ) ) & ( STATS_SUB_BUCKETS - 1 ) );
+
+	if ( bucket >= MM_RADIO_STATS_BUCKETS )
+		bucket = MM_RADIO_STATS_BUCKETS - 1;
+
+	return bucket;
+}
+
+static unsigned int
+__mmradio_stats_get_bucket_usec(int bucket)
+{
+	int sub = bucket & ( STATS_SUB_BUCKETS - 1 );
+	int shift = ( bucket >> STATS_SUB_BUCKETS_SHIFT ) - 1;
+
+	if ( bucket < STATS_SUB_BUCKETS )
+		return (unsigned int)bucket;
+
+	return (unsigned int)( STATS_SUB_BUCKETS + sub ) << shift;
+}
+
+static unsigned int
+__mmradio_stats_get_percentile(const unsigned int* histogram, unsigned int count, int percent)
+{
+	unsigned long long rank = ( (unsigned long long)count * percent + 99 ) / 100;
+	unsigned long long acc = 0;
+	int bucket = 0;
+
+	for ( bucket = 0; bucket < MM_RADIO_STATS_BUCKETS - 1; bucket++ )
+	{
+		acc += histogram[bucket];
+		if ( acc >= rank )
+			break;
+	}
+
+	return __mmradio_stats_get_bucket_usec(bucket);
+}
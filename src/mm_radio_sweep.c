@@ -0,0 +1,145 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_sweep_band()
+ * Desc   : measure signal of every channel of the band. tuner is tuned back after the sweep
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [out] channels : array to be filled. NULL to get number of channels only
+ *	    [in] max_channels : number of elements of channels
+ *	    [out] num_channels : number of channels filled
+ *	    [in] callback : progress. zero from it cancels the sweep. can be NULL. called under cmd_lock
+ *	    [in] user_param : user parameter of callback
+ * Return : zero on success, or negative value with error code. MM_ERROR_POLICY_INTERRUPTED if ASM stops radio
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_sweep_band(mm_radio_t* radio, MMRadioChannelSignal* channels, int max_channels, int* num_channels,
+						MMRadioSweepCallback callback, void* user_param)
+{
+	int band_min = radio->region_setting.band_min;
+	int spacing = radio->region_setting.channel_spacing;
+	int settle = 0;
+	int total = 0;
+	int count = 0;
+	int ret = MM_ERROR_NONE;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+	MMRADIO_CHECK_STATE_RETURN_IF_FAIL( radio, MMRADIO_COMMAND_SWEEP );
+	MMRADIO_CHECK_DEVICE_STATE( radio );
+
+	if ( band_min <= 0 || spacing <= 0 )
+	{
+		MMRADIO_LOG_ERROR("region is not applied\n");
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+
+	total = ( radio->region_setting.band_max - band_min ) / spacing + 1;
+
+	if ( ! channels )
+	{
+		*num_channels = total;
+		return MM_ERROR_NONE;
+	}
+
+	if ( max_channels < total )
+	{
+		MMRADIO_LOG_ERROR("%d channels are needed, but %d are given\n", total, max_channels);
+		return MM_ERROR_RADIO_NO_FREE_SPACE;
+	}
+
+	settle = _mmradio_sw_seek_settle(radio);
+
+	MMRADIO_LOG_DEBUG("sweeping %d channels from %d KHz. settle %d usec\n", total, band_min, settle);
+
+	for ( count = 0; count < total; count++ )
+	{
+		MMRadioChannelSignal* channel = &channels[count];
+		MMRadioQuality_t quality;
+		int freq = band_min + count * spacing;
+
+		if ( _mmradio_tune_raw(radio, NULL, freq) < 0 )
+		{
+			MMRADIO_LOG_ERROR("failed to tune to %d KHz : %s\n", freq, strerror(errno));
+			ret = MM_ERROR_RADIO_INTERNAL;
+			break;
+		}
+
+		usleep(settle);
+
+		/* ASM is waiting for the lock to stop radio. sweep doesn't keep it for the rest of band */
+		if ( radio->asm_stop_pending )
+		{
+			MMRADIO_LOG_DEBUG("sweep is interrupted by ASM at %d KHz\n", freq);
+			ret = MM_ERROR_POLICY_INTERRUPTED;
+			break;
+		}
+
+		if ( _mmradio_read_quality(radio, &quality) < 0 )
+		{
+			MMRADIO_LOG_ERROR("failed to read signal of %d KHz : %s\n", freq, strerror(errno));
+			ret = MM_ERROR_RADIO_INTERNAL;
+			break;
+		}
+
+		channel->frequency = freq;
+		channel->rssi = quality.value[MM_RADIO_QUALITY_RSSI];
+		channel->snr = ( quality.valid & MMRADIO_QUALITY_VALID_SNR ) ? quality.value[MM_RADIO_QUALITY_SNR] : -1;
+
+		/* cmd_lock is held. it's not released here, or other commands would move the tuner under the sweep */
+		if ( callback && ! callback(count + 1, total, user_param) )
+		{
+			MMRADIO_LOG_DEBUG("sweep is cancelled at %d KHz\n", freq);
+			count++;
+			break;
+		}
+	}
+
+	*num_channels = count;
+
+	/* back to where it was */
+	if ( _mmradio_tune_raw(radio, NULL, radio->freq) < 0 )
+		MMRADIO_LOG_ERROR("failed to tune back to %d KHz\n", radio->freq);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
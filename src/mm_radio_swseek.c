@@ -0,0 +1,410 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL #defines:
+---------------------------------------------------------------------------*/
+#define SW_SEEK_DEFAULT_SETTLE		30		/* msec. RSSI of si470x is valid 20 ~ 30 msec after tuning */
+#define SW_SEEK_STRIDE				200		/* KHz. a station has signal within 100KHz of it at least */
+#define SW_SEEK_DEFAULT_SIGNAL		0x4000	/* used if seek profile has no RSSI threshold */
+#define SW_SEEK_SIGNAL_PER_DBUV		874		/* 0xffff / 75 dBuV. same scale with driver */
+#define SW_SEEK_DBUV_PER_SNR		3		/* margin over RSSI threshold per step of SNR threshold */
+#define SW_SEEK_DBUV_PER_IMPULSE	1		/* margin over RSSI threshold per step of impulse threshold */
+#define SW_SEEK_DEFAULT_SPACING		100		/* KHz */
+#define SW_SEEK_UNSAMPLED			-1
+
+/*---------------------------------------------------------------------------
+    LOCAL DATA TYPE DEFINITIONS:
+---------------------------------------------------------------------------*/
+typedef struct {
+	mm_radio_t* radio;
+	int low;				/* KHz */
+	int spacing;			/* KHz */
+	int num_channels;
+	int stride;				/* channels between coarse samples */
+	int start;				/* channel index where seek started */
+	int direction;			/* 1 : up, -1 : down */
+	int settle;				/* usec */
+	int* signal;			/* sampled signal. indexed by distance from start */
+} MMRadioSwSeek_t;
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static int		__mmradio_sw_seek_freq(MMRadioSwSeek_t* seek, int distance);
+static int		__mmradio_sw_seek_tune(MMRadioSwSeek_t* seek, int distance);
+static int		__mmradio_sw_seek_sample(MMRadioSwSeek_t* seek, int distance);
+static int		__mmradio_sw_seek_refine(MMRadioSwSeek_t* seek, int distance, int last, int threshold);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_seek_engine()
+ * Desc   : set engine of seek and scan. it's used from next seek or scan.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] engine : seek engine
+ *	    [in] settle_time : settle time of software seek, msec. zero or negative means default.
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_seek_engine(mm_radio_t* radio, MMRadioSeekEngine engine, int settle_time)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( engine >= MM_RADIO_SEEK_ENGINE_AUTO && engine <= MM_RADIO_SEEK_ENGINE_SOFTWARE,
+		MM_ERROR_INVALID_ARGUMENT );
+
+	radio->seek_engine = engine;
+	radio->seek_settle = ( settle_time > 0 ) ? settle_time : 0;
+
+	MMRADIO_LOG_DEBUG("seek engine : %d, settle time : %d msec\n", engine, settle_time);
+
+	MMRADIO_LOG_FLEAVE();
+	return MM_ERROR_NONE;
+}
+
+int
+_mmradio_get_seek_engine(mm_radio_t* radio, MMRadioSeekEngine* engine)
+{
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( engine, MM_ERROR_INVALID_ARGUMENT );
+
+	*engine = radio->seek_engine;
+
+	/* tuner is known only while device is opened */
+	if ( radio->seek_engine == MM_RADIO_SEEK_ENGINE_AUTO && radio->radio_fd >= 0 )
+		*engine = _mmradio_use_sw_seek(radio) ? MM_RADIO_SEEK_ENGINE_SOFTWARE : MM_RADIO_SEEK_ENGINE_HARDWARE;
+
+	MMRADIO_LOG_FLEAVE();
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_use_sw_seek()
+ * Desc   : decide engine of next seek from capability of device and tuner
+ * Param  :
+ *	    [in] radio : radio handle
+ * Return : true if software seek should be used
+ *---------------------------------------------------------------------------*/
+bool
+_mmradio_use_sw_seek(mm_radio_t* radio)
+{
+	switch ( radio->seek_engine )
+	{
+		case MM_RADIO_SEEK_ENGINE_HARDWARE:
+			return false;
+
+		case MM_RADIO_SEEK_ENGINE_SOFTWARE:
+			return true;
+
+		default:
+			break;
+	}
+
+	if ( radio->hw_seek_unsupported )
+		return true;
+
+	if ( radio->vc.capabilities & V4L2_CAP_HW_FREQ_SEEK )
+		return false;
+
+#if defined(V4L2_TUNER_CAP_HWSEEK_BOUNDED) && defined(V4L2_TUNER_CAP_HWSEEK_WRAP)
+	/* newer drivers report it by tuner */
+	if ( (radio->vt).capability & ( V4L2_TUNER_CAP_HWSEEK_BOUNDED | V4L2_TUNER_CAP_HWSEEK_WRAP ) )
+		return false;
+#endif
+
+	return true;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_sw_seek()
+ * Desc   : seek by stepping channel raster. it behaves like VIDIOC_S_HW_FREQ_SEEK.
+ *          signal of channels SW_SEEK_STRIDE apart is sampled first. channels around the sample
+ *          having half of threshold or more are sampled, and local peak above threshold is the station.
+ *          without wrap around, it stops at band limit and succeeds like si470x.
+ *          NOTE : it's called by seek and scan thread without command lock.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] vs : seek request. spacing and range are used if they are given.
+ * Return : zero on success, or -1 with errno. EAGAIN if nothing is found in whole band.
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_sw_seek(mm_radio_t* radio, const struct v4l2_hw_freq_seek* vs)
+{
+	MMRadioSwSeek_t seek;
+	struct v4l2_frequency vf;
+	int threshold = _mmradio_sw_seek_threshold(radio);
+	int high = 0;
+	int freq = 0;
+	int last = 0;
+	int distance = 0;
+	int found = 0;
+	int ret = -1;
+
+	MMRADIO_LOG_FENTER();
+
+	memset(&seek, 0, sizeof(MMRadioSwSeek_t));
+	seek.radio = radio;
+	seek.spacing = ( vs->spacing >= 1000 ) ? (int)(vs->spacing / 1000) : radio->region_setting.channel_spacing;
+	if ( seek.spacing <= 0 )
+		seek.spacing = SW_SEEK_DEFAULT_SPACING;
+
+	seek.low = ( vs->rangelow ) ? RADIO_FREQ_FORMAT_GET(radio, vs->rangelow) : radio->region_setting.band_min;
+	high = ( vs->rangehigh ) ? RADIO_FREQ_FORMAT_GET(radio, vs->rangehigh) : radio->region_setting.band_max;
+	if ( seek.low <= 0 || high < seek.low )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	seek.num_channels = ( high - seek.low ) / seek.spacing + 1;
+	seek.stride = SW_SEEK_STRIDE / seek.spacing;
+	if ( seek.stride < 1 )
+		seek.stride = 1;
+	seek.direction = vs->seek_upward ? 1 : -1;
+	seek.settle = _mmradio_sw_seek_settle(radio);
+
+	/* start from the channel tuner is on */
+	memset(&vf, 0, sizeof(struct v4l2_frequency));
+	vf.tuner = radio->tuner_index;
+	if ( MMRADIO_TUNER_OP(radio, get_frequency, &vf) < 0 )
+		return -1;
+
+	freq = RADIO_FREQ_FORMAT_GET(radio, vf.frequency);
+	seek.start = ( freq - seek.low + seek.spacing / 2 ) / seek.spacing;
+	if ( seek.start < 0 )
+		seek.start = 0;
+	if ( seek.start >= seek.num_channels )
+		seek.start = seek.num_channels - 1;
+
+	/* last channel to visit. whole band once with wrap around */
+	if ( vs->wrap_around )
+		last = seek.num_channels - 1;
+	else
+		last = ( seek.direction > 0 ) ? seek.num_channels - 1 - seek.start : seek.start;
+
+	seek.signal = (int*)malloc(sizeof(int) * seek.num_channels);
+	if ( ! seek.signal )
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+
+	for ( distance = 0; distance < seek.num_channels; distance++ )
+		seek.signal[distance] = SW_SEEK_UNSAMPLED;
+
+	MMRADIO_LOG_DEBUG("software seek from %d KHz. %d channels, threshold %d\n", freq, last, threshold);
+
+	/* coarse pass. the last channel is always sampled */
+	for ( distance = seek.stride; last > 0; distance += seek.stride )
+	{
+		int signal = 0;
+
+		if ( distance > last )
+			distance = last;
+
+		signal = __mmradio_sw_seek_sample(&seek, distance);
+		if ( signal < 0 )
+			goto done;
+
+		if ( signal >= threshold / 2 )
+		{
+			found = __mmradio_sw_seek_refine(&seek, distance, last, threshold);
+			if ( found < 0 )
+				goto done;
+
+			if ( found > 0 )
+				break;
+		}
+
+		if ( distance == last )
+			break;
+	}
+
+	if ( found > 0 )
+	{
+		ret = __mmradio_sw_seek_tune(&seek, found);
+	}
+	else if ( ! vs->wrap_around )
+	{
+		/* stops at band limit */
+		ret = __mmradio_sw_seek_tune(&seek, last);
+	}
+	else
+	{
+		/* nothing. tuner goes back to where it was */
+		__mmradio_sw_seek_tune(&seek, 0);
+		errno = EAGAIN;
+	}
+
+done:
+	free(seek.signal);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return ret;
+}
+
+/* KHz of channel at distance from start in seek direction */
+static int
+__mmradio_sw_seek_freq(MMRadioSwSeek_t* seek, int distance)
+{
+	int index = ( seek->start + seek->direction * distance ) % seek->num_channels;
+
+	if ( index < 0 )
+		index += seek->num_channels;
+
+	return seek->low + index * seek->spacing;
+}
+
+static int
+__mmradio_sw_seek_tune(MMRadioSwSeek_t* seek, int distance)
+{
+	return _mmradio_tune_raw(seek->radio, NULL, __mmradio_sw_seek_freq(seek, distance));
+}
+
+/* signal of channel. it's sampled once per seek. negative on failure */
+static int
+__mmradio_sw_seek_sample(MMRadioSwSeek_t* seek, int distance)
+{
+	mm_radio_t* radio = seek->radio;
+	struct v4l2_tuner vt;
+
+	if ( seek->signal[distance] != SW_SEEK_UNSAMPLED )
+		return seek->signal[distance];
+
+	if ( __mmradio_sw_seek_tune(seek, distance) < 0 )
+		return -1;
+
+	/* scan is stopped while settling */
+	_mmradio_wait_cancel(radio->scan_cancel_fd, seek->settle);
+	if ( radio->stop_scan )
+	{
+		errno = EINTR;
+		return -1;
+	}
+
+	memset(&vt, 0, sizeof(struct v4l2_tuner));
+	vt.index = radio->tuner_index;
+	if ( MMRADIO_TUNER_OP(radio, get_tuner, &vt) < 0 )
+		return -1;
+
+	seek->signal[distance] = (int)vt.signal;
+
+	return seek->signal[distance];
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : __mmradio_sw_seek_refine()
+ * Desc   : find the first local peak above threshold around coarse sample.
+ *          adjacent channels of a station have its signal too. they are not peak.
+ * Param  :
+ *	    [in] seek : seek state
+ *	    [in] distance : coarse sample
+ *	    [in] last : last channel to visit
+ *	    [in] threshold : signal threshold
+ * Return : distance of the station, zero if nothing is found, or -1 on failure
+ *---------------------------------------------------------------------------*/
+static int
+__mmradio_sw_seek_refine(MMRadioSwSeek_t* seek, int distance, int last, int threshold)
+{
+	int from = distance - seek->stride + 1;
+	int to = distance + seek->stride - 1;
+	int i = 0;
+
+	if ( from < 1 )
+		from = 1;
+	if ( to > last )
+		to = last;
+
+	for ( i = from; i <= to; i++ )
+	{
+		int signal = __mmradio_sw_seek_sample(seek, i);
+		int prev = 0;
+		int next = 0;
+
+		if ( signal < 0 )
+			return -1;
+
+		if ( signal < threshold )
+			continue;
+
+		prev = __mmradio_sw_seek_sample(seek, i - 1);
+		if ( prev < 0 )
+			return -1;
+
+		next = ( i < last ) ? __mmradio_sw_seek_sample(seek, i + 1) : 0;
+		if ( next < 0 )
+			return -1;
+
+		if ( signal >= prev && signal >= next )
+			return i;
+	}
+
+	return 0;
+}
+
+/* signal threshold from thresholds of seek profile.
+ * only signal is measured. so, SNR and impulse thresholds raise the RSSI one by a margin,
+ * as noise of the tuner is fixed and stronger signal has better SNR and fewer impulses.
+ */
+int
+_mmradio_sw_seek_threshold(mm_radio_t* radio)
+{
+	const MMRadioSeekThreshold* threshold = &radio->seek_threshold;
+	int dbuv = 0;
+
+	if ( radio->seek_profile == MM_RADIO_SEEK_PROFILE_DEFAULT || threshold->rssi <= 0 )
+		return SW_SEEK_DEFAULT_SIGNAL;
+
+	dbuv = threshold->rssi + threshold->snr * SW_SEEK_DBUV_PER_SNR + threshold->impulse * SW_SEEK_DBUV_PER_IMPULSE;
+
+	return dbuv * SW_SEEK_SIGNAL_PER_DBUV;
+}
+
+/* usec to wait for signal after tuning */
+int
+_mmradio_sw_seek_settle(mm_radio_t* radio)
+{
+	return ( radio->seek_settle > 0 ? radio->seek_settle : SW_SEEK_DEFAULT_SETTLE ) * 1000;
+}
@@ -0,0 +1,240 @@
+/*
+ * libmm-radio
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: JongHyuk Choi <jhchoi.choi@samsung.com>, YoungHwan An <younghwan_.an@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <mm_error.h>
+#include <mm_debug.h>
+
+#include "mm_radio_priv.h"
+
+/*---------------------------------------------------------------------------
+    LOCAL FUNCTION PROTOTYPES:
+---------------------------------------------------------------------------*/
+static void*	__mmradio_tune_thread(void* data);
+
+/*===========================================================================
+  FUNCTION DEFINITIONS
+========================================================================== */
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_set_tune_mode()
+ * Desc   : set how mm_radio_set_frequency() is handled.
+ *          worker for coalescing mode is started or stopped here.
+ *          NOTE : it should be called without command lock. worker takes it.
+ *          mode changes are serialized by tune_mode_lock instead.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] mode : tune mode
+ * Return : zero on success, or negative value with error code
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_set_tune_mode(mm_radio_t* radio, MMRadioTuneMode mode)
+{
+	MMRadioTuneMode current = MM_RADIO_TUNE_MODE_SYNC;
+	int ret = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	return_val_if_fail( mode == MM_RADIO_TUNE_MODE_SYNC || mode == MM_RADIO_TUNE_MODE_COALESCE,
+		MM_ERROR_INVALID_ARGUMENT );
+
+	pthread_mutex_lock(&radio->tune_mode_lock);
+
+	pthread_mutex_lock(&radio->tune_lock);
+	current = radio->tune_mode;
+	pthread_mutex_unlock(&radio->tune_lock);
+
+	if ( mode == current )
+	{
+		pthread_mutex_unlock(&radio->tune_mode_lock);
+		return MM_ERROR_NONE;
+	}
+
+	if ( mode == MM_RADIO_TUNE_MODE_COALESCE )
+	{
+		pthread_mutex_lock(&radio->tune_lock);
+		radio->tune_pending = 0;
+		radio->tune_applying = 0;
+		radio->tune_stop = false;
+		pthread_mutex_unlock(&radio->tune_lock);
+
+		ret = pthread_create(&radio->tune_thread, NULL, __mmradio_tune_thread, (void*)radio);
+		if ( ret )
+		{
+			MMRADIO_LOG_ERROR("failed to create thread : tune\n");
+			radio->tune_thread = 0;
+			pthread_mutex_unlock(&radio->tune_mode_lock);
+			return MM_ERROR_RADIO_INTERNAL;
+		}
+
+		/* requests go to mailbox from now on */
+		pthread_mutex_lock(&radio->tune_lock);
+		radio->tune_mode = mode;
+		pthread_mutex_unlock(&radio->tune_lock);
+	}
+	else
+	{
+		/* new requests go to tuner directly from now on. pending one is applied before worker exits */
+		pthread_mutex_lock(&radio->tune_lock);
+		radio->tune_mode = mode;
+		radio->tune_stop = true;
+		pthread_cond_signal(&radio->tune_cond);
+		pthread_mutex_unlock(&radio->tune_lock);
+
+		/* callback of TUNE_DONE runs on worker. it leaves after the callback */
+		if ( pthread_equal(radio->tune_thread, pthread_self()) )
+			pthread_detach(radio->tune_thread);
+		else
+			pthread_join(radio->tune_thread, NULL);
+		radio->tune_thread = 0;
+	}
+
+	pthread_mutex_unlock(&radio->tune_mode_lock);
+
+	MMRADIO_LOG_DEBUG("tune mode : %d\n", mode);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+/* --------------------------------------------------------------------------
+ * Name   : _mmradio_request_frequency()
+ * Desc   : put frequency into mailbox of worker. older request in it is replaced.
+ *          request same with the one in mailbox, the one being applied or
+ *          the frequency tuned last time is ignored.
+ *          NOTE : it's called without command lock. it never waits for tuner.
+ * Param  :
+ *	    [in] radio : radio handle
+ *	    [in] freq : frequency, KHz
+ * Return : zero on success, or negative value with error code.
+ *          MM_ERROR_RADIO_NO_OP if it's not coalescing mode. caller applies it by itself.
+ *---------------------------------------------------------------------------*/
+int
+_mmradio_request_frequency(mm_radio_t* radio, int freq)
+{
+	int current = 0;
+
+	MMRADIO_LOG_FENTER();
+
+	MMRADIO_CHECK_INSTANCE( radio );
+
+	pthread_mutex_lock(&radio->tune_lock);
+
+	if ( radio->tune_mode != MM_RADIO_TUNE_MODE_COALESCE )
+	{
+		pthread_mutex_unlock(&radio->tune_lock);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+
+	if ( freq <= 0 )
+	{
+		pthread_mutex_unlock(&radio->tune_lock);
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	/* latest one tuner will be on */
+	current = radio->tune_pending ? radio->tune_pending : radio->tune_applying;
+	if ( ! current )
+		current = _mmradio_get_tuned_frequency(radio);
+
+	if ( freq == current )
+	{
+		pthread_mutex_unlock(&radio->tune_lock);
+		MMRADIO_LOG_DEBUG("%d KHz is requested already\n", freq);
+		return MM_ERROR_NONE;
+	}
+
+	if ( radio->tune_pending )
+		MMRADIO_LOG_DEBUG("%d KHz is replaced by %d KHz\n", radio->tune_pending, freq);
+
+	radio->tune_pending = freq;
+	pthread_cond_signal(&radio->tune_cond);
+
+	pthread_mutex_unlock(&radio->tune_lock);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return MM_ERROR_NONE;
+}
+
+static void*
+__mmradio_tune_thread(void* data)
+{
+	mm_radio_t* radio = (mm_radio_t*)data;
+
+	MMRADIO_LOG_FENTER();
+
+	pthread_mutex_lock(&radio->tune_lock);
+
+	while ( 1 )
+	{
+		MMMessageParamType param = {0,};
+		int freq = 0;
+		int ret = MM_ERROR_NONE;
+
+		while ( ! radio->tune_pending && ! radio->tune_stop )
+			pthread_cond_wait(&radio->tune_cond, &radio->tune_lock);
+
+		if ( ! radio->tune_pending )
+			break;
+
+		/* take the latest one. requests coming while tuning replace each other */
+		freq = radio->tune_pending;
+		radio->tune_pending = 0;
+		radio->tune_applying = freq;
+
+		pthread_mutex_unlock(&radio->tune_lock);
+
+		MMRADIO_CMD_LOCK( radio );
+		ret = _mmradio_set_frequency(radio, freq);
+		if ( ret == MM_ERROR_NONE )
+			freq = radio->freq;
+		MMRADIO_CMD_UNLOCK( radio );
+
+		if ( ret == MM_ERROR_NONE )
+		{
+			param.radio_scan.frequency = freq;
+			MMRADIO_POST_MSG(radio, MM_MESSAGE_RADIO_TUNE_DONE, &param);
+		}
+		else
+		{
+			MMRADIO_LOG_ERROR("failed to tune to %d KHz\n", freq);
+			param.union_type = MM_MSG_UNION_CODE;
+			param.code = ret;
+			MMRADIO_POST_MSG(radio, MM_MESSAGE_ERROR, &param);
+		}
+
+		pthread_mutex_lock(&radio->tune_lock);
+		radio->tune_applying = 0;
+	}
+
+	pthread_mutex_unlock(&radio->tune_lock);
+
+	MMRADIO_LOG_FLEAVE();
+
+	return NULL;
+}
@@ -46,4 +46,29 @@ typedef struct __test_item
 			printf("FAIL : %s ERR-CODE : 0x%x -- %s:%d\n", #x_test, ret, __FILE__, __LINE__);	\
 		}
 
+/* same as RADIO_TEST__, and counts failures of the test item */
+#define RADIO_EXPECT__(x_test)	\
+		ret = x_test	\
+		if ( ! ret )	\
+		{	\
+			printf("PASS : %s -- %s:%d\n", #x_test, __FILE__, __LINE__);	\
+		}	\
+		else	\
+		{	\
+			printf("FAIL : %s ERR-CODE : 0x%x -- %s:%d\n", #x_test, ret, __FILE__, __LINE__);	\
+			failures++;	\
+		}
+
+/* check a condition, and counts failures of the test item */
+#define RADIO_CHECK__(x_cond)	\
+		if ( x_cond )	\
+		{	\
+			printf("PASS : %s -- %s:%d\n", #x_cond, __FILE__, __LINE__);	\
+		}	\
+		else	\
+		{	\
+			printf("FAIL : %s -- %s:%d\n", #x_cond, __FILE__, __LINE__);	\
+			failures++;	\
+		}
+
 #endif /* MM_RADIO_TEST_TYPE_H_ */
@@ -22,6 +22,12 @@
 /* testsuite for mm-radio library */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
 #include <mm_ta.h>
 
 
@@ -31,6 +37,64 @@
 
 #define DEFAULT_TEST_FREQ	107700
 
+/* station map of simulated tuner */
+static const MMRadioSimStation g_sim_stations[] =
+{
+	{ 89100, 40000 },
+	{ 91900, 52000 },
+	{ 93900, 30000 },
+	{ 95100, 45000 },
+	{ 97300, 61000 },
+	{ 99900, 38000 },
+	{ 101900, 55000 },
+	{ 103500, 33000 },
+	{ 105300, 47000 },
+	{ 107700, 58000 },
+};
+
+#define SIM_MAX_SCAN		128
+#define SIM_TIMEOUT			10000	/* msec */
+#define SIM_SIGNAL_PER_DBUV	874		/* signal scale of simulated si470x */
+
+/* API called from callback */
+#define SIM_CALL_GET_STATE	1		/* mm_radio_get_state() from callbacks of seek, scan and signal */
+#define SIM_CALL_STOP_SCAN	2		/* mm_radio_scan_stop() from the first station of scan */
+
+/* messages of simulated tuner. guarded by g_sim_lock */
+typedef struct {
+	int state;
+	int ready;
+	int errors;
+	int seek_started;
+	struct timeval seek_started_time;
+	int seek_finished;
+	int seek_freq;
+	MMRadioSeekResult seek_result;
+	int seek_results;
+	int scan_started;
+	int scan_stopped;
+	int scan_finished;
+	int scan_freqs[SIM_MAX_SCAN];
+	int scan_count;
+	int scan_batches;
+	int batch_gaps;
+	MMRadioScanResult scan_result;
+	int scan_results;
+	MMRadioScanProgress progress;
+	int progress_count;
+	int progress_backward;
+	int tune_freq;
+	int tune_count;
+	int signal_count;
+	int stations_changed;
+	int call_api;		/* SIM_CALL_XXX to call API from callback. zero for none */
+	int api_calls;
+} sim_events_t;
+
+static sim_events_t g_sim;
+static pthread_mutex_t g_sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_sim_cond = PTHREAD_COND_INITIALIZER;
+
 /* test items...*/
 int __test_radio_init(void);
 int __test_radio_listen_gorealra(void);
@@ -40,8 +104,23 @@ int __test_repeat_seek(void);
 int __test_repeat_whole(void);
 int __test_manual_api_calling(void);
 int __test_radio_hw_debug(void);
+int __test_simulated_tuner(void);
+int __test_sim_tune(void);
+int __test_sim_signal_monitor(void);
+int __test_sim_scan(void);
+int __test_sim_scan_engines(void);
+int __test_sim_scan_stop(void);
+int __test_sim_sweep(void);
+int __test_sim_station_refresh(void);
+int __test_sim_realize_async(void);
+int __test_sim_stress(void);
+int __test_multiple_tuners(void);
+int __test_repeat_realize_unrealize(void);
 
 static int __msg_callback(int message, void *param, void *user_param);
+static int __sim_msg_callback(int message, void *param, void *user_param);
+static int __sim_sweep_callback(int channels_done, int num_channels, void *user_param);
+static void __fill_sim_config(MMRadioSimConfig* config);
 
 /* functions*/
 static void __print_menu(void);
@@ -104,6 +183,90 @@ test_item_t g_tests[100] =
       	0
 	},
 
+	{
+		"simulated tuner",
+  		"realize and seek with simulated tuner, and check stations found by each seek profile. no radio hardware is needed",
+  		__test_simulated_tuner,
+      	0
+	},
+
+	{
+		"sim tune",
+  		"coalesce tunes, poll frequency and signal, and read tuner status of simulated tuner",
+  		__test_sim_tune,
+      	0
+	},
+
+	{
+		"sim signal monitor",
+  		"check signal notifications and quality history of simulated tuner",
+  		__test_sim_signal_monitor,
+      	0
+	},
+
+	{
+		"sim scan",
+  		"scan simulated tuner into station database, and scan again with busy tuner",
+  		__test_sim_scan,
+      	0
+	},
+
+	{
+		"sim scan engines",
+  		"compare stations found by hardware seek, software seek, multiple tuners and batch delivery",
+  		__test_sim_scan_engines,
+      	0
+	},
+
+	{
+		"sim scan stop",
+  		"stop and resume scan, scan in time budget, and measure stop latency",
+  		__test_sim_scan_stop,
+      	0
+	},
+
+	{
+		"sim sweep",
+  		"sweep the band of simulated tuner, and cancel it at the half",
+  		__test_sim_sweep,
+      	0
+	},
+
+	{
+		"sim station refresh",
+  		"refresh stations in background by secondary tuner and idle tuner",
+  		__test_sim_station_refresh,
+      	0
+	},
+
+	{
+		"sim realize async",
+  		"realize simulated tuner asynchronously, and cancel it by unrealize",
+  		__test_sim_realize_async,
+      	0
+	},
+
+	{
+		"sim stress",
+  		"run 10k seeks, and check threads, memory and statistics after them",
+  		__test_sim_stress,
+      	0
+	},
+
+	{
+		"multiple tuners",
+  		"list radio devices, and then play one simulated tuner while scanning with another one",
+  		__test_multiple_tuners,
+      	0
+	},
+
+	{
+		"repeat realize unrealize",
+  		"repeat realize and unrealize with simulated tuner, and compare latency with keep-warm",
+  		__test_repeat_realize_unrealize,
+      	0
+	},
+
  	/* add tests here*/
 
  	/* NOTE : do not remove this last item */
@@ -115,21 +278,21 @@ int g_num_of_tests = 0;
 int main(int argc, char **argv)
 {
 	MMTA_INIT();
-	char key = 0;
+	char line[16];
 
 	do {
 		__print_menu();
 
-		do {
-			key = getchar();
-			
-			if ( key >= '0' && key <= '9')
-			{
-				__run_test( key - '0' );
-			}
-		}while ( key == '\n' );
-	}while(key != 'q' && key == 'Q');
-	
+		/* number of test item. there are more than 10 items */
+		if ( ! fgets(line, sizeof(line), stdin) )
+			break;
+
+		if ( line[0] >= '0' && line[0] <= '9' )
+		{
+			__run_test( atoi(line) );
+		}
+	}while( line[0] != 'q' && line[0] != 'Q' );
+
 	printf("radio test client finished\n");
 
 	return 0;
@@ -328,3 +491,1314 @@ int __test_manual_api_calling(void)
 	return 0;
 }
 
+static long long __elapsed_usec(struct timeval* begin)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+
+	return (now.tv_sec - begin->tv_sec) * 1000000LL + (now.tv_usec - begin->tv_usec);
+}
+
+/* clear messages of simulated tuner before an operation */
+static void __sim_reset(int call_api)
+{
+	pthread_mutex_lock(&g_sim_lock);
+	memset(&g_sim, 0, sizeof(g_sim));
+	g_sim.call_api = call_api;
+	g_sim.progress.remaining = -1;
+	pthread_mutex_unlock(&g_sim_lock);
+}
+
+/* copy of messages so far */
+static sim_events_t __sim_events(void)
+{
+	sim_events_t events;
+
+	pthread_mutex_lock(&g_sim_lock);
+	events = g_sim;
+	pthread_mutex_unlock(&g_sim_lock);
+
+	return events;
+}
+
+/* wait until field of g_sim reaches value, or becomes value if exact. zero on timeout */
+static int __sim_wait_field(const int* field, int value, int exact)
+{
+	struct timespec ts;
+	int reached = 0;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += SIM_TIMEOUT / 1000;
+
+	pthread_mutex_lock(&g_sim_lock);
+
+	while ( ! ( reached = ( exact ? *field == value : *field >= value ) ) )
+	{
+		if ( pthread_cond_timedwait(&g_sim_cond, &g_sim_lock, &ts) == ETIMEDOUT )
+		{
+			reached = ( exact ? *field == value : *field >= value );
+			break;
+		}
+	}
+
+	if ( ! reached )
+		printf("timeout : waiting for %d, but it's %d\n", value, *field);
+
+	pthread_mutex_unlock(&g_sim_lock);
+
+	return reached;
+}
+
+/* wait until count messages are counted by counter of g_sim */
+static int __sim_wait(const int* counter, int count)
+{
+	return __sim_wait_field(counter, count, 0);
+}
+
+static int __sim_msg_callback(int message, void *pParam, void *user_param)
+{
+	MMMessageParamType* param = (MMMessageParamType*)pParam;
+	MMHandleType radio = (MMHandleType)user_param;
+	int call_api = 0;
+	int i = 0;
+
+	pthread_mutex_lock(&g_sim_lock);
+
+	switch(message)
+	{
+	case MM_MESSAGE_STATE_CHANGED:
+		g_sim.state = param->state.current;
+		if ( param->state.current == MM_RADIO_STATE_READY )
+			g_sim.ready++;
+		break;
+	case MM_MESSAGE_ERROR:
+		printf("MM_MESSAGE_ERROR : 0x%x\n", param->code);
+		g_sim.errors++;
+		break;
+	case MM_MESSAGE_RADIO_SCAN_START:
+		g_sim.scan_started++;
+		break;
+	case MM_MESSAGE_RADIO_SCAN_INFO:
+		if ( g_sim.scan_count < SIM_MAX_SCAN )
+			g_sim.scan_freqs[g_sim.scan_count] = param->radio_scan.frequency;
+		g_sim.scan_count++;
+		break;
+	case MM_MESSAGE_RADIO_SCAN_STOP:
+		g_sim.scan_stopped++;
+		break;
+	case MM_MESSAGE_RADIO_SCAN_FINISH:
+		g_sim.scan_finished++;
+		break;
+	case MM_MESSAGE_RADIO_SEEK_START:
+		gettimeofday(&g_sim.seek_started_time, NULL);
+		g_sim.seek_started++;
+		break;
+	case MM_MESSAGE_RADIO_SEEK_FINISH:
+		g_sim.seek_freq = param->radio_scan.frequency;
+		g_sim.seek_finished++;
+		break;
+	case MM_MESSAGE_RADIO_SIGNAL:
+		g_sim.signal_count++;
+		break;
+	case MM_MESSAGE_RADIO_TUNE_DONE:
+		g_sim.tune_freq = param->radio_scan.frequency;
+		g_sim.tune_count++;
+		break;
+	case MM_MESSAGE_RADIO_SEEK_RESULT:
+		/* posted after SEEK_FINISH */
+		g_sim.seek_result = *(MMRadioSeekResult*)param->data;
+		g_sim.seek_results++;
+		break;
+	case MM_MESSAGE_RADIO_SCAN_BATCH:
+	{
+		MMRadioScanBatch* batch = (MMRadioScanBatch*)param->data;
+
+		/* stations before first_new are delivered already */
+		if ( batch->first_new != g_sim.scan_count )
+			g_sim.batch_gaps++;
+		for ( i = batch->first_new; i < batch->num_stations && i < SIM_MAX_SCAN; i++ )
+			g_sim.scan_freqs[i] = batch->stations[i].frequency;
+		g_sim.scan_count = batch->num_stations;
+		g_sim.scan_batches++;
+	}
+		break;
+	case MM_MESSAGE_RADIO_STATIONS_CHANGED:
+		g_sim.stations_changed = param->code;
+		break;
+	case MM_MESSAGE_RADIO_SCAN_PROGRESS:
+		if ( ((MMRadioScanProgress*)param->data)->percent < g_sim.progress.percent )
+			g_sim.progress_backward++;
+		g_sim.progress = *(MMRadioScanProgress*)param->data;
+		g_sim.progress_count++;
+		break;
+	case MM_MESSAGE_RADIO_SCAN_RESULT:
+		/* posted after SCAN_FINISH */
+		g_sim.scan_result = *(MMRadioScanResult*)param->data;
+		g_sim.scan_results++;
+		break;
+	default:
+		break;
+	}
+
+	if ( g_sim.call_api == SIM_CALL_STOP_SCAN )
+	{
+		if ( ( message == MM_MESSAGE_RADIO_SCAN_INFO || message == MM_MESSAGE_RADIO_SCAN_BATCH ) && ! g_sim.api_calls )
+			call_api = SIM_CALL_STOP_SCAN;
+	}
+	else if ( g_sim.call_api && ( message == MM_MESSAGE_RADIO_SEEK_FINISH || message == MM_MESSAGE_RADIO_SCAN_INFO ||
+		message == MM_MESSAGE_RADIO_SCAN_BATCH || message == MM_MESSAGE_RADIO_SCAN_FINISH || message == MM_MESSAGE_RADIO_SIGNAL ) )
+	{
+		call_api = g_sim.call_api;
+	}
+
+	pthread_cond_broadcast(&g_sim_cond);
+	pthread_mutex_unlock(&g_sim_lock);
+
+	/* scan is finished after this callback returns */
+	if ( call_api == SIM_CALL_STOP_SCAN )
+	{
+		if ( mm_radio_scan_stop(radio) == MM_ERROR_NONE )
+		{
+			pthread_mutex_lock(&g_sim_lock);
+			g_sim.api_calls++;
+			pthread_cond_broadcast(&g_sim_cond);
+			pthread_mutex_unlock(&g_sim_lock);
+		}
+	}
+	/* like application updating its UI. stop or unrealize at the same time shouldn't wait for it forever */
+	else if ( call_api )
+	{
+		MMRadioStateType state = MM_RADIO_STATE_NULL;
+
+		usleep(5000);
+		if ( mm_radio_get_state(radio, &state) == MM_ERROR_NONE )
+		{
+			pthread_mutex_lock(&g_sim_lock);
+			g_sim.api_calls++;
+			pthread_cond_broadcast(&g_sim_cond);
+			pthread_mutex_unlock(&g_sim_lock);
+		}
+	}
+
+	return true;
+}
+
+/* user_param points the number of channels to stop at. zero means whole band */
+static int __sim_sweep_callback(int channels_done, int num_channels, void *user_param)
+{
+	int limit = *(int*)user_param;
+
+	return ( limit == 0 || channels_done < limit );
+}
+
+/* value of a line of /proc/self/status. kB for memory */
+static long __proc_status(const char* key)
+{
+	char line[128];
+	long value = -1;
+	FILE* fp = fopen("/proc/self/status", "r");
+
+	if ( ! fp )
+		return -1;
+
+	while ( fgets(line, sizeof(line), fp) )
+	{
+		if ( strncmp(line, key, strlen(key)) == 0 && line[strlen(key)] == ':' )
+		{
+			value = atol(line + strlen(key) + 1);
+			break;
+		}
+	}
+
+	fclose(fp);
+
+	return value;
+}
+
+#define SIM_STATION_DB		"/tmp/mm_radio_testsuite_stations.db"
+
+static void __fill_sim_config(MMRadioSimConfig* config)
+{
+	config->stations = g_sim_stations;
+	config->num_stations = sizeof(g_sim_stations) / sizeof(g_sim_stations[0]);
+	config->noise_floor = 5000;
+	config->rolloff = 30000;
+	config->seek_threshold = 20000;
+	config->latency = 1000;
+	config->seek_step_latency = 2000;
+}
+
+/* handle with simulated tuner. messages go to __sim_msg_callback */
+static int __sim_create(MMHandleType* radio, const MMRadioSimConfig* config)
+{
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+
+	RADIO_EXPECT__( mm_radio_create(radio); )
+	RADIO_EXPECT__( mm_radio_set_message_callback( *radio, (MMMessageCallback)__sim_msg_callback, (void*)*radio ); )
+	RADIO_EXPECT__( mm_radio_set_simulation( *radio, config ); )
+
+	return failures;
+}
+
+/* scan with current settings, and wait for its result */
+static int __sim_scan(MMHandleType radio, sim_events_t* events)
+{
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+
+	__sim_reset(0);
+	RADIO_EXPECT__( mm_radio_scan_start(radio); )
+	RADIO_CHECK__( __sim_wait(&g_sim.scan_results, 1) )
+
+	*events = __sim_events();
+
+	return failures;
+}
+
+/* true if scan found just the stations of the map */
+static int __sim_found_stations(const sim_events_t* events)
+{
+	int num_stations = sizeof(g_sim_stations) / sizeof(g_sim_stations[0]);
+	int i = 0;
+
+	if ( events->scan_count != num_stations )
+		return 0;
+
+	for ( i = 0; i < num_stations; i++ )
+	{
+		if ( events->scan_freqs[i] != g_sim_stations[i].frequency )
+			return 0;
+	}
+
+	return 1;
+}
+
+/* true if both scans found same frequencies in same order */
+static int __sim_same_scan(const sim_events_t* a, const sim_events_t* b)
+{
+	return ( a->scan_count == b->scan_count && a->scan_count <= SIM_MAX_SCAN &&
+		memcmp(a->scan_freqs, b->scan_freqs, sizeof(int) * a->scan_count) == 0 );
+}
+
+/* realize, seek through the stations, and seek with each profile */
+int __test_simulated_tuner(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	int spacing = 0;
+	int profile = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	sim_events_t events;
+	struct timeval begin;
+	/* 4 seeks from 87500 KHz by profile. weak stations are skipped by strict one */
+	static const int profile_stations[][4] =
+	{
+		{ 89100, 91900, 93900, 95100 },		/* DEFAULT */
+		{ 89100, 91900, 93900, 95100 },		/* FAST */
+		{ 89100, 91900, 93900, 95100 },		/* NORMAL */
+		{ 91900, 97300, 101900, 105300 },	/* STRICT */
+	};
+
+	__fill_sim_config(&config);
+
+	failures += __sim_create(&radio, &config);
+	RADIO_EXPECT__( mm_radio_enable_stats( radio, 1 ); )
+
+	gettimeofday(&begin, NULL);
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+	printf("realize : %lld usec\n", __elapsed_usec(&begin));
+
+	/* tuner and controls are applied by one ioctl each at most */
+	{
+		MMRadioStatsEntry stats[32];
+		int num_stats = 0;
+		int applies = 0;
+
+		RADIO_EXPECT__( mm_radio_get_stats( radio, stats, 32, &num_stats, 0 ); )
+		for ( i = 0; i < num_stats && i < 32; i++ )
+		{
+			if ( strcmp(stats[i].name, "apply_settings") )
+				continue;
+
+			printf("realize applied settings %u time(s) by %u ioctl(s)\n", stats[i].count, stats[i].ioctls);
+			RADIO_CHECK__( stats[i].count > 0 && stats[i].ioctls <= 2 * stats[i].count )
+			applies++;
+		}
+		RADIO_CHECK__( applies == 1 )
+	}
+
+	RADIO_EXPECT__( mm_radio_get_channel_spacing( radio, &spacing ); )
+	RADIO_CHECK__( spacing == 200 )
+
+	RADIO_EXPECT__( mm_radio_set_frequency( radio, 87500 ); )
+	RADIO_EXPECT__( mm_radio_start(radio); )
+
+	for ( i = 0; i < config.num_stations; i++ )
+	{
+		__sim_reset(0);
+		gettimeofday(&begin, NULL);
+		RADIO_EXPECT__( mm_radio_seek(radio, MM_RADIO_SEEK_UP); )
+		RADIO_CHECK__( __sim_wait(&g_sim.seek_results, 1) )
+		events = __sim_events();
+		printf("seek : %d KHz, %lld usec\n", events.seek_freq, __elapsed_usec(&begin));
+		RADIO_CHECK__( events.seek_freq == g_sim_stations[i].frequency )
+		RADIO_CHECK__( events.seek_started == 1 && events.seek_finished == 1 )
+	}
+
+	/* stronger profile skips weak stations and noise around strong ones */
+	for ( profile = MM_RADIO_SEEK_PROFILE_FAST; profile <= MM_RADIO_SEEK_PROFILE_STRICT; profile++ )
+	{
+		RADIO_EXPECT__( mm_radio_set_seek_profile(radio, profile, NULL); )
+		RADIO_EXPECT__( mm_radio_set_frequency( radio, 87500 ); )
+
+		for ( i = 0; i < 4; i++ )
+		{
+			__sim_reset(0);
+			RADIO_EXPECT__( mm_radio_seek(radio, MM_RADIO_SEEK_UP); )
+			RADIO_CHECK__( __sim_wait(&g_sim.seek_results, 1) )
+			events = __sim_events();
+			printf("seek with profile %d : %d KHz, applied %d\n", profile, events.seek_freq, events.seek_result.applied);
+			RADIO_CHECK__( events.seek_freq == profile_stations[profile][i] )
+			RADIO_CHECK__( events.seek_result.profile == profile && events.seek_result.applied )
+		}
+	}
+
+	/* default profile brings back tuner's own thresholds */
+	RADIO_EXPECT__( mm_radio_set_seek_profile(radio, MM_RADIO_SEEK_PROFILE_DEFAULT, NULL); )
+	RADIO_EXPECT__( mm_radio_set_frequency( radio, 87500 ); )
+
+	for ( i = 0; i < 4; i++ )
+	{
+		__sim_reset(0);
+		RADIO_EXPECT__( mm_radio_seek(radio, MM_RADIO_SEEK_UP); )
+		RADIO_CHECK__( __sim_wait(&g_sim.seek_results, 1) )
+		events = __sim_events();
+		printf("seek with default profile again : %d KHz, rssi %d\n", events.seek_freq, events.seek_result.threshold.rssi);
+		RADIO_CHECK__( events.seek_freq == profile_stations[MM_RADIO_SEEK_PROFILE_DEFAULT][i] )
+		RADIO_CHECK__( ! events.seek_result.applied && events.seek_result.threshold.rssi == config.seek_threshold / SIM_SIGNAL_PER_DBUV )
+	}
+
+	/* unrealize waits for the seek, whose callback calls API */
+	__sim_reset(SIM_CALL_GET_STATE);
+	RADIO_EXPECT__( mm_radio_seek(radio, MM_RADIO_SEEK_UP); )
+	RADIO_EXPECT__( mm_radio_stop(radio); )
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	events = __sim_events();
+	RADIO_CHECK__( events.seek_finished == 1 && events.api_calls == 1 )
+
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+/* coalescing tune, reads from shadow, and status snapshot */
+int __test_sim_tune(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	MMRadioTunerStatus status = {0,};
+	sim_events_t events;
+	struct timeval begin;
+
+	__fill_sim_config(&config);
+
+	failures += __sim_create(&radio, &config);
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+	RADIO_EXPECT__( mm_radio_set_frequency( radio, 87500 ); )
+	RADIO_EXPECT__( mm_radio_start(radio); )
+
+	/* dragging dial. only some of them go to tuner, and the last one is applied always */
+	RADIO_EXPECT__( mm_radio_set_tune_mode(radio, MM_RADIO_TUNE_MODE_COALESCE); )
+	__sim_reset(0);
+	gettimeofday(&begin, NULL);
+	for ( i = 0; i < 100; i++ )
+	{
+		mm_radio_set_frequency(radio, 88000 + i * 100);
+		usleep(100);
+	}
+	printf("100 coalesced tunes : %lld usec\n", __elapsed_usec(&begin));
+	RADIO_CHECK__( __sim_wait_field(&g_sim.tune_freq, 88000 + 99 * 100, 1) )
+	events = __sim_events();
+	printf("coalesced tune done : %d KHz, %d tunes applied, %lld usec\n", events.tune_freq, events.tune_count, __elapsed_usec(&begin));
+	RADIO_CHECK__( events.tune_count >= 1 && events.tune_count < 100 )
+	RADIO_EXPECT__( mm_radio_set_tune_mode(radio, MM_RADIO_TUNE_MODE_SYNC); )
+
+	/* polling with shadow. only the first one goes to tuner */
+	gettimeofday(&begin, NULL);
+	for ( i = 0; i < 1000; i++ )
+	{
+		int freq = 0;
+		int signal = 0;
+
+		mm_radio_get_frequency(radio, &freq);
+		mm_radio_get_signal_strength(radio, &signal);
+		if ( freq != 97900 )
+			break;
+	}
+	printf("1000 polls of frequency and signal : %lld usec\n", __elapsed_usec(&begin));
+	RADIO_CHECK__( i == 1000 )
+
+	/* everything at once */
+	gettimeofday(&begin, NULL);
+	RADIO_EXPECT__( mm_radio_get_tuner_status(radio, &status); )
+	printf("tuner status : %lld usec, valid 0x%x, %d KHz, signal %d, snr %d, stereo %d, rds %d, afc rail %d\n",
+		__elapsed_usec(&begin), status.valid, status.frequency, status.signal, status.snr,
+		status.stereo, status.rds_ready, status.afc_rail);
+	RADIO_CHECK__( ( status.valid & MM_RADIO_STATUS_FREQUENCY ) && status.frequency == 97900 )
+	RADIO_CHECK__( ( status.valid & MM_RADIO_STATUS_SIGNAL ) && status.signal == config.noise_floor )
+
+	/* refused frequency isn't kept in the handle */
+	RADIO_CHECK__( mm_radio_set_frequency(radio, 120000) == MM_ERROR_INVALID_ARGUMENT )
+	RADIO_EXPECT__( mm_radio_stop(radio); )
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_get_frequency(radio, &i); )
+	RADIO_CHECK__( i == 97900 )
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+	RADIO_EXPECT__( mm_radio_start(radio); )
+
+	/* coalescing mode tunes back to the frequency tuned already */
+	RADIO_EXPECT__( mm_radio_set_tune_mode(radio, MM_RADIO_TUNE_MODE_COALESCE); )
+	__sim_reset(0);
+	RADIO_EXPECT__( mm_radio_set_frequency(radio, 97900); )
+	RADIO_EXPECT__( mm_radio_set_frequency(radio, 98100); )
+	RADIO_EXPECT__( mm_radio_set_frequency(radio, 97900); )
+	RADIO_EXPECT__( mm_radio_set_tune_mode(radio, MM_RADIO_TUNE_MODE_SYNC); )
+	RADIO_EXPECT__( mm_radio_get_tuner_status(radio, &status); )
+	RADIO_CHECK__( status.frequency == 97900 )
+
+	RADIO_EXPECT__( mm_radio_stop(radio); )
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+/* signal monitor and quality history */
+int __test_sim_signal_monitor(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	sim_events_t events;
+
+	__fill_sim_config(&config);
+
+	failures += __sim_create(&radio, &config);
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+	RADIO_EXPECT__( mm_radio_set_frequency( radio, DEFAULT_TEST_FREQ ); )
+	RADIO_EXPECT__( mm_radio_start(radio); )
+
+	/* stable signal should be notified just once */
+	__sim_reset(0);
+	RADIO_EXPECT__( mm_radio_start_signal_monitor(radio, 0); )
+	RADIO_EXPECT__( mm_radio_start_quality_sampling(radio, 50); )
+	RADIO_CHECK__( __sim_wait(&g_sim.signal_count, 1) )
+	sleep(2);
+	RADIO_EXPECT__( mm_radio_stop_signal_monitor(radio); )
+	events = __sim_events();
+	printf("signal monitor : %d notifications for 2 sec\n", events.signal_count);
+	RADIO_CHECK__( events.signal_count == 1 )
+
+	/* quality history is sampled while monitoring */
+	for ( i = 0; i < MM_RADIO_QUALITY_NUM; i++ )
+	{
+		MMRadioQualityStats stats = {0,};
+
+		RADIO_EXPECT__( mm_radio_get_quality_stats(radio, i, 1000, &stats); )
+		printf("quality %d for 1 sec : %d samples, min %d, max %d, mean %d, p10 %d, p50 %d, p90 %d\n",
+			i, stats.num_samples, stats.min, stats.max, stats.mean, stats.p10, stats.p50, stats.p90);
+		RADIO_CHECK__( stats.num_samples == 0 || ( stats.min <= stats.p10 && stats.p10 <= stats.p50 &&
+			stats.p50 <= stats.p90 && stats.p90 <= stats.max && stats.min <= stats.mean && stats.mean <= stats.max ) )
+		if ( i == MM_RADIO_QUALITY_RSSI )
+		{
+			RADIO_CHECK__( stats.num_samples > 0 )
+		}
+	}
+	RADIO_EXPECT__( mm_radio_stop_quality_sampling(radio); )
+
+	/* stop waits for the callback, which calls API */
+	__sim_reset(SIM_CALL_GET_STATE);
+	RADIO_EXPECT__( mm_radio_start_signal_monitor(radio, 0); )
+	RADIO_CHECK__( __sim_wait(&g_sim.signal_count, 1) )
+	RADIO_EXPECT__( mm_radio_stop_signal_monitor(radio); )
+	events = __sim_events();
+	RADIO_CHECK__( events.signal_count == 1 && events.api_calls == 1 )
+
+	RADIO_EXPECT__( mm_radio_stop(radio); )
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+/* scan into station database, presets from it, and retries with busy tuner */
+int __test_sim_scan(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	int num_stations = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	MMRadioStateType state = MM_RADIO_STATE_NULL;
+	MMRadioStation stations[16];
+	sim_events_t events;
+	struct timeval begin;
+
+	__fill_sim_config(&config);
+
+	failures += __sim_create(&radio, &config);
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+
+	/* stations found by scan are stored */
+	unlink(SIM_STATION_DB);
+	RADIO_EXPECT__( mm_radio_set_station_db(radio, SIM_STATION_DB); )
+
+	gettimeofday(&begin, NULL);
+	failures += __sim_scan(radio, &events);
+	printf("scan : %d stations, %lld usec\n", events.scan_count, __elapsed_usec(&begin));
+	RADIO_CHECK__( __sim_found_stations(&events) )
+	RADIO_CHECK__( events.scan_started == 1 && events.scan_finished == 1 && events.scan_stopped == 0 )
+	RADIO_CHECK__( events.scan_result.num_stations == config.num_stations && events.scan_result.error == MM_ERROR_NONE )
+	RADIO_EXPECT__( mm_radio_get_state(radio, &state); )
+	RADIO_CHECK__( state == MM_RADIO_STATE_READY )
+
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	/* busy tuner. hardware seek is retried with backoff */
+	config.seek_failures = 2;
+	failures += __sim_create(&radio, &config);
+
+	/* presets of last scan without scanning again */
+	gettimeofday(&begin, NULL);
+	RADIO_EXPECT__( mm_radio_set_station_db(radio, SIM_STATION_DB); )
+	RADIO_EXPECT__( mm_radio_get_stations(radio, stations, 16, &num_stations); )
+	printf("stored stations : %d, %lld usec\n", num_stations, __elapsed_usec(&begin));
+	RADIO_CHECK__( num_stations == config.num_stations )
+	for ( i = 0; i < num_stations && i < 16; i++ )
+	{
+		RADIO_CHECK__( stations[i].frequency == g_sim_stations[i].frequency )
+	}
+
+	RADIO_EXPECT__( mm_radio_invalidate_stations(radio, stations[0].frequency); )
+	RADIO_EXPECT__( mm_radio_get_stations(radio, NULL, 0, &num_stations); )
+	RADIO_CHECK__( num_stations == config.num_stations - 1 )
+
+	RADIO_EXPECT__( mm_radio_merge_stations(radio, stations, 1); )
+	RADIO_EXPECT__( mm_radio_get_stations(radio, NULL, 0, &num_stations); )
+	RADIO_CHECK__( num_stations == config.num_stations )
+
+	/* truncated list keeps the lowest frequencies though merged one is stored last */
+	RADIO_EXPECT__( mm_radio_get_stations(radio, stations, 3, &num_stations); )
+	RADIO_CHECK__( num_stations == config.num_stations )
+	for ( i = 0; i < 3; i++ )
+	{
+		RADIO_CHECK__( stations[i].frequency == g_sim_stations[i].frequency )
+	}
+
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+	RADIO_EXPECT__( mm_radio_set_frequency( radio, 87500 ); )
+	RADIO_EXPECT__( mm_radio_start(radio); )
+
+	__sim_reset(0);
+	RADIO_EXPECT__( mm_radio_seek(radio, MM_RADIO_SEEK_UP); )
+	RADIO_CHECK__( __sim_wait(&g_sim.seek_results, 1) )
+	events = __sim_events();
+	printf("seek with busy tuner : %d KHz, %d retries, %d msec\n", events.seek_freq, events.seek_result.retries, events.seek_result.elapsed);
+	RADIO_CHECK__( events.seek_freq == g_sim_stations[0].frequency && events.seek_result.retries == config.seek_failures )
+
+	RADIO_EXPECT__( mm_radio_stop(radio); )
+
+	failures += __sim_scan(radio, &events);
+	printf("scan with busy tuner : %d stations, %d retries, %d msec\n", events.scan_count, events.scan_result.retries, events.scan_result.elapsed);
+	RADIO_CHECK__( __sim_found_stations(&events) && events.scan_result.retries > 0 )
+
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	/* station on the top channel of the band. seek and scan stop at band limit there too */
+	{
+		MMRadioSimStation top_stations[sizeof(g_sim_stations) / sizeof(g_sim_stations[0])];
+		MMRadioScanTuner scan_tuners[1] = { {"/dev/radio1", 0} };
+		int freq = 0;
+
+		/* the last one is moved to the top */
+		memcpy(top_stations, g_sim_stations, sizeof(g_sim_stations));
+		top_stations[config.num_stations - 1].frequency = 107900;
+		config.stations = top_stations;
+		config.seek_failures = 0;
+
+		failures += __sim_create(&radio, &config);
+		RADIO_EXPECT__( mm_radio_realize(radio); )
+
+		for ( i = 0; i <= 1; i++ )
+		{
+			RADIO_EXPECT__( mm_radio_set_scan_tuners( radio, scan_tuners, i ); )
+			failures += __sim_scan(radio, &events);
+			printf("scan by %d tuner(s) with station on top channel : %d stations, last %d KHz\n", i + 1, events.scan_count,
+				events.scan_count ? events.scan_freqs[events.scan_count - 1] : 0);
+			RADIO_CHECK__( events.scan_count == config.num_stations && events.scan_freqs[events.scan_count - 1] == 107900 )
+		}
+
+		RADIO_EXPECT__( mm_radio_set_frequency( radio, 105300 ); )
+		RADIO_EXPECT__( mm_radio_start(radio); )
+		__sim_reset(0);
+		RADIO_EXPECT__( mm_radio_seek(radio, MM_RADIO_SEEK_UP); )
+		RADIO_CHECK__( __sim_wait(&g_sim.seek_results, 1) )
+		RADIO_EXPECT__( mm_radio_get_frequency(radio, &freq); )
+		RADIO_CHECK__( __sim_events().seek_freq == 107900 && freq == 107900 )
+
+		RADIO_EXPECT__( mm_radio_stop(radio); )
+		RADIO_EXPECT__( mm_radio_unrealize(radio); )
+		RADIO_EXPECT__( mm_radio_destroy(radio); )
+	}
+
+	return failures;
+}
+
+/* hardware and software seek, band divided among tuners, and batch delivery */
+int __test_sim_scan_engines(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	MMRadioScanTuner scan_tuners[3] = { {"/dev/radio1", 0}, {"/dev/radio2", 0}, {"/dev/radio3", 0} };
+	sim_events_t full;
+	sim_events_t events;
+	struct timeval begin;
+
+	/* signal falls about 11dB per 100KHz like si470x. hardware seek stops next to strong stations too */
+	__fill_sim_config(&config);
+	config.rolloff = 10000;
+
+	failures += __sim_create(&radio, &config);
+
+	/* hardware seek against software seek with the same settle time as raster step of hardware */
+	for ( i = MM_RADIO_SEEK_ENGINE_HARDWARE; i <= MM_RADIO_SEEK_ENGINE_SOFTWARE; i++ )
+	{
+		MMRadioSeekEngine engine = MM_RADIO_SEEK_ENGINE_AUTO;
+
+		/* tuner without hardware seek. auto chooses software */
+		config.no_hw_seek = ( i == MM_RADIO_SEEK_ENGINE_SOFTWARE );
+		RADIO_EXPECT__( mm_radio_set_simulation( radio, &config ); )
+		RADIO_EXPECT__( mm_radio_set_seek_engine( radio, MM_RADIO_SEEK_ENGINE_AUTO, config.seek_step_latency / 1000 ); )
+		RADIO_EXPECT__( mm_radio_realize(radio); )
+		RADIO_EXPECT__( mm_radio_get_seek_engine( radio, &engine ); )
+		RADIO_CHECK__( engine == i )
+
+		gettimeofday(&begin, NULL);
+		failures += __sim_scan(radio, &events);
+		printf("scan by %s seek : %d stations, %lld usec\n",
+			( engine == MM_RADIO_SEEK_ENGINE_SOFTWARE ) ? "software" : "hardware", events.scan_count, __elapsed_usec(&begin));
+
+		/* software seek samples each channel, so it finds the peaks only */
+		if ( engine == MM_RADIO_SEEK_ENGINE_SOFTWARE )
+		{
+			int counts[MM_RADIO_SEEK_PROFILE_NUM] = {0,};
+			int profile = 0;
+
+			RADIO_CHECK__( __sim_found_stations(&events) )
+
+			/* stricter profile finds fewer stations though it has lower RSSI threshold */
+			for ( profile = MM_RADIO_SEEK_PROFILE_FAST; profile <= MM_RADIO_SEEK_PROFILE_STRICT; profile++ )
+			{
+				RADIO_EXPECT__( mm_radio_set_seek_profile(radio, profile, NULL); )
+				failures += __sim_scan(radio, &events);
+				counts[profile] = events.scan_count;
+				printf("scan by software seek with profile %d : %d stations\n", profile, counts[profile]);
+			}
+
+			RADIO_CHECK__( counts[MM_RADIO_SEEK_PROFILE_FAST] > counts[MM_RADIO_SEEK_PROFILE_NORMAL] )
+			RADIO_CHECK__( counts[MM_RADIO_SEEK_PROFILE_NORMAL] > counts[MM_RADIO_SEEK_PROFILE_STRICT] )
+			RADIO_CHECK__( counts[MM_RADIO_SEEK_PROFILE_STRICT] > 0 )
+
+			RADIO_EXPECT__( mm_radio_set_seek_profile(radio, MM_RADIO_SEEK_PROFILE_DEFAULT, NULL); )
+		}
+		else
+		{
+			RADIO_CHECK__( events.scan_count > config.num_stations && events.scan_count <= SIM_MAX_SCAN )
+			full = events;
+		}
+
+		RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	}
+
+	/* band divided among 1, 2 and 4 tuners. same stations in same order, in fraction of time */
+	config.no_hw_seek = 0;
+	RADIO_EXPECT__( mm_radio_set_simulation( radio, &config ); )
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+
+	for ( i = 0; i <= 3; i += ( i == 0 ) ? 1 : 2 )
+	{
+		RADIO_EXPECT__( mm_radio_set_scan_tuners( radio, scan_tuners, i ); )
+
+		gettimeofday(&begin, NULL);
+		failures += __sim_scan(radio, &events);
+		printf("scan by %d tuner(s) : %d stations, %lld usec\n", i + 1, events.scan_count, __elapsed_usec(&begin));
+		RADIO_CHECK__( __sim_same_scan(&events, &full) )
+	}
+
+	/* same scan delivered in batches of 4, and once at the end. stations are read from the array of the handle */
+	for ( i = 4; i >= MM_RADIO_SCAN_BATCH_AT_END; i -= 5 )
+	{
+		MMRadioScanBatch results = {0,};
+		int same = 1;
+		int n = 0;
+
+		RADIO_EXPECT__( mm_radio_set_scan_batch( radio, i ); )
+
+		failures += __sim_scan(radio, &events);
+		RADIO_EXPECT__( mm_radio_get_scan_results( radio, &results ); )
+		printf("scan in batches of %d : %d batches, %d stations, %d in results\n", i, events.scan_batches, events.scan_count,
+			results.num_stations);
+
+		RADIO_CHECK__( __sim_same_scan(&events, &full) && events.batch_gaps == 0 )
+		RADIO_CHECK__( i > 0 ? events.scan_batches >= 1 : events.scan_batches == 1 )
+		RADIO_CHECK__( results.finished && results.num_stations == full.scan_count )
+		for ( n = 0; n < results.num_stations && n < SIM_MAX_SCAN; n++ )
+			same = same && ( results.stations[n].frequency == full.scan_freqs[n] );
+		RADIO_CHECK__( same )
+	}
+
+	RADIO_EXPECT__( mm_radio_set_scan_batch( radio, 0 ); )
+
+	/* channels next to a station are merged into it. confirmed by dwell if scanned by one tuner */
+	for ( i = 3; i >= 0; i -= 3 )
+	{
+		RADIO_EXPECT__( mm_radio_set_scan_tuners( radio, scan_tuners, i ); )
+		RADIO_EXPECT__( mm_radio_set_scan_dedup( radio, 400, i ? 0 : 10 ); )
+
+		gettimeofday(&begin, NULL);
+		failures += __sim_scan(radio, &events);
+		printf("scan merging by %d tuner(s) : %d stations, %d merged, %lld usec\n", i + 1, events.scan_count,
+			events.scan_result.merged, __elapsed_usec(&begin));
+		RADIO_CHECK__( __sim_found_stations(&events) )
+		RADIO_CHECK__( events.scan_result.merged == full.scan_count - config.num_stations )
+	}
+
+	RADIO_EXPECT__( mm_radio_set_scan_dedup( radio, 0, 0 ); )
+
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+/* scan stopped in the middle, resumed, and limited by time budget */
+int __test_sim_scan_stop(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	MMRadioScanTuner scan_tuners[3] = { {"/dev/radio1", 0}, {"/dev/radio2", 0}, {"/dev/radio3", 0} };
+	MMRadioStateType state = MM_RADIO_STATE_NULL;
+	sim_events_t full;
+	sim_events_t events;
+	struct timeval begin;
+
+	__fill_sim_config(&config);
+	config.rolloff = 10000;
+
+	failures += __sim_create(&radio, &config);
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+
+	failures += __sim_scan(radio, &full);
+	RADIO_CHECK__( full.scan_count > config.num_stations && full.scan_count <= SIM_MAX_SCAN )
+
+	/* scan stopped in the middle goes on from there. stations of both are in results */
+	{
+		MMRadioScanBatch results = {0,};
+		int stopped_count = 0;
+		int same = 1;
+
+		__sim_reset(0);
+		RADIO_EXPECT__( mm_radio_scan_start(radio); )
+		RADIO_CHECK__( __sim_wait(&g_sim.scan_count, full.scan_count / 2) )
+		RADIO_EXPECT__( mm_radio_scan_stop(radio); )
+		events = __sim_events();
+		stopped_count = events.scan_count;
+		RADIO_CHECK__( events.scan_stopped == 1 && events.scan_finished == 0 && events.state == MM_RADIO_STATE_READY )
+		RADIO_EXPECT__( mm_radio_get_state(radio, &state); )
+		RADIO_CHECK__( state == MM_RADIO_STATE_READY )
+
+		gettimeofday(&begin, NULL);
+		__sim_reset(0);
+		RADIO_EXPECT__( mm_radio_scan_resume(radio); )
+		RADIO_CHECK__( __sim_wait(&g_sim.scan_results, 1) )
+		events = __sim_events();
+		RADIO_EXPECT__( mm_radio_get_scan_results( radio, &results ); )
+		printf("scan resumed after %d stations : %d more, %d in results, %lld usec\n", stopped_count, events.scan_count,
+			results.num_stations, __elapsed_usec(&begin));
+
+		RADIO_CHECK__( stopped_count + events.scan_count == full.scan_count && results.num_stations == full.scan_count )
+		for ( i = 0; i < results.num_stations && i < SIM_MAX_SCAN; i++ )
+			same = same && ( results.stations[i].frequency == full.scan_freqs[i] );
+		RADIO_CHECK__( same )
+	}
+
+	/* stop waits for the scan, whose callback calls API */
+	__sim_reset(SIM_CALL_GET_STATE);
+	RADIO_EXPECT__( mm_radio_scan_start(radio); )
+	RADIO_CHECK__( __sim_wait(&g_sim.scan_count, 3) )
+	RADIO_EXPECT__( mm_radio_scan_stop(radio); )
+	RADIO_EXPECT__( mm_radio_get_state(radio, &state); )
+	events = __sim_events();
+	RADIO_CHECK__( state == MM_RADIO_STATE_READY && events.scan_stopped == 1 && events.scan_finished == 0 && events.api_calls >= 3 )
+
+	/* callback of the first station stops the scan. no station comes after SCAN_STOP */
+	__sim_reset(SIM_CALL_STOP_SCAN);
+	RADIO_EXPECT__( mm_radio_scan_start(radio); )
+	RADIO_CHECK__( __sim_wait(&g_sim.scan_stopped, 1) )
+	usleep(50000);
+	RADIO_EXPECT__( mm_radio_get_state(radio, &state); )
+	events = __sim_events();
+	RADIO_CHECK__( state == MM_RADIO_STATE_READY && events.state == MM_RADIO_STATE_READY && events.api_calls == 1 )
+	RADIO_CHECK__( events.scan_count == 1 && events.scan_stopped == 1 && events.scan_finished == 0 )
+
+	/* same by callback of the first batch. scan waits for delivery thread, which doesn't wait for scan */
+	RADIO_EXPECT__( mm_radio_set_scan_batch(radio, 2); )
+	__sim_reset(SIM_CALL_STOP_SCAN);
+	RADIO_EXPECT__( mm_radio_scan_start(radio); )
+	RADIO_CHECK__( __sim_wait(&g_sim.scan_stopped, 1) )
+	usleep(50000);
+	RADIO_EXPECT__( mm_radio_get_state(radio, &state); )
+	events = __sim_events();
+	RADIO_CHECK__( state == MM_RADIO_STATE_READY && events.api_calls == 1 && events.scan_batches == 1 && events.scan_finished == 0 )
+	RADIO_EXPECT__( mm_radio_set_scan_batch(radio, 0); )
+
+	/* known stations first, and then the band until the budget runs out. and whole band without budget */
+	unlink(SIM_STATION_DB);
+	RADIO_EXPECT__( mm_radio_set_station_db(radio, SIM_STATION_DB); )
+	failures += __sim_scan(radio, &events);
+
+	for ( i = 100; i >= 0; i -= 100 )
+	{
+		MMRadioScanBudget budget = { i, 1 };
+
+		gettimeofday(&begin, NULL);
+		__sim_reset(0);
+		RADIO_EXPECT__( mm_radio_scan_start_budget( radio, &budget ); )
+		RADIO_CHECK__( __sim_wait(&g_sim.scan_results, 1) )
+		events = __sim_events();
+		printf("scan in budget of %d msec : %d stations, %s, %d progress, last %d%% eta %d msec, %lld usec\n", i, events.scan_count,
+			events.scan_result.out_of_budget ? "out of budget" : "whole band", events.progress_count, events.progress.percent,
+			events.progress.remaining, __elapsed_usec(&begin));
+
+		RADIO_CHECK__( events.progress_count > 0 && events.progress_backward == 0 )
+		if ( i )
+		{
+			RADIO_CHECK__( events.scan_result.out_of_budget && events.scan_count < full.scan_count )
+			RADIO_CHECK__( __elapsed_usec(&begin) < ( i + 100 ) * 1000LL )
+		}
+		else
+		{
+			RADIO_CHECK__( ! events.scan_result.out_of_budget && events.scan_count == full.scan_count )
+		}
+	}
+
+	/* scan is stopped in the middle of hardware seek. seeks are aborted by tuning */
+	for ( i = 3; i >= 0; i -= 3 )
+	{
+		long long elapsed = 0;
+
+		RADIO_EXPECT__( mm_radio_set_scan_tuners( radio, scan_tuners, i ); )
+		__sim_reset(0);
+		RADIO_EXPECT__( mm_radio_scan_start(radio); )
+		RADIO_CHECK__( __sim_wait(&g_sim.scan_started, 1) )
+		usleep(20000);
+		gettimeofday(&begin, NULL);
+		RADIO_EXPECT__( mm_radio_scan_stop(radio); )
+		elapsed = __elapsed_usec(&begin);
+		printf("scan stop by %d tuner(s) : %lld usec. raster step %d usec, tuning %d usec\n",
+			i + 1, elapsed, config.seek_step_latency, config.latency);
+		/* raster step in progress, and tuning which aborts the seek */
+		RADIO_CHECK__( elapsed < config.seek_step_latency + config.latency && __sim_events().scan_stopped == 1 )
+	}
+
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+/* signal of every channel. stations are the peaks above seek threshold. and cancelled at the half */
+int __test_sim_sweep(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	MMRadioChannelSignal channels[256];
+	int num_channels = 0;
+	int limit = 0;
+	int peaks = 0;
+	long long elapsed = 0;
+	struct timeval begin;
+
+	__fill_sim_config(&config);
+	config.rolloff = 10000;
+
+	failures += __sim_create(&radio, &config);
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+
+	RADIO_EXPECT__( mm_radio_sweep_band( radio, NULL, 0, &num_channels, NULL, NULL ); )
+	RADIO_CHECK__( num_channels == ( 108000 - 87500 ) / 200 + 1 )
+
+	gettimeofday(&begin, NULL);
+	RADIO_EXPECT__( mm_radio_sweep_band( radio, channels, 256, &num_channels, __sim_sweep_callback, &limit ); )
+	elapsed = __elapsed_usec(&begin);
+
+	for ( i = 1; i < num_channels - 1; i++ )
+	{
+		if ( channels[i].rssi >= config.seek_threshold &&
+			channels[i].rssi >= channels[i - 1].rssi && channels[i].rssi > channels[i + 1].rssi )
+			peaks++;
+	}
+
+	printf("sweep : %d channels, %d peaks, %lld usec, %lld channels/sec\n",
+		num_channels, peaks, elapsed, elapsed ? num_channels * 1000000LL / elapsed : 0);
+	RADIO_CHECK__( peaks == config.num_stations )
+	RADIO_CHECK__( channels[0].frequency == 87500 && channels[num_channels - 1].frequency == 87500 + ( num_channels - 1 ) * 200 )
+
+	limit = num_channels / 2;
+	RADIO_EXPECT__( mm_radio_sweep_band( radio, channels, 256, &num_channels, __sim_sweep_callback, &limit ); )
+	printf("sweep cancelled after %d channels [%d ~ %d KHz]\n", num_channels, channels[0].frequency, channels[num_channels - 1].frequency);
+	RADIO_CHECK__( num_channels == limit )
+
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+/* background refresh finds stations again. by secondary tuner while playing, and by idle tuner */
+int __test_sim_station_refresh(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	sim_events_t events;
+	struct timeval begin;
+
+	__fill_sim_config(&config);
+	config.rolloff = 10000;
+
+	failures += __sim_create(&radio, &config);
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+	unlink(SIM_STATION_DB);
+	RADIO_EXPECT__( mm_radio_set_station_db(radio, SIM_STATION_DB); )
+
+	for ( i = 0; i < 2; i++ )
+	{
+		MMRadioRefreshConfig refresh = {0,};
+
+		refresh.device = ( i == 0 ) ? "/dev/radio1" : NULL;
+		refresh.slice = 50;
+		refresh.interval = 10;
+
+		if ( i == 0 )
+		{
+			RADIO_EXPECT__( mm_radio_start(radio); )
+		}
+
+		RADIO_EXPECT__( mm_radio_invalidate_stations(radio, 0); )
+		__sim_reset(0);
+		gettimeofday(&begin, NULL);
+		RADIO_EXPECT__( mm_radio_start_station_refresh(radio, &refresh); )
+		RADIO_CHECK__( __sim_wait(&g_sim.stations_changed, config.num_stations) )
+		RADIO_EXPECT__( mm_radio_stop_station_refresh(radio); )
+		events = __sim_events();
+		printf("refresh by %s : %d stations, %lld usec\n",
+			( i == 0 ) ? "secondary tuner while playing" : "idle tuner", events.stations_changed, __elapsed_usec(&begin));
+
+		if ( i == 0 )
+		{
+			RADIO_EXPECT__( mm_radio_stop(radio); )
+		}
+	}
+
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+/* asynchronous realize, and the one cancelled by unrealize */
+int __test_sim_realize_async(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	MMRadioStateType state = MM_RADIO_STATE_NULL;
+	sim_events_t events;
+	struct timeval begin;
+
+	__fill_sim_config(&config);
+
+	failures += __sim_create(&radio, &config);
+
+	/* caller gets control back right away */
+	__sim_reset(0);
+	gettimeofday(&begin, NULL);
+	RADIO_EXPECT__( mm_radio_realize_async(radio); )
+	printf("realize_async returns : %lld usec\n", __elapsed_usec(&begin));
+	RADIO_CHECK__( __sim_wait(&g_sim.ready, 1) )
+	printf("realize_async ready : %lld usec\n", __elapsed_usec(&begin));
+	RADIO_EXPECT__( mm_radio_get_state(radio, &state); )
+	RADIO_CHECK__( state == MM_RADIO_STATE_READY && __sim_events().errors == 0 )
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+
+	/* canceled by unrealize */
+	__sim_reset(0);
+	RADIO_EXPECT__( mm_radio_realize_async(radio); )
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_get_state(radio, &state); )
+	events = __sim_events();
+	RADIO_CHECK__( state == MM_RADIO_STATE_NULL && events.errors == 0 )
+
+	/* synchronous one is refused while it's in progress */
+	__sim_reset(0);
+	RADIO_EXPECT__( mm_radio_realize_async(radio); )
+	RADIO_CHECK__( mm_radio_realize(radio) == MM_ERROR_RADIO_INVALID_STATE )
+	RADIO_CHECK__( __sim_wait(&g_sim.ready, 1) )
+	RADIO_EXPECT__( mm_radio_get_state(radio, &state); )
+	RADIO_CHECK__( state == MM_RADIO_STATE_READY && __sim_events().errors == 0 )
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+/* 10k seeks on tuner worker of the handle. time to start a seek, memory and threads after them, and statistics */
+int __test_sim_stress(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	MMRadioStatsEntry stats[32];
+	int num_stats = 0;
+	long long dispatch = 0;
+	long long dispatch_max = 0;
+	long rss = 0;
+	long vm = 0;
+	long threads = 0;
+	int seek_failures = 0;
+	struct timeval begin;
+
+	__fill_sim_config(&config);
+	config.latency = 0;
+	config.seek_step_latency = 0;
+
+	failures += __sim_create(&radio, &config);
+	RADIO_EXPECT__( mm_radio_enable_stats( radio, 1 ); )
+	RADIO_EXPECT__( mm_radio_realize(radio); )
+	RADIO_EXPECT__( mm_radio_start(radio); )
+
+	/* worker is started by the first seek */
+	__sim_reset(0);
+	RADIO_EXPECT__( mm_radio_seek(radio, MM_RADIO_SEEK_UP); )
+	RADIO_CHECK__( __sim_wait(&g_sim.seek_results, 1) )
+
+	rss = __proc_status("VmRSS");
+	vm = __proc_status("VmSize");
+	threads = __proc_status("Threads");
+
+	for ( i = 0; i < 10000; i++ )
+	{
+		sim_events_t events;
+		long long latency = 0;
+
+		__sim_reset(0);
+		gettimeofday(&begin, NULL);
+		if ( mm_radio_seek(radio, i % 2) != MM_ERROR_NONE || ! __sim_wait(&g_sim.seek_results, 1) )
+		{
+			seek_failures++;
+			continue;
+		}
+
+		events = __sim_events();
+		latency = ( events.seek_started_time.tv_sec - begin.tv_sec ) * 1000000LL + ( events.seek_started_time.tv_usec - begin.tv_usec );
+		dispatch += latency;
+		if ( latency > dispatch_max )
+			dispatch_max = latency;
+	}
+
+	printf("10000 seeks : %d failed, dispatch avg %lld usec, max %lld usec\n", seek_failures, dispatch / 10000, dispatch_max);
+	printf("after 10000 seeks : VmRSS %+ld kB, VmSize %+ld kB, threads %+ld\n", __proc_status("VmRSS") - rss,
+		__proc_status("VmSize") - vm, __proc_status("Threads") - threads);
+	RADIO_CHECK__( seek_failures == 0 )
+	RADIO_CHECK__( __proc_status("Threads") == threads && __proc_status("VmSize") - vm < 1024 )
+
+	RADIO_EXPECT__( mm_radio_stop(radio); )
+
+	RADIO_EXPECT__( mm_radio_get_stats( radio, stats, 32, &num_stats, 1 ); )
+	RADIO_CHECK__( num_stats > 0 && num_stats <= 32 )
+	for ( i = 0; i < num_stats && i < 32; i++ )
+	{
+		printf("%-24s : %6u calls, %u errors, avg %llu usec, p50 %u usec, p99 %u usec, max %u usec\n",
+			stats[i].name, stats[i].count, stats[i].errors, stats[i].total_usec / stats[i].count,
+			stats[i].p50_usec, stats[i].p99_usec, stats[i].max_usec);
+		RADIO_CHECK__( stats[i].count > 0 && stats[i].errors <= stats[i].count && stats[i].p50_usec <= stats[i].p99_usec )
+		if ( ! strcmp(stats[i].name, "VIDIOC_S_HW_FREQ_SEEK") )
+		{
+			RADIO_CHECK__( stats[i].count >= 10000 )
+		}
+	}
+
+	/* reset by the last read */
+	RADIO_EXPECT__( mm_radio_get_stats( radio, stats, 32, &num_stats, 0 ); )
+	RADIO_CHECK__( num_stats == 0 )
+
+	RADIO_EXPECT__( mm_radio_unrealize(radio); )
+	RADIO_EXPECT__( mm_radio_destroy(radio); )
+
+	return failures;
+}
+
+int __test_multiple_tuners(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int failures = 0;
+	int i = 0;
+	int num_devices = 0;
+	MMRadioDeviceInfo devices[8];
+	MMHandleType player = 0;
+	MMHandleType scanner = 0;
+	MMRadioSimConfig config = {0,};
+	struct timeval begin;
+
+	RADIO_EXPECT__( mm_radio_get_device_list(devices, 8, &num_devices); )
+	printf("%d radio device(s)\n", num_devices);
+	for ( i = 0; i < num_devices && i < 8; i++ )
+	{
+		printf("%s : %s [%s] %d tuner(s)\n", devices[i].path, devices[i].card, devices[i].driver, devices[i].num_tuners);
+	}
+
+	/* each handle has its own simulated tuner */
+	__fill_sim_config(&config);
+
+	RADIO_EXPECT__( mm_radio_create(&player); )
+	RADIO_EXPECT__( mm_radio_set_message_callback( player, (MMMessageCallback)__sim_msg_callback, (void*)player ); )
+	RADIO_EXPECT__( mm_radio_set_device( player, "/dev/radio0", 0 ); )
+	RADIO_EXPECT__( mm_radio_set_simulation( player, &config ); )
+
+	RADIO_EXPECT__( mm_radio_create(&scanner); )
+	RADIO_EXPECT__( mm_radio_set_message_callback( scanner, (MMMessageCallback)__sim_msg_callback, (void*)scanner ); )
+	RADIO_EXPECT__( mm_radio_set_device( scanner, "/dev/radio1", 0 ); )
+	RADIO_EXPECT__( mm_radio_set_simulation( scanner, &config ); )
+
+	RADIO_EXPECT__( mm_radio_realize(player); )
+	RADIO_EXPECT__( mm_radio_realize(scanner); )
+
+	RADIO_EXPECT__( mm_radio_set_frequency( player, DEFAULT_TEST_FREQ ); )
+	RADIO_EXPECT__( mm_radio_start(player); )
+
+	__sim_reset(0);
+	RADIO_EXPECT__( mm_radio_scan_start(scanner); )
+
+	/* player shouldn't wait for scanner */
+	gettimeofday(&begin, NULL);
+	for ( i = 0; i < 100; i++ )
+	{
+		int freq = 0;
+
+		mm_radio_get_cached_frequency(player, 0, &freq);
+	}
+	printf("100 frequency reads of player while scanning : %lld usec\n", __elapsed_usec(&begin));
+
+	RADIO_CHECK__( __sim_wait(&g_sim.scan_results, 1) )
+	printf("scan : %d stations\n", __sim_events().scan_count);
+
+	RADIO_EXPECT__( mm_radio_stop(player); )
+	RADIO_EXPECT__( mm_radio_unrealize(player); )
+	RADIO_EXPECT__( mm_radio_unrealize(scanner); )
+	RADIO_EXPECT__( mm_radio_destroy(player); )
+	RADIO_EXPECT__( mm_radio_destroy(scanner); )
+
+	return failures;
+}
+
+int __test_repeat_realize_unrealize(void)
+{
+	printf("%s\n", __FUNCTION__);
+
+	int ret = MM_ERROR_NONE;
+	int i = 0;
+	int warm = 0;
+	MMHandleType radio = 0;
+	MMRadioSimConfig config = {0,};
+	struct timeval begin;
+
+	__fill_sim_config(&config);
+
+	RADIO_TEST__( mm_radio_create(&radio); )
+	RADIO_TEST__( mm_radio_set_simulation( radio, &config ); )
+
+	for ( warm = 0; warm < 2; warm++ )
+	{
+		long long realize_usec = 0;
+
+		RADIO_TEST__( mm_radio_set_keep_warm( radio, warm ? 1000 : 0 ); )
+
+		for ( i = 0; i < 20; i++ )
+		{
+			gettimeofday(&begin, NULL);
+			mm_radio_realize(radio);
+			realize_usec += __elapsed_usec(&begin);
+
+			mm_radio_unrealize(radio);
+		}
+
+		printf("keep-warm %s : realize %lld usec in average\n", warm ? "on" : "off", realize_usec / 20);
+	}
+
+	/* kept device is closed by grace timer */
+	sleep(2);
+
+	RADIO_TEST__( mm_radio_destroy(radio); )
+
+	return ret;
+}